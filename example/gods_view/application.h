@@ -1,24 +1,134 @@
 #include "gods_view/vulkan_engine.h"
 #include "gods_view/window.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace pg::example {
 
+namespace details {
+
+// a unit cube around the origin, four vertices per face so each keeps its own normal.
+inline void make_cube(std::vector<gods_view::vertex>& vertices, std::vector<uint32_t>& indices) {
+	// normal, then the face's u and v directions.
+	const float faces[6][3][3] = {
+		{{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+		{{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+		{{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+		{{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+		{{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+		{{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}
+	};
+	const float corners[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+	for (const auto& face : faces) {
+		const auto first = static_cast<uint32_t>(vertices.size());
+		for (const auto& corner : corners) {
+			gods_view::vertex v{};
+			for (size_t axis = 0; axis < 3; ++axis) {
+				v.position[axis] = 0.5f * (face[0][axis] + corner[0] * face[1][axis] + corner[1] * face[2][axis]);
+				v.normal[axis] = face[0][axis];
+			}
+			v.uv[0] = 0.5f * (corner[0] + 1.0f);
+			v.uv[1] = 0.5f * (corner[1] + 1.0f);
+			vertices.push_back(v);
+		}
+		indices.insert(indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+	}
+}
+
+// column major, as mesh.vert takes it: centres the bounds, turns them so three faces show and
+// scales them to most of the view. the scene pass has no depth buffer, z only stays in [0, 1].
+inline void fit_to_view(const float* bounds_min, const float* bounds_max, VkExtent2D extent, float matrix[16]) {
+	float center[3];
+	float radius{0.0f};
+	for (size_t axis = 0; axis < 3; ++axis) {
+		center[axis] = 0.5f * (bounds_min[axis] + bounds_max[axis]);
+		const float half = 0.5f * (bounds_max[axis] - bounds_min[axis]);
+		radius += half * half;
+	}
+	radius = std::sqrt(radius);
+	const float scale = radius > 0.0f ? 0.9f / radius : 1.0f;
+	const float aspect = extent.width != 0 ? static_cast<float>(extent.height) / static_cast<float>(extent.width) : 1.0f;
+	const float cy = std::cos(0.6f);
+	const float sy = std::sin(0.6f);
+	const float cp = std::cos(0.4f);
+	const float sp = std::sin(0.4f);
+	// a pitch after a yaw.
+	const float rotation[3][3] = {
+		{cy, 0.0f, sy},
+		{sp * sy, cp, -sp * cy},
+		{-cp * sy, sp, cp * cy}
+	};
+	// vulkan's clip space y points down.
+	const float row_scale[3] = {scale * aspect, -scale, 0.5f * scale};
+	const float row_offset[3] = {0.0f, 0.0f, 0.5f};
+	for (size_t row = 0; row < 3; ++row) {
+		float translation = row_offset[row];
+		for (size_t column = 0; column < 3; ++column) {
+			matrix[column * 4 + row] = row_scale[row] * rotation[row][column];
+			translation -= matrix[column * 4 + row] * center[column];
+		}
+		matrix[12 + row] = translation;
+	}
+	matrix[3] = 0.0f;
+	matrix[7] = 0.0f;
+	matrix[11] = 0.0f;
+	matrix[15] = 1.0f;
+}
+
+} // end namespace pg::example::details
+
 class application {
 private:
 	gods_view::vulkan_window window_;
+	// additional views driven by the same device, closing the main window ends the run.
+	std::vector<std::unique_ptr<gods_view::vulkan_window>> views_;
 	gods_view::vulkan_engine engine_;
+	// records the run for the trace replayer when set.
+	std::string trace_filename_;
+	// submits and presents from a render thread, this one only pumps events.
+	bool threaded_;
+	// writes a chrome trace of the run's cpu scopes when set.
+	std::string profile_filename_;
+	// tonemaps and grades the scene in a second subpass of the window pass.
+	bool post_processing_;
+	// a packed mesh file drawn in the scene pass, or a cube built at runtime with `cube_`.
+	std::string mesh_filename_;
+	bool cube_;
+	gods_view::mesh_id mesh_;
 
 public:
 	application(
 		const std::string& app_name,
 		uint32_t width,
-		uint32_t height
+		uint32_t height,
+		uint32_t view_count = 1,
+		const std::string& trace_filename = {},
+		bool threaded = false,
+		const std::string& profile_filename = {},
+		bool post_processing = false,
+		const std::string& mesh_filename = {},
+		bool cube = false
 	) :
 		window_{app_name, width, height},
-		engine_{app_name}
-	{ }
+		engine_{app_name},
+		trace_filename_{trace_filename},
+		threaded_{threaded},
+		profile_filename_{profile_filename},
+		post_processing_{post_processing},
+		mesh_filename_{mesh_filename},
+		cube_{cube},
+		mesh_{}
+	{
+		for (uint32_t i = 1; i < view_count; ++i) {
+			views_.push_back(std::make_unique<gods_view::vulkan_window>(app_name + " " + std::to_string(i), width, height));
+		}
+	}
 
 	void run() {
 		window_.initiate_window();
@@ -27,17 +137,84 @@ public:
 		engine_.initialize_device_manager();
 		engine_.create_swap_chain();
 		engine_.create_image_views();
+		if (post_processing_) {
+			engine_.initialize_post_processor();
+		}
 		engine_.create_render_pass();
 		engine_.create_graphics_pipeline();
 		engine_.create_framebuffers();
 		engine_.create_command_pool();
 		engine_.create_command_buffer();
+		engine_.create_compute_queue();
 		engine_.create_synchronization_objects();
-		while (!window_.should_window_close()) {
-			glfwPollEvents();
-			engine_.draw_manager()->draw_frame();
+		for (auto& view : views_) {
+			view->initiate_window();
+			engine_.add_window(view->handle());
+		}
+		engine_.initialize_job_system();
+		engine_.initialize_descriptor_allocator();
+		engine_.initialize_texture_manager();
+		engine_.initialize_mesh_manager();
+		if (!mesh_filename_.empty()) {
+			mesh_ = engine_.mesh_manager()->load_mesh(mesh_filename_);
+		} else if (cube_) {
+			std::vector<gods_view::vertex> vertices;
+			std::vector<uint32_t> indices;
+			details::make_cube(vertices, indices);
+			mesh_ = engine_.mesh_manager()->create_mesh(vertices, indices);
+		}
+		if (mesh_) {
+			// mesh.vert only decodes packed vertices.
+			if (engine_.mesh_manager()->format(mesh_) != gods_view::vertex_format::packed) {
+				throw std::runtime_error{"Only packed meshes can be drawn"};
+			}
+			engine_.command_manager()->set_scene_commands([this](VkCommandBuffer command_buffer, VkExtent2D extent) {
+				draw_mesh(command_buffer, extent);
+			});
+		}
+		engine_.initialize_transform_manager();
+		engine_.initialize_capture_manager();
+		engine_.initialize_overlay_renderer();
+		engine_.initialize_point_cloud_renderer();
+		engine_.initialize_resolution_scaler();
+		if (!trace_filename_.empty()) {
+			engine_.trace_recorder()->start(trace_filename_);
+		}
+		if (!profile_filename_.empty()) {
+			engine_.profiler()->start();
 		}
-		vkDeviceWaitIdle(engine_.device_manager()->logical_device());
+		if (threaded_) {
+			engine_.start_render_thread();
+		}
+		engine_.render_loop()->run([this]() { return window_.should_window_close(); });
+		engine_.stop_render_thread();
+		if (!profile_filename_.empty()) {
+			engine_.profiler()->stop();
+			engine_.profiler()->export_chrome_trace(profile_filename_);
+		}
+		engine_.trace_recorder()->stop();
+		engine_.device_manager()->dispatch().device_wait_idle(engine_.device_manager()->logical_device());
+	}
+
+private:
+	void draw_mesh(VkCommandBuffer command_buffer, VkExtent2D extent) {
+		auto meshes = engine_.mesh_manager();
+		if (!meshes->resident(mesh_)) { return; }
+		auto pipelines = engine_.graphics_pipeline_manager();
+		gods_view::pipeline_state state{};
+		state.cull_mode = VK_CULL_MODE_NONE;
+		pipelines->bind_mesh(command_buffer, state);
+		float model_view_projection[16];
+		details::fit_to_view(meshes->bounds_min(mesh_), meshes->bounds_max(mesh_), extent, model_view_projection);
+		engine_.device_manager()->dispatch().cmd_push_constants(
+			command_buffer,
+			pipelines->mesh_pipeline_layout(),
+			VK_SHADER_STAGE_VERTEX_BIT,
+			0,
+			sizeof(model_view_projection),
+			model_view_projection
+		);
+		meshes->draw(command_buffer, mesh_);
 	}
 };
 
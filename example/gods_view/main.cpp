@@ -2,13 +2,40 @@
 
 #include <chrono>
 #include <iostream>
+#include <string>
 #include <thread>
 
 using namespace pg;
 
-int main(void) {
+int main(int argc, char** argv) {
 	try {
-		example::application app{"gods_view", 1280, 720};
+		// `--record <file>` captures the run for the trace replayer, `--threaded` draws from a render
+		// thread, `--profile <file>` writes a chrome trace of where frame time went, `--post`
+		// tonemaps and grades the scene, `--mesh <file>` draws a packed mesh file and `--cube` a
+		// cube packed at runtime.
+		std::string trace_filename;
+		std::string profile_filename;
+		bool threaded = false;
+		bool post_processing = false;
+		std::string mesh_filename;
+		bool cube = false;
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg{argv[i]};
+			if (arg == "--record" && i + 1 < argc) {
+				trace_filename = argv[++i];
+			} else if (arg == "--profile" && i + 1 < argc) {
+				profile_filename = argv[++i];
+			} else if (arg == "--threaded") {
+				threaded = true;
+			} else if (arg == "--post") {
+				post_processing = true;
+			} else if (arg == "--mesh" && i + 1 < argc) {
+				mesh_filename = argv[++i];
+			} else if (arg == "--cube") {
+				cube = true;
+			}
+		}
+		example::application app{"gods_view", 1280, 720, 1, trace_filename, threaded, profile_filename, post_processing, mesh_filename, cube};
 		app.run();
 
 		uint32_t extension_count{0};
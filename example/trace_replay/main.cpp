@@ -0,0 +1,55 @@
+#include "replayer.h"
+
+#include "gods_view/allocation_hook.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace pg;
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " <trace> [--loops <count>] [--realtime] [--hidden] [--check-allocations]" << std::endl;
+		return 1;
+	}
+	example::replay_options options{};
+	for (int i = 2; i < argc; ++i) {
+		const std::string argument{argv[i]};
+		if (argument == "--loops" && i + 1 < argc) {
+			options.loops = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		} else if (argument == "--realtime") {
+			options.realtime = true;
+		} else if (argument == "--hidden") {
+			options.hidden = true;
+		} else if (argument == "--check-allocations") {
+			options.check_allocations = true;
+		} else {
+			std::cerr << "Unknown argument: " << argument << std::endl;
+			return 1;
+		}
+	}
+
+	try {
+		example::replayer replay{argv[1], options};
+		const auto result = replay.run();
+		std::cout << "Frames: " << result.frames << " in " << result.seconds << " s";
+		if (result.seconds > 0.0) {
+			std::cout << " (" << static_cast<double>(result.frames) / result.seconds << " fps, "
+				<< result.seconds * 1000.0 / static_cast<double>(result.frames == 0 ? 1 : result.frames) << " ms per frame)";
+		}
+		std::cout << std::endl;
+		if (result.frames != 0) {
+			const auto per_frame = [&result](uint64_t count) { return static_cast<double>(count) / static_cast<double>(result.frames); };
+			std::cout << "Per frame: " << per_frame(result.counts.allocations) << " allocations ("
+				<< per_frame(result.counts.allocated_bytes) << " bytes), " << per_frame(result.counts.vulkan_calls) << " vulkan calls, "
+				<< per_frame(result.counts.barriers) << " barriers, " << per_frame(result.counts.binds) << " binds, "
+				<< per_frame(result.counts.draws) << " draws, " << per_frame(result.counts.dispatches) << " dispatches, "
+				<< per_frame(result.counts.submits) << " submits" << std::endl;
+		}
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,116 @@
+#if !defined PG_GODS_VIEW_REPLAYER_HEADER_INCLUDED
+#define PG_GODS_VIEW_REPLAYER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/trace_player.h"
+#include "gods_view/vulkan_engine.h"
+#include "gods_view/window.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pg::example {
+
+struct replay_options {
+	// passes over the trace, resources are created on the first one only.
+	uint32_t loops{1};
+	// waits out each frame's recorded duration instead of drawing as fast as possible.
+	bool realtime{false};
+	// keeps the windows hidden; the frame stream still runs but nothing is drawn or presented.
+	bool hidden{false};
+	// fails the replay once a frame allocates after the warmup, see `frame_counters::zero_allocation_check`.
+	bool check_allocations{false};
+};
+
+struct replay_result {
+	uint64_t frames;
+	double seconds;
+	// summed over the frames drawn.
+	gods_view::frame_counts counts;
+};
+
+// drives a fresh engine from a recorded trace, with the windows the recording had.
+class replayer {
+private:
+	std::vector<std::unique_ptr<gods_view::vulkan_window>> windows_;
+	gods_view::vulkan_engine engine_;
+	gods_view::trace_player player_;
+	replay_options options_;
+
+public:
+	replayer(const std::string& trace_filename, const replay_options& options) :
+		engine_{"gods_view replay"},
+		player_{&engine_, trace_filename},
+		options_{options}
+	{
+		const auto& surfaces = player_.surfaces();
+		if (surfaces.empty()) {
+			throw std::runtime_error{"Trace has no windows"};
+		}
+		for (size_t i = 0; i < surfaces.size(); ++i) {
+			windows_.push_back(std::make_unique<gods_view::vulkan_window>("gods_view replay " + std::to_string(i), surfaces[i].width, surfaces[i].height, !options_.hidden));
+		}
+	}
+
+	[[nodiscard]] const gods_view::trace_player& player() const noexcept { return player_; }
+
+	replay_result run() {
+		auto& main_window = *windows_.front();
+		main_window.initiate_window();
+		engine_.current_window(main_window.handle());
+		engine_.create_vulkan_surface(main_window.handle());
+		engine_.initialize_device_manager();
+		engine_.create_swap_chain();
+		engine_.create_image_views();
+		engine_.create_render_pass();
+		engine_.create_graphics_pipeline();
+		engine_.create_framebuffers();
+		engine_.create_command_pool();
+		engine_.create_command_buffer();
+		engine_.create_compute_queue();
+		engine_.create_synchronization_objects();
+		for (size_t i = 1; i < windows_.size(); ++i) {
+			windows_[i]->initiate_window();
+			engine_.add_window(windows_[i]->handle());
+		}
+		engine_.initialize_job_system();
+		engine_.initialize_descriptor_allocator();
+		engine_.initialize_texture_manager();
+		engine_.initialize_mesh_manager();
+		engine_.initialize_transform_manager();
+		engine_.initialize_capture_manager();
+		engine_.initialize_overlay_renderer();
+		engine_.initialize_point_cloud_renderer();
+		engine_.initialize_resolution_scaler();
+		engine_.frame_counters()->zero_allocation_check(options_.check_allocations);
+
+		replay_result result{};
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t loop = 0; loop < options_.loops && !main_window.should_window_close(); ++loop) {
+			player_.rewind();
+			double delta{0.0};
+			auto frame_start = std::chrono::steady_clock::now();
+			while (player_.next_frame(&delta) && !main_window.should_window_close()) {
+				if (options_.realtime) {
+					std::this_thread::sleep_until(frame_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(delta)));
+					frame_start = std::chrono::steady_clock::now();
+				}
+				glfwPollEvents();
+				engine_.draw_manager()->draw_frame();
+				++result.frames;
+			}
+		}
+		engine_.device_manager()->dispatch().device_wait_idle(engine_.device_manager()->logical_device());
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.counts = engine_.frame_counters()->total();
+		return result;
+	}
+};
+
+} // end namespace pg::example
+
+#endif
@@ -0,0 +1,154 @@
+#if !defined PG_GODS_VIEW_ALLOCATION_HOOK_HEADER_INCLUDED
+#define PG_GODS_VIEW_ALLOCATION_HOOK_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/frame_counters.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined _WIN32
+#include <malloc.h>
+#endif
+
+// replaces the global allocation functions with ones that count every allocation into
+// `frame_counters` before going to malloc. it defines the replacements, so include it in
+// exactly one source file of the program, usually the one with main.
+
+namespace pg::gods_view::details {
+
+static void* counted_allocate(std::size_t size, std::size_t alignment) {
+	count_allocation(size);
+	if (size == 0) { size = 1; }
+	for (;;) {
+		void* memory;
+		if (alignment <= alignof(std::max_align_t)) {
+			memory = std::malloc(size);
+		} else {
+#if defined _WIN32
+			memory = _aligned_malloc(size, alignment);
+#else
+			// aligned_alloc wants a multiple of the alignment.
+			memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		}
+		if (memory != nullptr) { return memory; }
+		auto handler = std::get_new_handler();
+		if (handler == nullptr) { throw std::bad_alloc{}; }
+		handler();
+	}
+}
+
+static void counted_free(void* memory, std::size_t alignment) noexcept {
+#if defined _WIN32
+	if (alignment > alignof(std::max_align_t)) {
+		_aligned_free(memory);
+		return;
+	}
+#endif
+	(void)alignment;
+	std::free(memory);
+}
+
+[[maybe_unused]] static const bool allocation_hook_registered = (allocation_hook_installed.store(true), true);
+
+} // end namespace pg::gods_view::details
+
+void* operator new(std::size_t size) {
+	return pg::gods_view::details::counted_allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+	return pg::gods_view::details::counted_allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	return pg::gods_view::details::counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return pg::gods_view::details::counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return pg::gods_view::details::counted_allocate(size, alignof(std::max_align_t));
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	try {
+		return pg::gods_view::details::counted_allocate(size, alignof(std::max_align_t));
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return pg::gods_view::details::counted_allocate(size, static_cast<std::size_t>(alignment));
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	try {
+		return pg::gods_view::details::counted_allocate(size, static_cast<std::size_t>(alignment));
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+void operator delete(void* memory) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+	pg::gods_view::details::counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	pg::gods_view::details::counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+#endif
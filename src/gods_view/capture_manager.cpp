@@ -0,0 +1,250 @@
+#include "gods_view/capture_manager.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+
+namespace pg::gods_view {
+
+capture_manager::capture_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	slot_count_{0},
+	memory_flags_{0},
+	deliveries_{0},
+	captured_frames_{0},
+	dropped_frames_{0}
+{ }
+
+capture_manager::~capture_manager() {
+	if (slot_count_ == 0) { return; }
+	try {
+		engine_->job_system()->wait_background(deliveries_);
+	} catch (...) {
+		// a consumer threw, nothing is left to report it to while tearing down.
+	}
+	for (uint32_t i = 0; i < slot_count_; ++i) {
+		if (slots_[i].buffer.buffer != VK_NULL_HANDLE) {
+			details::destroy_buffer(engine_->device_manager()->dispatch(), slots_[i].buffer);
+		}
+	}
+}
+
+void capture_manager::initialize(uint32_t ring_size) {
+	if (ring_size == 0) {
+		throw std::runtime_error{"Capture ring needs at least one buffer"};
+	}
+	slots_ = std::make_unique<ring_slot[]>(ring_size);
+	slot_count_ = ring_size;
+	for (uint32_t i = 0; i < slot_count_; ++i) {
+		slots_[i].state.store(slot_state::free, std::memory_order_relaxed);
+	}
+	// cached memory makes the consumer's reads fast, it needs an invalidate before them. the
+	// allowed memory types only depend on the usage, so a small buffer stands in for the
+	// readback buffers created later.
+	const auto& vk = engine_->device_manager()->dispatch();
+	VkBufferCreateInfo probe_info{};
+	probe_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	probe_info.size = 4;
+	probe_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	probe_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	VkBuffer probe;
+	if (vk.create_buffer(vk.device, &probe_info, nullptr, &probe) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create buffer"};
+	}
+	VkMemoryRequirements requirements;
+	vk.get_buffer_memory_requirements(vk.device, probe, &requirements);
+	vk.destroy_buffer(vk.device, probe, nullptr);
+	memory_flags_ = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+	if (!details::find_memory_type(engine_->device_manager()->memory_properties(), requirements.memoryTypeBits, memory_flags_).has_value()) {
+		memory_flags_ = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	}
+}
+
+bool capture_manager::busy() const {
+	for (const auto& request : requests_) {
+		if (!request.continuous) { return true; }
+	}
+	for (uint32_t i = 0; i < slot_count_; ++i) {
+		if (slots_[i].state.load(std::memory_order_relaxed) == slot_state::recorded) { return true; }
+	}
+	return false;
+}
+
+void capture_manager::capture_once(size_t surface_index, capture_consumer consumer) {
+	if (surface_index >= engine_->surface_manager()->surface_count() || !engine_->surface_manager()->capturable(surface_index)) {
+		throw std::runtime_error{"Surface can't be captured"};
+	}
+	requests_.push_back({surface_index, std::make_shared<capture_consumer>(std::move(consumer)), false});
+}
+
+void capture_manager::start_capture(size_t surface_index, capture_consumer consumer) {
+	if (surface_index >= engine_->surface_manager()->surface_count() || !engine_->surface_manager()->capturable(surface_index)) {
+		throw std::runtime_error{"Surface can't be captured"};
+	}
+	stop_capture(surface_index);
+	requests_.push_back({surface_index, std::make_shared<capture_consumer>(std::move(consumer)), true});
+}
+
+void capture_manager::stop_capture(size_t surface_index) {
+	// copies already in flight are still delivered.
+	requests_.erase(
+		std::remove_if(requests_.begin(), requests_.end(), [surface_index](const capture_request& request) {
+			return request.continuous && request.surface_index == surface_index;
+		}),
+		requests_.end()
+	);
+}
+
+void capture_manager::record(VkCommandBuffer command_buffer, const frame_target& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (requests_.empty()) { return; }
+	auto surface_manager = engine_->surface_manager();
+	const auto extent = surface_manager->swap_chain_extent(target.surface_index);
+	const VkImage image = surface_manager->swap_chain_images(target.surface_index)[target.image_index];
+	bool copied{false};
+	for (auto it = requests_.begin(); it != requests_.end();) {
+		if (it->surface_index != target.surface_index) {
+			++it;
+			continue;
+		}
+		auto slot = acquire_slot(static_cast<VkDeviceSize>(extent.width) * extent.height * details::capture_texel_size);
+		if (slot == nullptr) {
+			++dropped_frames_;
+			++it;
+			continue;
+		}
+
+		if (!copied) {
+			details::transition_image_layout(
+				vk,
+				command_buffer,
+				image,
+				VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+				VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+				VK_ACCESS_TRANSFER_READ_BIT,
+				VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT
+			);
+			copied = true;
+		}
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = {0, 0, 0};
+		region.imageExtent = {extent.width, extent.height, 1};
+		vk.cmd_copy_image_to_buffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer.buffer, 1, &region);
+
+		slot->surface_index = target.surface_index;
+		slot->frame = engine_->draw_manager()->submitted_frames() + 1;
+		slot->extent = extent;
+		slot->format = surface_manager->swap_chain_image_format();
+		slot->consumer = it->consumer;
+		slot->owner = it->consumer.get();
+		slot->state.store(slot_state::recorded, std::memory_order_relaxed);
+
+		if (it->continuous) {
+			++it;
+		} else {
+			it = requests_.erase(it);
+		}
+	}
+	if (!copied) { return; }
+
+	details::transition_image_layout(
+		vk,
+		command_buffer,
+		image,
+		VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+		VK_ACCESS_TRANSFER_READ_BIT,
+		0,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+	);
+	VkMemoryBarrier host_barrier{};
+	host_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	host_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	host_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	vk.cmd_pipeline_barrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &host_barrier, 0, nullptr, 0, nullptr);
+}
+
+void capture_manager::update() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const uint64_t completed = engine_->draw_manager()->completed_frames();
+	for (uint32_t i = 0; i < slot_count_; ++i) {
+		auto& slot = slots_[i];
+		if (slot.state.load(std::memory_order_relaxed) != slot_state::recorded || slot.frame > completed) { continue; }
+		// the consumer's earlier frames go first, one at a time; this one waits for a later update.
+		bool blocked{false};
+		for (uint32_t j = 0; j < slot_count_ && !blocked; ++j) {
+			const auto& other = slots_[j];
+			if (j == i || other.owner != slot.owner) { continue; }
+			const auto state = other.state.load(std::memory_order_acquire);
+			blocked = state == slot_state::delivering || (state == slot_state::recorded && other.frame < slot.frame);
+		}
+		if (blocked) { continue; }
+
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = slot.buffer.memory;
+		range.offset = 0;
+		range.size = VK_WHOLE_SIZE;
+		vk.invalidate_mapped_memory_ranges(engine_->device_manager()->logical_device(), 1, &range);
+
+		++captured_frames_;
+		slot.state.store(slot_state::delivering, std::memory_order_relaxed);
+		// consumers may encode or write files, the frame never waits on them.
+		engine_->job_system()->submit_background(deliveries_, [&slot]() {
+			const captured_frame frame{
+				slot.surface_index,
+				slot.frame,
+				slot.extent,
+				slot.format,
+				slot.extent.width * details::capture_texel_size,
+				static_cast<const std::byte*>(slot.buffer.mapped)
+			};
+			const auto release = [&slot]() {
+				slot.consumer.reset();
+				// pairs with the acquire in `acquire_slot`, the render thread may reuse it now.
+				slot.state.store(slot_state::free, std::memory_order_release);
+			};
+			try {
+				(*slot.consumer)(frame);
+			} catch (...) {
+				// the slot goes back either way, the job system hands the error to `wait_background`.
+				release();
+				throw;
+			}
+			release();
+		});
+	}
+}
+
+capture_manager::ring_slot* capture_manager::acquire_slot(VkDeviceSize size) {
+	for (uint32_t i = 0; i < slot_count_; ++i) {
+		auto& slot = slots_[i];
+		if (slot.state.load(std::memory_order_acquire) != slot_state::free) { continue; }
+		if (slot.buffer.size < size) {
+			const auto& vk = engine_->device_manager()->dispatch();
+			if (slot.buffer.buffer != VK_NULL_HANDLE) {
+				details::destroy_buffer(vk, slot.buffer);
+			}
+			slot.buffer = details::create_buffer(
+				vk,
+				engine_->device_manager()->memory_properties(),
+				size,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				memory_flags_
+			);
+		}
+		return &slot;
+	}
+	return nullptr;
+}
+
+} // end namespace pg::gods_view
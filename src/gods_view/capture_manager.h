@@ -0,0 +1,125 @@
+#if !defined PG_GODS_VIEW_CAPTURE_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_CAPTURE_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/job_system.h"
+#include "gods_view/memory.h"
+#include "gods_view/surface_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace pg::gods_view {
+
+// a frame read back from a swap chain, `pixels` is only valid during the consumer call.
+struct captured_frame {
+	size_t surface_index;
+	// draw manager frame the pixels come from.
+	uint64_t frame;
+	VkExtent2D extent;
+	VkFormat format;
+	uint32_t row_pitch;
+	const std::byte* pixels;
+};
+
+using capture_consumer = std::function<void(const captured_frame&)>;
+
+struct capture_stats {
+	uint64_t captured_frames;
+	// frames skipped because every readback buffer was still busy.
+	uint64_t dropped_frames;
+};
+
+namespace details {
+
+constexpr uint32_t default_capture_ring_size = 3;
+// swap chain formats picked by the surface manager are all 32 bits per texel.
+constexpr uint32_t capture_texel_size = 4;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// copies presented images into a ring of host visible buffers from inside the frame's own
+// command buffer. a copy is ready once the draw manager has seen that frame's fence, the
+// consumer then runs as a background job, so neither the gpu nor the render loop ever waits on
+// a readback; with every buffer busy the frame is dropped rather than waited for. a consumer
+// gets one frame at a time, in frame order.
+class capture_manager {
+private:
+	enum class slot_state : uint8_t {
+		free,
+		recorded,
+		delivering
+	};
+
+	struct ring_slot {
+		gpu_buffer buffer;
+		std::atomic<slot_state> state;
+		size_t surface_index;
+		uint64_t frame;
+		VkExtent2D extent;
+		VkFormat format;
+		std::shared_ptr<capture_consumer> consumer;
+		// `consumer` as set by `record`, compared only. the delivery job resets `consumer`.
+		const capture_consumer* owner;
+	};
+
+	struct capture_request {
+		size_t surface_index;
+		std::shared_ptr<capture_consumer> consumer;
+		bool continuous;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::unique_ptr<ring_slot[]> slots_;
+	uint32_t slot_count_;
+	VkMemoryPropertyFlags memory_flags_;
+	std::vector<capture_request> requests_;
+	job_counter deliveries_;
+	uint64_t captured_frames_;
+	uint64_t dropped_frames_;
+
+public:
+	capture_manager(gods_view::vulkan_engine* init_engine);
+
+	~capture_manager();
+
+	capture_manager(const capture_manager&) = delete;
+
+	capture_manager& operator=(const capture_manager&) = delete;
+
+	void initialize(uint32_t ring_size = details::default_capture_ring_size);
+
+	[[nodiscard]] capture_stats stats() const noexcept { return {captured_frames_, dropped_frames_}; }
+
+	// a one shot capture is waiting for a frame or a copy still has to be handed over.
+	[[nodiscard]] bool busy() const;
+
+	// the next frame drawn to the surface goes to `consumer`, called from a job thread.
+	void capture_once(size_t surface_index, capture_consumer consumer);
+
+	// every frame drawn to the surface goes to `consumer` until `stop_capture`.
+	void start_capture(size_t surface_index, capture_consumer consumer);
+
+	void stop_capture(size_t surface_index);
+
+	// called by the command manager after a target's render pass, the image is in present layout.
+	void record(VkCommandBuffer command_buffer, const frame_target& target);
+
+	// hands finished copies to their consumers, call after the frame fence has been waited on.
+	void update();
+
+private:
+	ring_slot* acquire_slot(VkDeviceSize size);
+};
+
+} // end namespace pg::gods_view
+
+#endif
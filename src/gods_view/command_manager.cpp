@@ -1,6 +1,8 @@
 #include "gods_view/command_manager.h"
 #include "gods_view/vulkan_engine.h"
 
+#include <utility>
+
 namespace pg::gods_view {
 
 command_manager::command_manager(gods_view::vulkan_engine* init_engine) :
@@ -8,10 +10,12 @@ command_manager::command_manager(gods_view::vulkan_engine* init_engine) :
 { }	
 
 command_manager::~command_manager() {
-	vkDestroyCommandPool(engine_->device_manager()->logical_device(), command_pool_, nullptr);
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.destroy_command_pool(engine_->device_manager()->logical_device(), command_pool_, nullptr);
 }
 
 void command_manager::create_command_pool() {
+	const auto& vk = engine_->device_manager()->dispatch();
 	queue_family_indices indices = details::find_queue_families(
 		engine_->device_manager()->physical_device(), 
 		engine_->surface_manager()->surface()
@@ -20,61 +24,123 @@ void command_manager::create_command_pool() {
 	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 	pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 	pool_info.queueFamilyIndex = indices.graphics_family.value();
-	if (vkCreateCommandPool(engine_->device_manager()->logical_device(), &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
+	if (vk.create_command_pool(engine_->device_manager()->logical_device(), &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create command pool"};
 	}
 }
 
 void command_manager::create_command_buffer() {
+	const auto& vk = engine_->device_manager()->dispatch();
 	VkCommandBufferAllocateInfo allocate_info{};
 	allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 	allocate_info.commandPool = command_pool_;
 	allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 	allocate_info.commandBufferCount = 1;
-	if (vkAllocateCommandBuffers(engine_->device_manager()->logical_device(), &allocate_info, &command_buffer_) != VK_SUCCESS) {
+	if (vk.allocate_command_buffers(engine_->device_manager()->logical_device(), &allocate_info, &command_buffer_) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to allocate command buffers"};
 	}
 }
 
-void command_manager::record_command_buffer(VkCommandBuffer command_buffer, uint32_t image_index) {
+void command_manager::record_inline(std::function<void(VkCommandBuffer)> commands) {
+	inline_commands_.push_back(std::move(commands));
+}
+
+void command_manager::set_scene_commands(std::function<void(VkCommandBuffer, VkExtent2D)> commands) {
+	scene_commands_ = std::move(commands);
+}
+
+void command_manager::record_command_buffer(VkCommandBuffer command_buffer, const std::vector<frame_target>& targets) {
+	const auto& vk = engine_->device_manager()->dispatch();
 	VkCommandBufferBeginInfo begin_info{};
 	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+	if (vk.begin_command_buffer(command_buffer, &begin_info) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to begin recording command buffer"};
 	}
-	
-	VkRenderPassBeginInfo renderpass_info{};
-	renderpass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderpass_info.renderPass = engine_->graphics_pipeline_manager()->render_pass();
-	renderpass_info.framebuffer = engine_->draw_manager()->swap_chain_framebuffers()[image_index];
-	renderpass_info.renderArea.offset = {0, 0};
-	renderpass_info.renderArea.extent = engine_->surface_manager()->swap_chain_extent();
-
-	VkClearValue clear_color = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-	renderpass_info.clearValueCount = 1;
-	renderpass_info.pClearValues = &clear_color;
-
-	vkCmdBeginRenderPass(command_buffer_, &renderpass_info, VK_SUBPASS_CONTENTS_INLINE);
-	vkCmdBindPipeline(command_buffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, engine_->graphics_pipeline_manager()->graphics_pipeline());
-	
+
+	if (!inline_commands_.empty()) {
+		for (auto& commands : inline_commands_) {
+			commands(command_buffer);
+		}
+		inline_commands_.clear();
+		details::compute_to_graphics_barrier(vk, command_buffer);
+	}
+
+	auto resolution_scaler = engine_->resolution_scaler();
+	auto post_processor = engine_->post_processor();
+	resolution_scaler->begin_frame(command_buffer);
+	for (const auto& target : targets) {
+		const auto extent = engine_->surface_manager()->swap_chain_extent(target.surface_index);
+		if (resolution_scaler->enabled()) {
+			const auto render_extent = resolution_scaler->begin_scene(command_buffer, target.surface_index);
+			record_scene(command_buffer, render_extent);
+			if (post_processor->enabled()) {
+				vk.cmd_next_subpass(command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+				post_processor->resolve(command_buffer, resolution_scaler->scene_view(target.surface_index), render_extent);
+			}
+			vk.cmd_end_render_pass(command_buffer);
+		}
+
+		VkRenderPassBeginInfo renderpass_info{};
+		renderpass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		// the scaler's pass already tonemapped the scene, the window's scene subpass stays empty.
+		renderpass_info.renderPass = post_processor->enabled() && resolution_scaler->enabled()
+			? post_processor->passthrough_render_pass()
+			: engine_->graphics_pipeline_manager()->render_pass();
+		renderpass_info.framebuffer = engine_->draw_manager()->swap_chain_framebuffers(target.surface_index)[target.image_index];
+		renderpass_info.renderArea.offset = {0, 0};
+		renderpass_info.renderArea.extent = extent;
+
+		// the second is the hdr attachment's, when there is one.
+		VkClearValue clear_colors[2] = {{{{0.0f, 0.0f, 0.0f, 1.0f}}}, {{{0.0f, 0.0f, 0.0f, 1.0f}}}};
+		renderpass_info.clearValueCount = post_processor->enabled() ? 2 : 1;
+		renderpass_info.pClearValues = clear_colors;
+
+		vk.cmd_begin_render_pass(command_buffer, &renderpass_info, VK_SUBPASS_CONTENTS_INLINE);
+		if (post_processor->enabled()) {
+			if (!resolution_scaler->enabled()) {
+				record_scene(command_buffer, extent);
+			}
+			vk.cmd_next_subpass(command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+		}
+		if (resolution_scaler->enabled()) {
+			resolution_scaler->upscale(command_buffer, target);
+		} else if (post_processor->enabled()) {
+			post_processor->resolve(command_buffer, post_processor->scene_view(target.surface_index), extent);
+		} else {
+			record_scene(command_buffer, extent);
+		}
+		engine_->overlay_renderer()->record(command_buffer, target);
+		vk.cmd_end_render_pass(command_buffer);
+		engine_->capture_manager()->record(command_buffer, target);
+	}
+	resolution_scaler->end_frame(command_buffer);
+
+	if (vk.end_command_buffer(command_buffer) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to record command buffer"};
+	}
+}
+
+void command_manager::record_scene(VkCommandBuffer command_buffer, VkExtent2D extent) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	engine_->graphics_pipeline_manager()->bind(command_buffer, pipeline_state{});
+
 	VkViewport viewport{};
 	viewport.x = 0.0f;
 	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(engine_->surface_manager()->swap_chain_extent().width);
-	viewport.height = static_cast<float>(engine_->surface_manager()->swap_chain_extent().height);
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(command_buffer_, 0, 1, &viewport);
-	
+	vk.cmd_set_viewport(command_buffer, 0, 1, &viewport);
+
 	VkRect2D scissor{};
 	scissor.offset = {0, 0};
-	scissor.extent = engine_->surface_manager()->swap_chain_extent();
-	vkCmdSetScissor(command_buffer_, 0, 1, &scissor);
-	vkCmdDraw(command_buffer_, 3, 1, 0, 0);
-	vkCmdEndRenderPass(command_buffer_);
-	
-	if (vkEndCommandBuffer(command_buffer_) != VK_SUCCESS) {
-		throw std::runtime_error{"Failed to record command buffer"};
+	scissor.extent = extent;
+	vk.cmd_set_scissor(command_buffer, 0, 1, &scissor);
+	vk.cmd_draw(command_buffer, 3, 1, 0, 0);
+	engine_->point_cloud_renderer()->record(command_buffer, extent);
+	if (scene_commands_) {
+		scene_commands_(command_buffer, extent);
 	}
 }
 
@@ -2,9 +2,13 @@
 #define PG_GODS_VIEW_COMMAND_MANAGER_HEADER_INCLUDED
 #pragma once
 
+#include "gods_view/surface_manager.h"
+
 #include <vulkan/vulkan.h>
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 namespace pg::gods_view {
 
@@ -15,6 +19,8 @@ private:
 	gods_view::vulkan_engine* engine_;
 	VkCommandPool command_pool_;
 	VkCommandBuffer command_buffer_;
+	std::vector<std::function<void(VkCommandBuffer)>> inline_commands_;
+	std::function<void(VkCommandBuffer, VkExtent2D)> scene_commands_;
 
 public:
 	command_manager(gods_view::vulkan_engine* init_engine);
@@ -29,7 +35,22 @@ public:
 	
 	void create_command_buffer();
 	
-	void record_command_buffer(VkCommandBuffer command_buffer, uint32_t image_index);
+	// `commands` are recorded once into the next frame's command buffer ahead of its render
+	// passes, e.g. inline dispatches; what they write is visible to the draws after them.
+	void record_inline(std::function<void(VkCommandBuffer)> commands);
+
+	// `commands` are recorded into every scene pass after the engine's own draws, with the
+	// viewport and scissor set for `extent`, e.g. meshes through `mesh_manager::draw`. they
+	// run on the thread that records frames, set them before the render thread starts.
+	void set_scene_commands(std::function<void(VkCommandBuffer, VkExtent2D)> commands);
+
+	// one render pass per acquired window, all recorded into `command_buffer`. with the
+	// resolution scaler on, each is preceded by the window's scaled scene pass.
+	void record_command_buffer(VkCommandBuffer command_buffer, const std::vector<frame_target>& targets);
+
+private:
+	// the scene's draws, at `extent` inside whichever pass is open.
+	void record_scene(VkCommandBuffer command_buffer, VkExtent2D extent);
 };
 
 } // end namespace pg::gods_view
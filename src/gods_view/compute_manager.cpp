@@ -0,0 +1,153 @@
+#include "gods_view/compute_manager.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+
+namespace pg::gods_view {
+
+compute_manager::compute_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	command_pool_{VK_NULL_HANDLE},
+	current_batch_{0},
+	recording_{false},
+	timeline_{VK_NULL_HANDLE},
+	submitted_value_{0},
+	graphics_wait_{0}
+{ }
+
+compute_manager::~compute_manager() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (timeline_ == VK_NULL_HANDLE) { return; }
+	auto device = engine_->device_manager()->logical_device();
+	wait(submitted_value_);
+	vk.destroy_semaphore(device, timeline_, nullptr);
+	vk.destroy_command_pool(device, command_pool_, nullptr);
+}
+
+void compute_manager::initialize() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	VkCommandPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	pool_info.queueFamilyIndex = engine_->device_manager()->queue_families().compute_family.value();
+	if (vk.create_command_pool(device, &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create compute command pool"};
+	}
+
+	VkCommandBuffer command_buffers[details::compute_batch_count];
+	VkCommandBufferAllocateInfo allocate_info{};
+	allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocate_info.commandPool = command_pool_;
+	allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocate_info.commandBufferCount = static_cast<uint32_t>(details::compute_batch_count);
+	if (vk.allocate_command_buffers(device, &allocate_info, command_buffers) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to allocate compute command buffers"};
+	}
+	for (size_t i = 0; i < details::compute_batch_count; ++i) {
+		batches_[i].command_buffer = command_buffers[i];
+	}
+
+	VkSemaphoreTypeCreateInfo type_info{};
+	type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	type_info.initialValue = 0;
+	VkSemaphoreCreateInfo semaphore_info{};
+	semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphore_info.pNext = &type_info;
+	if (vk.create_semaphore(device, &semaphore_info, nullptr, &timeline_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create compute timeline semaphore"};
+	}
+}
+
+uint64_t compute_manager::completed_value() const {
+	const auto& vk = engine_->device_manager()->dispatch();
+	uint64_t value{0};
+	vk.get_semaphore_counter_value(engine_->device_manager()->logical_device(), timeline_, &value);
+	return value;
+}
+
+VkCommandBuffer compute_manager::commands() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto& current = batches_[current_batch_];
+	if (recording_) { return current.command_buffer; }
+
+	// the batch last submitted from this buffer has to be done before it is rewritten.
+	wait(current.value);
+	vk.reset_command_buffer(current.command_buffer, 0);
+	VkCommandBufferBeginInfo begin_info{};
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (vk.begin_command_buffer(current.command_buffer, &begin_info) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to begin recording compute command buffer"};
+	}
+	recording_ = true;
+	return current.command_buffer;
+}
+
+void compute_manager::dispatch(
+	const compute_pipeline& compute,
+	uint32_t group_count_x,
+	uint32_t group_count_y,
+	uint32_t group_count_z,
+	const std::vector<VkDescriptorSet>& sets,
+	const void* push_constants
+)
+{
+	engine_->compute_pipeline_manager()->dispatch(commands(), compute, group_count_x, group_count_y, group_count_z, sets, push_constants);
+}
+
+void compute_manager::wait_for_graphics(uint64_t frame) noexcept {
+	graphics_wait_ = std::max(graphics_wait_, frame);
+}
+
+uint64_t compute_manager::flush() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (!recording_) { return submitted_value_; }
+	auto& current = batches_[current_batch_];
+	if (vk.end_command_buffer(current.command_buffer) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to record compute command buffer"};
+	}
+	recording_ = false;
+	current.value = submitted_value_ + 1;
+
+	const VkSemaphore graphics_timeline = engine_->draw_manager()->graphics_timeline();
+	const VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	VkTimelineSemaphoreSubmitInfo timeline_info{};
+	timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timeline_info.waitSemaphoreValueCount = graphics_wait_ != 0 ? 1 : 0;
+	timeline_info.pWaitSemaphoreValues = &graphics_wait_;
+	timeline_info.signalSemaphoreValueCount = 1;
+	timeline_info.pSignalSemaphoreValues = &current.value;
+
+	VkSubmitInfo submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.pNext = &timeline_info;
+	submit_info.waitSemaphoreCount = timeline_info.waitSemaphoreValueCount;
+	submit_info.pWaitSemaphores = &graphics_timeline;
+	submit_info.pWaitDstStageMask = &wait_stage;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &current.command_buffer;
+	submit_info.signalSemaphoreCount = 1;
+	submit_info.pSignalSemaphores = &timeline_;
+	if (vk.queue_submit(engine_->device_manager()->compute_queue(), 1, &submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to submit compute command buffer"};
+	}
+	submitted_value_ = current.value;
+	graphics_wait_ = 0;
+	current_batch_ = (current_batch_ + 1) % details::compute_batch_count;
+	return submitted_value_;
+}
+
+void compute_manager::wait(uint64_t value) const {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (value == 0) { return; }
+	VkSemaphoreWaitInfo wait_info{};
+	wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	wait_info.semaphoreCount = 1;
+	wait_info.pSemaphores = &timeline_;
+	wait_info.pValues = &value;
+	vk.wait_semaphores(engine_->device_manager()->logical_device(), &wait_info, UINT64_MAX);
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,93 @@
+#if !defined PG_GODS_VIEW_COMPUTE_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_COMPUTE_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/compute_pipeline_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+namespace details {
+
+// batches that may be pending on the compute queue at once before `flush` waits for the oldest.
+constexpr size_t compute_batch_count = 3;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// records dispatches into batches submitted to the device's compute queue, which is a compute
+// only family where the device has one so the work overlaps rasterization. every batch signals
+// the next value of a timeline semaphore; a frame that reads its results waits for that value
+// through `draw_manager::wait_for_compute`, only at the stages that read them. a batch that
+// reads what rendering wrote waits for the draw manager's graphics timeline the same way.
+// resources used by both queues of different families need `VK_SHARING_MODE_CONCURRENT`.
+class compute_manager {
+private:
+	struct batch {
+		VkCommandBuffer command_buffer{VK_NULL_HANDLE};
+		// timeline value signalled when the batch is done, 0 before its first submit.
+		uint64_t value{0};
+	};
+
+	gods_view::vulkan_engine* engine_;
+	VkCommandPool command_pool_;
+	std::array<batch, details::compute_batch_count> batches_;
+	size_t current_batch_;
+	bool recording_;
+	VkSemaphore timeline_;
+	uint64_t submitted_value_;
+	uint64_t graphics_wait_;
+
+public:
+	compute_manager(gods_view::vulkan_engine* init_engine);
+
+	~compute_manager();
+
+	compute_manager(const compute_manager&) = delete;
+
+	compute_manager& operator=(const compute_manager&) = delete;
+
+	// call once the logical device exists.
+	void initialize();
+
+	[[nodiscard]] VkSemaphore timeline() const noexcept { return timeline_; }
+
+	// value the last flushed batch signals.
+	[[nodiscard]] uint64_t submitted_value() const noexcept { return submitted_value_; }
+
+	[[nodiscard]] uint64_t completed_value() const;
+
+	// the pending batch's command buffer, begun on first use. anything recorded here runs on
+	// the compute queue with the next `flush`.
+	VkCommandBuffer commands();
+
+	void dispatch(
+		const compute_pipeline& compute,
+		uint32_t group_count_x,
+		uint32_t group_count_y = 1,
+		uint32_t group_count_z = 1,
+		const std::vector<VkDescriptorSet>& sets = {},
+		const void* push_constants = nullptr
+	);
+
+	// the next flushed batch starts once graphics frame `frame` has finished on the gpu.
+	void wait_for_graphics(uint64_t frame) noexcept;
+
+	// submits the pending batch and returns the timeline value it signals, or the last
+	// submitted value when nothing was recorded. the draw manager flushes before each frame.
+	uint64_t flush();
+
+	// blocks the calling thread until the timeline reaches `value`.
+	void wait(uint64_t value) const;
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,101 @@
+#include "gods_view/compute_pipeline_manager.h"
+#include "gods_view/shader_reflection.h"
+#include "gods_view/vulkan_engine.h"
+
+namespace pg::gods_view {
+
+compute_pipeline_manager::compute_pipeline_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	pipeline_count_{0}
+{ }
+
+compute_pipeline_manager::~compute_pipeline_manager() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (const auto& [key, entries] : pipelines_) {
+		for (const auto& entry : entries) {
+			vk.destroy_pipeline(device, entry.compute.pipeline, nullptr);
+		}
+	}
+	for (const auto& [path, entry] : shaders_) {
+		vk.destroy_shader_module(device, entry.module, nullptr);
+	}
+}
+
+const compute_pipeline& compute_pipeline_manager::pipeline(const std::string& shader_path, const specialization_info& variant) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto& entries = pipelines_[std::make_pair(shader_path, variant.key)];
+	for (const auto& entry : entries) {
+		if (entry.constants.matches(variant)) { return entry.compute; }
+	}
+	const auto& entry = shader(shader_path);
+
+	VkComputePipelineCreateInfo pipeline_info{};
+	pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipeline_info.stage.module = entry.module;
+	pipeline_info.stage.pName = "main";
+	pipeline_info.stage.pSpecializationInfo = variant.info.mapEntryCount != 0 ? &variant.info : nullptr;
+	pipeline_info.layout = entry.layout;
+	pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+	pipeline_info.basePipelineIndex = -1;
+
+	VkPipeline result;
+	if (vk.create_compute_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &result) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create compute pipeline"};
+	}
+	entries.push_back({specialization_constants{variant}, compute_pipeline{result, entry.layout, entry.set_layouts, entry.push_constant_range}});
+	++pipeline_count_;
+	return entries.back().compute;
+}
+
+void compute_pipeline_manager::dispatch(
+	VkCommandBuffer command_buffer,
+	const compute_pipeline& compute,
+	uint32_t group_count_x,
+	uint32_t group_count_y,
+	uint32_t group_count_z,
+	const std::vector<VkDescriptorSet>& sets,
+	const void* push_constants
+)
+{
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.pipeline);
+	if (!sets.empty()) {
+		vk.cmd_bind_descriptor_sets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute.layout, 0, static_cast<uint32_t>(sets.size()), sets.data(), 0, nullptr);
+	}
+	if (push_constants != nullptr && compute.push_constant_range.size != 0) {
+		vk.cmd_push_constants(
+			command_buffer,
+			compute.layout,
+			compute.push_constant_range.stageFlags,
+			compute.push_constant_range.offset,
+			compute.push_constant_range.size,
+			push_constants
+		);
+	}
+	vk.cmd_dispatch(command_buffer, group_count_x, group_count_y, group_count_z);
+}
+
+const compute_pipeline_manager::shader_entry& compute_pipeline_manager::shader(const std::string& shader_path) {
+	if (auto it = shaders_.find(shader_path); it != shaders_.end()) {
+		return it->second;
+	}
+	auto graphics_pipeline_manager = engine_->graphics_pipeline_manager();
+	const auto bytecode = graphics_pipeline_manager->read_shader(shader_path);
+	const std::vector<shader_reflection> reflections{reflect_shader(bytecode)};
+	if (reflections.front().stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+		throw std::runtime_error{"Shader isn't a compute shader"};
+	}
+	auto layout_info = engine_->layout_cache()->pipeline_layout(reflections);
+	shader_entry entry{
+		graphics_pipeline_manager->shader_module(bytecode),
+		layout_info.layout,
+		std::move(layout_info.set_layouts),
+		layout_info.push_constant_range
+	};
+	return shaders_.emplace(shader_path, std::move(entry)).first->second;
+}
+
+} // end namespace pg::gods_view
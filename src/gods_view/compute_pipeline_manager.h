@@ -0,0 +1,109 @@
+#if !defined PG_GODS_VIEW_COMPUTE_PIPELINE_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_COMPUTE_PIPELINE_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/device_dispatch.h"
+#include "gods_view/shader_variant.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pg::gods_view {
+
+struct compute_pipeline {
+	VkPipeline pipeline;
+	// owned by the engine's layout cache like the graphics pipeline's.
+	VkPipelineLayout layout;
+	std::vector<VkDescriptorSetLayout> set_layouts;
+	VkPushConstantRange push_constant_range;
+};
+
+namespace details {
+
+// makes what dispatches wrote visible to draws recorded after it in the same queue.
+inline void compute_to_graphics_barrier(const device_dispatch& vk, VkCommandBuffer command_buffer) {
+	VkMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	vk.cmd_pipeline_barrier(
+		command_buffer,
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0, 1, &barrier, 0, nullptr, 0, nullptr
+	);
+}
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// builds compute pipelines from spir-v files, one per file and shader variant, and records
+// dispatches of them into any command buffer: the frame's own for inline work through
+// `command_manager::record_inline`, or the compute manager's for work on the async queue.
+class compute_pipeline_manager {
+private:
+	struct pipeline_entry {
+		specialization_constants constants;
+		compute_pipeline compute;
+	};
+
+	struct shader_entry {
+		VkShaderModule module;
+		VkPipelineLayout layout;
+		std::vector<VkDescriptorSetLayout> set_layouts;
+		VkPushConstantRange push_constant_range;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::map<std::string, shader_entry> shaders_;
+	// nodes never move and deques keep their elements in place as they grow, so references
+	// handed out stay valid until destruction. variants whose keys collide share a bucket.
+	std::map<std::pair<std::string, uint64_t>, std::deque<pipeline_entry>> pipelines_;
+	size_t pipeline_count_;
+
+public:
+	compute_pipeline_manager(gods_view::vulkan_engine* init_engine);
+
+	~compute_pipeline_manager();
+
+	compute_pipeline_manager(const compute_pipeline_manager&) = delete;
+
+	compute_pipeline_manager& operator=(const compute_pipeline_manager&) = delete;
+
+	[[nodiscard]] size_t pipeline_count() const noexcept { return pipeline_count_; }
+
+	// looks up or builds the pipeline for `shader_path` specialized for `variant`.
+	const compute_pipeline& pipeline(const std::string& shader_path, const specialization_info& variant = {});
+
+	template <typename... Constants>
+	const compute_pipeline& pipeline(const std::string& shader_path, const shader_variant<Constants...>& variant) {
+		return pipeline(shader_path, variant.specialization());
+	}
+
+	// binds `compute` with `sets` from set 0 on and dispatches `group_count` work groups.
+	// `push_constants` must hold the pipeline's whole push constant range when it has one.
+	void dispatch(
+		VkCommandBuffer command_buffer,
+		const compute_pipeline& compute,
+		uint32_t group_count_x,
+		uint32_t group_count_y = 1,
+		uint32_t group_count_z = 1,
+		const std::vector<VkDescriptorSet>& sets = {},
+		const void* push_constants = nullptr
+	);
+
+private:
+	const shader_entry& shader(const std::string& shader_path);
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,235 @@
+#include "gods_view/descriptor_allocator.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace pg::gods_view {
+
+namespace details {
+
+static uint64_t handle_key(const void* handle_storage, size_t size) noexcept {
+	uint64_t key{0};
+	std::memcpy(&key, handle_storage, size);
+	return key;
+}
+
+} // end namespace pg::gods_view::details
+
+descriptor_allocator::descriptor_allocator(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	current_slot_{0}
+{ }
+
+descriptor_allocator::~descriptor_allocator() {
+	auto device = engine_->device_manager()->logical_device();
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto destroy = [&vk, device](pool_list& pools) {
+		for (auto pool : pools.used) {
+			vk.destroy_descriptor_pool(device, pool, nullptr);
+		}
+		for (auto pool : pools.ready) {
+			vk.destroy_descriptor_pool(device, pool, nullptr);
+		}
+	};
+	for (auto& slot : frame_slots_) {
+		destroy(slot.pools);
+	}
+	destroy(cached_pools_);
+}
+
+void descriptor_allocator::initialize(uint32_t frame_slots) {
+	if (frame_slots == 0) {
+		throw std::runtime_error{"Descriptor allocator needs at least one frame slot"};
+	}
+	frame_slots_.resize(frame_slots);
+	writes_.reserve(details::max_cached_bindings);
+	current_slot_ = static_cast<size_t>((engine_->draw_manager()->submitted_frames() + 1) % frame_slots);
+}
+
+descriptor_allocator_stats descriptor_allocator::stats() const noexcept {
+	size_t pool_count = cached_pools_.used.size() + cached_pools_.ready.size();
+	for (const auto& slot : frame_slots_) {
+		pool_count += slot.pools.used.size() + slot.pools.ready.size();
+	}
+	const size_t frame_sets = frame_slots_.empty() ? 0 : frame_slots_[current_slot_].pools.set_count;
+	return {pool_count, frame_sets, cached_sets_.size()};
+}
+
+void descriptor_allocator::begin_frame() {
+	if (frame_slots_.empty()) { return; }
+	const uint64_t frame = engine_->draw_manager()->submitted_frames() + 1;
+	current_slot_ = static_cast<size_t>(frame % frame_slots_.size());
+	auto& slot = frame_slots_[current_slot_];
+	if (slot.frame > engine_->draw_manager()->completed_frames()) {
+		throw std::runtime_error{"Descriptor frame slot reused while its frame is in flight"};
+	}
+	reset(slot.pools);
+	slot.frame = frame;
+}
+
+VkDescriptorSet descriptor_allocator::allocate(VkDescriptorSetLayout layout) {
+	if (frame_slots_.empty()) {
+		throw std::runtime_error{"Descriptor allocator used before initialize"};
+	}
+	auto& slot = frame_slots_[current_slot_];
+	// the slot may be used before the first `begin_frame`, it then belongs to the next frame.
+	slot.frame = std::max(slot.frame, engine_->draw_manager()->submitted_frames() + 1);
+	return allocate_from(slot.pools, layout);
+}
+
+VkDescriptorSet descriptor_allocator::allocate(VkDescriptorSetLayout layout, const descriptor_binding* bindings, size_t count) {
+	auto set = allocate(layout);
+	write(set, bindings, count);
+	return set;
+}
+
+VkDescriptorSet descriptor_allocator::cached(VkDescriptorSetLayout layout, const descriptor_binding* bindings, size_t count) {
+	if (count > details::max_cached_bindings) {
+		throw std::runtime_error{"Too many bindings for a cached descriptor set"};
+	}
+	details::descriptor_set_key key{};
+	key.words[key.size++] = details::handle_key(&layout, sizeof(layout));
+	for (size_t i = 0; i < count; ++i) {
+		const auto& binding = bindings[i];
+		key.words[key.size++] = (static_cast<uint64_t>(binding.binding) << 32) | static_cast<uint32_t>(binding.type);
+		if (binding.buffer.buffer != VK_NULL_HANDLE) {
+			key.words[key.size++] = details::handle_key(&binding.buffer.buffer, sizeof(binding.buffer.buffer));
+			key.words[key.size++] = binding.buffer.offset;
+			key.words[key.size++] = binding.buffer.range;
+		} else {
+			key.words[key.size++] = details::handle_key(&binding.image.imageView, sizeof(binding.image.imageView));
+			key.words[key.size++] = details::handle_key(&binding.image.sampler, sizeof(binding.image.sampler));
+			key.words[key.size++] = static_cast<uint64_t>(binding.image.imageLayout);
+		}
+	}
+	if (auto it = cached_sets_.find(key); it != cached_sets_.end()) {
+		return it->second;
+	}
+	auto set = allocate_from(cached_pools_, layout);
+	write(set, bindings, count);
+	cached_sets_.emplace(key, set);
+	return set;
+}
+
+void descriptor_allocator::invalidate_buffer(VkBuffer buffer) {
+	invalidate(details::handle_key(&buffer, sizeof(buffer)));
+}
+
+void descriptor_allocator::invalidate_view(VkImageView view) {
+	invalidate(details::handle_key(&view, sizeof(view)));
+}
+
+void descriptor_allocator::clear_cache() {
+	cached_sets_.clear();
+	reset(cached_pools_);
+}
+
+void descriptor_allocator::write(VkDescriptorSet set, const descriptor_binding* bindings, size_t count) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	writes_.clear();
+	for (size_t i = 0; i < count; ++i) {
+		const auto& binding = bindings[i];
+		VkWriteDescriptorSet write{};
+		write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet = set;
+		write.dstBinding = binding.binding;
+		write.dstArrayElement = 0;
+		write.descriptorCount = 1;
+		write.descriptorType = binding.type;
+		if (binding.buffer.buffer != VK_NULL_HANDLE) {
+			write.pBufferInfo = &binding.buffer;
+		} else {
+			write.pImageInfo = &binding.image;
+		}
+		writes_.push_back(write);
+	}
+	if (writes_.empty()) { return; }
+	vk.update_descriptor_sets(engine_->device_manager()->logical_device(), static_cast<uint32_t>(writes_.size()), writes_.data(), 0, nullptr);
+}
+
+VkDescriptorSet descriptor_allocator::allocate_from(pool_list& pools, VkDescriptorSetLayout layout) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	VkDescriptorSetAllocateInfo alloc_info{};
+	alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	alloc_info.descriptorSetCount = 1;
+	alloc_info.pSetLayouts = &layout;
+
+	VkDescriptorSet set;
+	if (!pools.used.empty()) {
+		alloc_info.descriptorPool = pools.used.back();
+		const auto result = vk.allocate_descriptor_sets(device, &alloc_info, &set);
+		if (result == VK_SUCCESS) {
+			++pools.set_count;
+			return set;
+		}
+		if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) {
+			throw std::runtime_error{"Failed to allocate descriptor set"};
+		}
+	}
+
+	// the current pool is full, move on to a ready one or grow by a bigger pool.
+	if (!pools.ready.empty()) {
+		pools.used.push_back(pools.ready.back());
+		pools.ready.pop_back();
+	} else {
+		pools.used.push_back(create_pool(pools.next_sets));
+		pools.next_sets = std::min(pools.next_sets * 2, details::max_descriptor_pool_sets);
+	}
+	alloc_info.descriptorPool = pools.used.back();
+	if (vk.allocate_descriptor_sets(device, &alloc_info, &set) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to allocate descriptor set"};
+	}
+	++pools.set_count;
+	return set;
+}
+
+VkDescriptorPool descriptor_allocator::create_pool(uint32_t max_sets) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	VkDescriptorPoolSize pool_sizes[std::size(details::descriptor_pool_ratios)];
+	for (size_t i = 0; i < std::size(details::descriptor_pool_ratios); ++i) {
+		const auto& ratio = details::descriptor_pool_ratios[i];
+		pool_sizes[i] = {ratio.type, static_cast<uint32_t>(ratio.per_set * static_cast<float>(max_sets))};
+	}
+
+	// no FREE_DESCRIPTOR_SET_BIT, sets are only ever released by resetting the whole pool.
+	VkDescriptorPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	pool_info.flags = 0;
+	pool_info.maxSets = max_sets;
+	pool_info.poolSizeCount = static_cast<uint32_t>(std::size(pool_sizes));
+	pool_info.pPoolSizes = pool_sizes;
+
+	VkDescriptorPool pool;
+	if (vk.create_descriptor_pool(engine_->device_manager()->logical_device(), &pool_info, nullptr, &pool) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create descriptor pool"};
+	}
+	return pool;
+}
+
+void descriptor_allocator::reset(pool_list& pools) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto pool : pools.used) {
+		vk.reset_descriptor_pool(device, pool, 0);
+		pools.ready.push_back(pool);
+	}
+	pools.used.clear();
+	pools.set_count = 0;
+}
+
+void descriptor_allocator::invalidate(uint64_t handle) {
+	// the resource is always the word after a binding's header, see `descriptor_set_key`.
+	for (auto it = cached_sets_.begin(); it != cached_sets_.end();) {
+		const auto& key = it->first;
+		bool referenced = false;
+		for (uint32_t word = 2; word < key.size; word += details::descriptor_key_binding_words) {
+			referenced = referenced || key.words[word] == handle;
+		}
+		it = referenced ? cached_sets_.erase(it) : std::next(it);
+	}
+}
+
+} // end namespace pg::gods_view
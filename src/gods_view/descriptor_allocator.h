@@ -0,0 +1,189 @@
+#if !defined PG_GODS_VIEW_DESCRIPTOR_ALLOCATOR_HEADER_INCLUDED
+#define PG_GODS_VIEW_DESCRIPTOR_ALLOCATOR_HEADER_INCLUDED
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace pg::gods_view {
+
+// one descriptor written to a set, `buffer` or `image` is read depending on `type`.
+struct descriptor_binding {
+	uint32_t binding;
+	VkDescriptorType type;
+	VkDescriptorBufferInfo buffer;
+	VkDescriptorImageInfo image;
+};
+
+[[nodiscard]] inline descriptor_binding buffer_binding(uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE) noexcept {
+	return {binding, type, {buffer, offset, range}, {}};
+}
+
+[[nodiscard]] inline descriptor_binding image_binding(uint32_t binding, VkDescriptorType type, VkSampler sampler, VkImageView view, VkImageLayout layout) noexcept {
+	return {binding, type, {}, {sampler, view, layout}};
+}
+
+struct descriptor_allocator_stats {
+	size_t pool_count;
+	// sets handed out for the frame being recorded.
+	size_t frame_sets;
+	size_t cached_sets;
+};
+
+namespace details {
+
+constexpr uint32_t default_descriptor_frame_slots = 2;
+constexpr uint32_t first_descriptor_pool_sets = 64;
+constexpr uint32_t max_descriptor_pool_sets = 4096;
+
+// descriptors reserved per set in every pool, by type.
+struct descriptor_pool_ratio {
+	VkDescriptorType type;
+	float per_set;
+};
+
+constexpr descriptor_pool_ratio descriptor_pool_ratios[] = {
+	{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f},
+	{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f},
+	{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f},
+	{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f},
+	{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f},
+	{VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f},
+	{VK_DESCRIPTOR_TYPE_SAMPLER, 1.0f},
+	{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f},
+	{VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1.0f},
+	{VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1.0f},
+	{VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1.0f}
+};
+
+// most bindings a cached set can have, so its key fits on the stack.
+constexpr size_t max_cached_bindings = 8;
+// binding and type, the buffer or view, then offset and range or sampler and layout.
+constexpr size_t descriptor_key_binding_words = 4;
+
+struct descriptor_set_key {
+	// the layout, then `descriptor_key_binding_words` per binding.
+	std::array<uint64_t, 1 + max_cached_bindings * descriptor_key_binding_words> words{};
+	uint32_t size{0};
+
+	bool operator<(const descriptor_set_key& other) const noexcept {
+		return std::lexicographical_compare(words.begin(), words.begin() + size, other.words.begin(), other.words.begin() + other.size);
+	}
+};
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// hands out descriptor sets from pools that are only ever reset whole, never freed set by set.
+// sets for a frame come from the pools of that frame's slot, which grows by a bigger pool
+// whenever its current one runs out and is reset with `vkResetDescriptorPool` once the frame
+// that last used it has retired. sets that live across frames are cached by their layout and
+// contents in pools of their own, so asking for the same bindings again costs a map lookup.
+// like command recording it is used from the render thread only.
+class descriptor_allocator {
+private:
+	struct pool_list {
+		// the last one is allocated from, the others ran out.
+		std::vector<VkDescriptorPool> used;
+		std::vector<VkDescriptorPool> ready;
+		uint32_t next_sets{details::first_descriptor_pool_sets};
+		size_t set_count{0};
+	};
+
+	struct frame_slot {
+		pool_list pools;
+		// draw manager frame that last allocated from this slot.
+		uint64_t frame{0};
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::vector<frame_slot> frame_slots_;
+	size_t current_slot_;
+	pool_list cached_pools_;
+	std::map<details::descriptor_set_key, VkDescriptorSet> cached_sets_;
+	// scratch for `write`, reused so updates allocate nothing.
+	std::vector<VkWriteDescriptorSet> writes_;
+
+public:
+	descriptor_allocator(gods_view::vulkan_engine* init_engine);
+
+	~descriptor_allocator();
+
+	descriptor_allocator(const descriptor_allocator&) = delete;
+
+	descriptor_allocator& operator=(const descriptor_allocator&) = delete;
+
+	// `frame_slots` must be at least the number of frames the draw manager keeps in flight.
+	void initialize(uint32_t frame_slots = details::default_descriptor_frame_slots);
+
+	[[nodiscard]] descriptor_allocator_stats stats() const noexcept;
+
+	// moves to the slot of the frame about to be recorded and resets its pools, called by the
+	// draw manager once the previous frame's fence has been waited on.
+	void begin_frame();
+
+	// a set that is valid until the current frame retires.
+	VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+	// the array and pointer forms take braced bindings without a heap allocation.
+	VkDescriptorSet allocate(VkDescriptorSetLayout layout, const descriptor_binding* bindings, size_t count);
+
+	VkDescriptorSet allocate(VkDescriptorSetLayout layout, const std::vector<descriptor_binding>& bindings) {
+		return allocate(layout, bindings.data(), bindings.size());
+	}
+
+	template<size_t Count>
+	VkDescriptorSet allocate(VkDescriptorSetLayout layout, const descriptor_binding (&bindings)[Count]) {
+		return allocate(layout, bindings, Count);
+	}
+
+	// a set that lives until `clear_cache`, shared by every caller asking for the same layout
+	// and bindings, at most `max_cached_bindings` of them. a hit is a map lookup with a key
+	// built on the stack. handle values are reused by the driver once destroyed, so whoever
+	// destroys a buffer or view that may be in a cached set calls `invalidate_*` first.
+	VkDescriptorSet cached(VkDescriptorSetLayout layout, const descriptor_binding* bindings, size_t count);
+
+	VkDescriptorSet cached(VkDescriptorSetLayout layout, const std::vector<descriptor_binding>& bindings) {
+		return cached(layout, bindings.data(), bindings.size());
+	}
+
+	template<size_t Count>
+	VkDescriptorSet cached(VkDescriptorSetLayout layout, const descriptor_binding (&bindings)[Count]) {
+		return cached(layout, bindings, Count);
+	}
+
+	// forgets the cached sets that reference `buffer` or `view`. their descriptors stay in the
+	// pool until `clear_cache`, but no later lookup hands them out.
+	void invalidate_buffer(VkBuffer buffer);
+
+	void invalidate_view(VkImageView view);
+
+	// drops every cached set, the gpu must no longer use any of them.
+	void clear_cache();
+
+	void write(VkDescriptorSet set, const descriptor_binding* bindings, size_t count);
+
+	void write(VkDescriptorSet set, const std::vector<descriptor_binding>& bindings) {
+		write(set, bindings.data(), bindings.size());
+	}
+
+private:
+	VkDescriptorSet allocate_from(pool_list& pools, VkDescriptorSetLayout layout);
+
+	VkDescriptorPool create_pool(uint32_t max_sets);
+
+	void reset(pool_list& pools);
+
+	void invalidate(uint64_t handle);
+};
+
+} // end namespace pg::gods_view
+
+#endif
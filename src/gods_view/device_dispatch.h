@@ -0,0 +1,181 @@
+#if !defined PG_GODS_VIEW_DEVICE_DISPATCH_HEADER_INCLUDED
+#define PG_GODS_VIEW_DEVICE_DISPATCH_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/frame_counters.h"
+
+#include <vulkan/vulkan.h>
+
+namespace pg::gods_view {
+
+// every device level command the engine calls, as `X(vulkan name, table member)`.
+#define PG_GODS_VIEW_DEVICE_FUNCTIONS(X) \
+	X(vkGetDeviceQueue, get_device_queue) \
+	X(vkDestroyDevice, destroy_device) \
+	X(vkDeviceWaitIdle, device_wait_idle) \
+	X(vkQueueSubmit, queue_submit) \
+	X(vkQueueWaitIdle, queue_wait_idle) \
+	X(vkQueuePresentKHR, queue_present_khr) \
+	X(vkCreateSwapchainKHR, create_swapchain_khr) \
+	X(vkDestroySwapchainKHR, destroy_swapchain_khr) \
+	X(vkGetSwapchainImagesKHR, get_swapchain_images_khr) \
+	X(vkAcquireNextImageKHR, acquire_next_image_khr) \
+	X(vkAllocateMemory, allocate_memory) \
+	X(vkFreeMemory, free_memory) \
+	X(vkMapMemory, map_memory) \
+	X(vkUnmapMemory, unmap_memory) \
+	X(vkFlushMappedMemoryRanges, flush_mapped_memory_ranges) \
+	X(vkInvalidateMappedMemoryRanges, invalidate_mapped_memory_ranges) \
+	X(vkCreateBuffer, create_buffer) \
+	X(vkDestroyBuffer, destroy_buffer) \
+	X(vkGetBufferMemoryRequirements, get_buffer_memory_requirements) \
+	X(vkBindBufferMemory, bind_buffer_memory) \
+	X(vkCreateImage, create_image) \
+	X(vkDestroyImage, destroy_image) \
+	X(vkGetImageMemoryRequirements, get_image_memory_requirements) \
+	X(vkBindImageMemory, bind_image_memory) \
+	X(vkCreateImageView, create_image_view) \
+	X(vkDestroyImageView, destroy_image_view) \
+	X(vkCreateSampler, create_sampler) \
+	X(vkDestroySampler, destroy_sampler) \
+	X(vkCreateShaderModule, create_shader_module) \
+	X(vkDestroyShaderModule, destroy_shader_module) \
+	X(vkCreatePipelineLayout, create_pipeline_layout) \
+	X(vkDestroyPipelineLayout, destroy_pipeline_layout) \
+	X(vkCreateGraphicsPipelines, create_graphics_pipelines) \
+	X(vkCreateComputePipelines, create_compute_pipelines) \
+	X(vkDestroyPipeline, destroy_pipeline) \
+	X(vkCreateRenderPass, create_render_pass) \
+	X(vkDestroyRenderPass, destroy_render_pass) \
+	X(vkCreateFramebuffer, create_framebuffer) \
+	X(vkDestroyFramebuffer, destroy_framebuffer) \
+	X(vkCreateDescriptorSetLayout, create_descriptor_set_layout) \
+	X(vkDestroyDescriptorSetLayout, destroy_descriptor_set_layout) \
+	X(vkCreateDescriptorPool, create_descriptor_pool) \
+	X(vkDestroyDescriptorPool, destroy_descriptor_pool) \
+	X(vkResetDescriptorPool, reset_descriptor_pool) \
+	X(vkAllocateDescriptorSets, allocate_descriptor_sets) \
+	X(vkUpdateDescriptorSets, update_descriptor_sets) \
+	X(vkCreateCommandPool, create_command_pool) \
+	X(vkDestroyCommandPool, destroy_command_pool) \
+	X(vkResetCommandPool, reset_command_pool) \
+	X(vkAllocateCommandBuffers, allocate_command_buffers) \
+	X(vkFreeCommandBuffers, free_command_buffers) \
+	X(vkBeginCommandBuffer, begin_command_buffer) \
+	X(vkEndCommandBuffer, end_command_buffer) \
+	X(vkResetCommandBuffer, reset_command_buffer) \
+	X(vkCreateSemaphore, create_semaphore) \
+	X(vkDestroySemaphore, destroy_semaphore) \
+	X(vkGetSemaphoreCounterValue, get_semaphore_counter_value) \
+	X(vkWaitSemaphores, wait_semaphores) \
+	X(vkCreateFence, create_fence) \
+	X(vkDestroyFence, destroy_fence) \
+	X(vkWaitForFences, wait_for_fences) \
+	X(vkResetFences, reset_fences) \
+	X(vkGetFenceStatus, get_fence_status) \
+	X(vkCreateQueryPool, create_query_pool) \
+	X(vkDestroyQueryPool, destroy_query_pool) \
+	X(vkGetQueryPoolResults, get_query_pool_results) \
+	X(vkResetQueryPool, reset_query_pool) \
+	X(vkCmdBeginRenderPass, cmd_begin_render_pass) \
+	X(vkCmdNextSubpass, cmd_next_subpass) \
+	X(vkCmdEndRenderPass, cmd_end_render_pass) \
+	X(vkCmdBindPipeline, cmd_bind_pipeline) \
+	X(vkCmdBindDescriptorSets, cmd_bind_descriptor_sets) \
+	X(vkCmdBindVertexBuffers, cmd_bind_vertex_buffers) \
+	X(vkCmdBindIndexBuffer, cmd_bind_index_buffer) \
+	X(vkCmdPushConstants, cmd_push_constants) \
+	X(vkCmdSetViewport, cmd_set_viewport) \
+	X(vkCmdSetScissor, cmd_set_scissor) \
+	X(vkCmdSetLineWidth, cmd_set_line_width) \
+	X(vkCmdDraw, cmd_draw) \
+	X(vkCmdDrawIndexed, cmd_draw_indexed) \
+	X(vkCmdDispatch, cmd_dispatch) \
+	X(vkCmdCopyBuffer, cmd_copy_buffer) \
+	X(vkCmdCopyBufferToImage, cmd_copy_buffer_to_image) \
+	X(vkCmdCopyImageToBuffer, cmd_copy_image_to_buffer) \
+	X(vkCmdCopyImage, cmd_copy_image) \
+	X(vkCmdBlitImage, cmd_blit_image) \
+	X(vkCmdClearColorImage, cmd_clear_color_image) \
+	X(vkCmdPipelineBarrier, cmd_pipeline_barrier) \
+	X(vkCmdResetQueryPool, cmd_reset_query_pool) \
+	X(vkCmdWriteTimestamp, cmd_write_timestamp)
+
+// extension commands the loader doesn't export, null until `load` and wherever the driver
+// doesn't return them; `dynamic_state_support` says which ones may be called.
+#define PG_GODS_VIEW_OPTIONAL_DEVICE_FUNCTIONS(X) \
+	X(vkCmdSetCullModeEXT, cmd_set_cull_mode) \
+	X(vkCmdSetFrontFaceEXT, cmd_set_front_face) \
+	X(vkCmdSetPrimitiveTopologyEXT, cmd_set_primitive_topology) \
+	X(vkCmdSetDepthTestEnableEXT, cmd_set_depth_test_enable) \
+	X(vkCmdSetDepthWriteEnableEXT, cmd_set_depth_write_enable) \
+	X(vkCmdSetDepthCompareOpEXT, cmd_set_depth_compare_op) \
+	X(vkCmdSetPrimitiveRestartEnableEXT, cmd_set_primitive_restart_enable) \
+	X(vkCmdSetDepthBiasEnableEXT, cmd_set_depth_bias_enable) \
+	X(vkCmdSetPolygonModeEXT, cmd_set_polygon_mode) \
+	X(vkCmdSetColorBlendEnableEXT, cmd_set_color_blend_enable) \
+	X(vkCmdSetColorBlendEquationEXT, cmd_set_color_blend_equation) \
+	X(vkCmdSetColorWriteMaskEXT, cmd_set_color_write_mask)
+
+namespace details {
+
+#if defined PG_GODS_VIEW_COUNTERS
+template <typename Function, device_call_kind Kind>
+struct counted_device_function;
+
+// calls straight through to the entry point after one relaxed increment of its kind's total.
+template <typename Result, typename... Arguments, device_call_kind Kind>
+struct counted_device_function<Result (VKAPI_PTR*)(Arguments...), Kind> {
+	using pointer = Result (VKAPI_PTR*)(Arguments...);
+
+	pointer function;
+
+	constexpr counted_device_function(pointer init_function) noexcept : function{init_function} { }
+
+	explicit operator bool() const noexcept { return function != nullptr; }
+
+	Result operator()(Arguments... arguments) const {
+		count_device_call(Kind);
+		return function(arguments...);
+	}
+};
+#endif
+
+} // end namespace pg::gods_view::details
+
+// device level entry points fetched with `vkGetDeviceProcAddr`, so calls go straight to the
+// driver instead of through the loader's trampolines that look the device's table up first.
+// one table per logical device, owned by its device manager. members start out as the
+// loader's exports, so the table is usable even before `load`. with PG_GODS_VIEW_COUNTERS
+// every call also counts towards `frame_counters`.
+struct device_dispatch {
+	VkDevice device{VK_NULL_HANDLE};
+
+#if defined PG_GODS_VIEW_COUNTERS
+#define PG_GODS_VIEW_DECLARE_DEVICE_FUNCTION(function, name) \
+	details::counted_device_function<PFN_##function, details::classify_device_call(#function)> name{function};
+#define PG_GODS_VIEW_DECLARE_OPTIONAL_DEVICE_FUNCTION(function, name) \
+	details::counted_device_function<PFN_##function, details::classify_device_call(#function)> name{nullptr};
+#else
+#define PG_GODS_VIEW_DECLARE_DEVICE_FUNCTION(function, name) PFN_##function name{function};
+#define PG_GODS_VIEW_DECLARE_OPTIONAL_DEVICE_FUNCTION(function, name) PFN_##function name{nullptr};
+#endif
+	PG_GODS_VIEW_DEVICE_FUNCTIONS(PG_GODS_VIEW_DECLARE_DEVICE_FUNCTION)
+	PG_GODS_VIEW_OPTIONAL_DEVICE_FUNCTIONS(PG_GODS_VIEW_DECLARE_OPTIONAL_DEVICE_FUNCTION)
+#undef PG_GODS_VIEW_DECLARE_OPTIONAL_DEVICE_FUNCTION
+#undef PG_GODS_VIEW_DECLARE_DEVICE_FUNCTION
+
+	// entry points the driver doesn't return keep the loader's export, optional ones stay null.
+	void load(VkDevice init_device) noexcept {
+		device = init_device;
+#define PG_GODS_VIEW_LOAD_DEVICE_FUNCTION(function, name) \
+		if (auto loaded = reinterpret_cast<PFN_##function>(vkGetDeviceProcAddr(device, #function))) { name = loaded; }
+		PG_GODS_VIEW_DEVICE_FUNCTIONS(PG_GODS_VIEW_LOAD_DEVICE_FUNCTION)
+		PG_GODS_VIEW_OPTIONAL_DEVICE_FUNCTIONS(PG_GODS_VIEW_LOAD_DEVICE_FUNCTION)
+#undef PG_GODS_VIEW_LOAD_DEVICE_FUNCTION
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif
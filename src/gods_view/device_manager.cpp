@@ -1,6 +1,8 @@
 #include "gods_view/device_manager.h"	
 #include "gods_view/vulkan_engine.h"
 
+#include <cstring>
+
 namespace pg::gods_view {
 
 void device_manager::grab_physical_device() {
@@ -19,6 +21,7 @@ void device_manager::grab_physical_device() {
 	if (physical_device_ == nullptr) {
 		throw std::runtime_error{"Failed to find a suitable GPU"};
 	}
+	vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties_);
 }
 
 void device_manager::create_logical_device() {
@@ -27,7 +30,8 @@ void device_manager::create_logical_device() {
 	std::vector<VkDeviceQueueCreateInfo> queue_create_infos{};
 	std::set<uint32_t> unique_queue_families = {
 		indices.graphics_family.value(),
-		indices.present_family.value()
+		indices.present_family.value(),
+		indices.compute_family.value()
 	};
 
 	float queue_priority{1.0f};
@@ -47,8 +51,69 @@ void device_manager::create_logical_device() {
 	create_info.pQueueCreateInfos = queue_create_infos.data();
 	create_info.pEnabledFeatures = &device_features;
 
-	create_info.enabledExtensionCount = static_cast<uint32_t>(details::device_extensions.size());
-	create_info.ppEnabledExtensionNames = details::device_extensions.data();
+	auto extensions = select_device_extensions();
+	auto enabled = [&extensions](const char* name) {
+		for (auto extension : extensions) {
+			if (std::strcmp(extension, name) == 0) { return true; }
+		}
+		return false;
+	};
+	// timeline semaphores order async compute against graphics, core and required since 1.2.
+	VkPhysicalDeviceVulkan12Features vulkan12_features{};
+	vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES;
+	// only features of enabled extensions are queried and switched on.
+	VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features{};
+	dynamic_state_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+	VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features{};
+	dynamic_state2_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+	VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features{};
+	dynamic_state3_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+	void* feature_chain{&vulkan12_features};
+	if (enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+		dynamic_state_features.pNext = feature_chain;
+		feature_chain = &dynamic_state_features;
+	}
+	if (enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+		dynamic_state2_features.pNext = feature_chain;
+		feature_chain = &dynamic_state2_features;
+	}
+	if (enabled(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+		dynamic_state3_features.pNext = feature_chain;
+		feature_chain = &dynamic_state3_features;
+	}
+	VkPhysicalDeviceFeatures2 features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features.pNext = feature_chain;
+	vkGetPhysicalDeviceFeatures2(physical_device_, &features);
+	if (vulkan12_features.timelineSemaphore != VK_TRUE) {
+		throw std::runtime_error{"Device doesn't support timeline semaphores"};
+	}
+	device_features.largePoints = features.features.largePoints;
+	large_points_ = device_features.largePoints == VK_TRUE;
+	void* const vulkan12_next = vulkan12_features.pNext;
+	vulkan12_features = {};
+	vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES;
+	vulkan12_features.pNext = vulkan12_next;
+	vulkan12_features.timelineSemaphore = VK_TRUE;
+	// of the state3 features only those the pipeline manager sets are switched on.
+	const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT reported = dynamic_state3_features;
+	dynamic_state3_features = {};
+	dynamic_state3_features.sType = reported.sType;
+	dynamic_state3_features.pNext = reported.pNext;
+	dynamic_state3_features.extendedDynamicState3PolygonMode = reported.extendedDynamicState3PolygonMode;
+	dynamic_state3_features.extendedDynamicState3ColorBlendEnable = reported.extendedDynamicState3ColorBlendEnable;
+	dynamic_state3_features.extendedDynamicState3ColorBlendEquation = reported.extendedDynamicState3ColorBlendEquation;
+	dynamic_state3_features.extendedDynamicState3ColorWriteMask = reported.extendedDynamicState3ColorWriteMask;
+	create_info.pNext = feature_chain;
+	dynamic_state_support_.extended = dynamic_state_features.extendedDynamicState == VK_TRUE;
+	dynamic_state_support_.extended2 = dynamic_state2_features.extendedDynamicState2 == VK_TRUE;
+	dynamic_state_support_.polygon_mode = dynamic_state3_features.extendedDynamicState3PolygonMode == VK_TRUE;
+	dynamic_state_support_.color_blend_enable = dynamic_state3_features.extendedDynamicState3ColorBlendEnable == VK_TRUE;
+	dynamic_state_support_.color_blend_equation = dynamic_state3_features.extendedDynamicState3ColorBlendEquation == VK_TRUE;
+	dynamic_state_support_.color_write_mask = dynamic_state3_features.extendedDynamicState3ColorWriteMask == VK_TRUE;
+
+	create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	create_info.ppEnabledExtensionNames = extensions.data();
 	if (details::enable_validation_layers) {
 		auto validation_manager = engine_->validation_layer_manager();
 		create_info.enabledLayerCount = validation_manager->validation_layer_size();
@@ -59,8 +124,20 @@ void device_manager::create_logical_device() {
 	if (vkCreateDevice(physical_device_, &create_info, nullptr, &device_) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create logical device."};
 	}
-	vkGetDeviceQueue(device_, indices.graphics_family.value(), 0, &graphics_queue_);
-	vkGetDeviceQueue(device_, indices.present_family.value(), 0, &present_queue_);
+	dispatch_.load(device_);
+	dispatch_.get_device_queue(device_, indices.graphics_family.value(), 0, &graphics_queue_);
+	dispatch_.get_device_queue(device_, indices.present_family.value(), 0, &present_queue_);
+	dispatch_.get_device_queue(device_, indices.compute_family.value(), 0, &compute_queue_);
+	queue_families_ = indices;
+	enabled_extensions_.assign(extensions.begin(), extensions.end());
+	check_dynamic_state_commands();
+}
+
+bool device_manager::extension_enabled(std::string_view extension_name) const noexcept {
+	for (const auto& extension : enabled_extensions_) {
+		if (extension == extension_name) { return true; }
+	}
+	return false;
 }
 
 
@@ -89,9 +166,44 @@ bool device_manager::check_device_extensions(VkPhysicalDevice device) {
 	return required_extensions.empty();
 }
 
+std::vector<const char*> device_manager::select_device_extensions() {
+	uint32_t extension_count;
+	vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &extension_count, nullptr);
+	std::vector<VkExtensionProperties> available_extensions{extension_count};
+	vkEnumerateDeviceExtensionProperties(physical_device_, nullptr, &extension_count, available_extensions.data());
+
+	std::vector<const char*> extensions{details::device_extensions.begin(), details::device_extensions.end()};
+	for (const auto optional_extension : details::optional_device_extensions) {
+		for (const auto& extension : available_extensions) {
+			if (std::strcmp(optional_extension, extension.extensionName) == 0) {
+				extensions.push_back(optional_extension);
+				break;
+			}
+		}
+	}
+	return extensions;
+}
+
+void device_manager::check_dynamic_state_commands() {
+	const auto& vk = dispatch_;
+	auto& support = dynamic_state_support_;
+	support.extended = support.extended &&
+		vk.cmd_set_cull_mode &&
+		vk.cmd_set_front_face &&
+		vk.cmd_set_primitive_topology &&
+		vk.cmd_set_depth_test_enable &&
+		vk.cmd_set_depth_write_enable &&
+		vk.cmd_set_depth_compare_op;
+	support.extended2 = support.extended2 && vk.cmd_set_primitive_restart_enable && vk.cmd_set_depth_bias_enable;
+	support.polygon_mode = support.polygon_mode && vk.cmd_set_polygon_mode;
+	support.color_blend_enable = support.color_blend_enable && vk.cmd_set_color_blend_enable;
+	support.color_blend_equation = support.color_blend_equation && vk.cmd_set_color_blend_equation;
+	support.color_write_mask = support.color_write_mask && vk.cmd_set_color_write_mask;
+}
+
 void device_manager::destroy_devices() {
 	if (device_ != nullptr) {
-		vkDestroyDevice(device_, nullptr);
+		dispatch_.destroy_device(device_, nullptr);
 	}
 }
 
@@ -2,12 +2,16 @@
 #define PG_GODS_VIEW_DEVICE_MANAGER_HEADER_INCLUDED
 #pragma once
 
+#include "gods_view/device_dispatch.h"
+#include "gods_view/pipeline_state.h"
 #include "gods_view/validation_layers.h"
 
 #include <vulkan/vulkan.h>
 
 #include <system_error>
 #include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
@@ -16,6 +20,9 @@ namespace pg::gods_view {
 struct queue_family_indices {
 	std::optional<uint32_t> graphics_family;
 	std::optional<uint32_t> present_family;
+	// a compute only family when the device has one, so dispatches run beside rendering;
+	// the graphics family otherwise.
+	std::optional<uint32_t> compute_family;
 
 	bool is_complete() {
 		return graphics_family.has_value() && present_family.has_value();
@@ -44,6 +51,16 @@ static queue_family_indices find_queue_families(VkPhysicalDevice physical_device
 		if (indices.is_complete()) { break; }
 		++i;
 	}
+	for (uint32_t family = 0; family < queue_family_count; ++family) {
+		const auto flags = queue_families[family].queueFlags;
+		if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+			indices.compute_family = family;
+			break;
+		}
+	}
+	if (!indices.compute_family.has_value()) {
+		indices.compute_family = indices.graphics_family;
+	}
 	return indices;
 }
 
@@ -59,6 +76,13 @@ private:
 	VkDevice device_;
 	VkQueue graphics_queue_;
 	VkQueue present_queue_;
+	VkQueue compute_queue_;
+	queue_family_indices queue_families_;
+	VkPhysicalDeviceMemoryProperties memory_properties_;
+	std::vector<std::string> enabled_extensions_;
+	gods_view::dynamic_state_support dynamic_state_support_;
+	bool large_points_;
+	gods_view::device_dispatch dispatch_;
 
 public:
 	device_manager(gods_view::vulkan_engine* init_engine) :
@@ -66,7 +90,12 @@ public:
 		device_count_{0},
 		physical_device_{nullptr},
 		device_{nullptr},
-		graphics_queue_{nullptr}
+		graphics_queue_{nullptr},
+		present_queue_{nullptr},
+		compute_queue_{nullptr},
+		queue_families_{},
+		memory_properties_{},
+		large_points_{false}
 	{ }
 
 	~device_manager() {
@@ -77,10 +106,29 @@ public:
 
 	[[nodiscard]] VkDevice logical_device() const noexcept { return device_; }
 
+	// device level calls go through this rather than the loader, loaded with the logical device.
+	[[nodiscard]] const gods_view::device_dispatch& dispatch() const noexcept { return dispatch_; }
+
 	[[nodiscard]] const VkQueue graphics_queue() const noexcept { return graphics_queue_; }
 
 	[[nodiscard]] const VkQueue present_queue() const noexcept { return present_queue_; }
 
+	[[nodiscard]] const VkQueue compute_queue() const noexcept { return compute_queue_; }
+
+	// dispatches on the compute queue overlap rendering instead of queueing behind it.
+	[[nodiscard]] bool async_compute() const noexcept { return queue_families_.compute_family != queue_families_.graphics_family; }
+
+	[[nodiscard]] const queue_family_indices& queue_families() const noexcept { return queue_families_; }
+
+	[[nodiscard]] const VkPhysicalDeviceMemoryProperties& memory_properties() const noexcept { return memory_properties_; }
+
+	[[nodiscard]] const gods_view::dynamic_state_support& dynamic_state_support() const noexcept { return dynamic_state_support_; }
+
+	// point sizes other than 1 are honoured, enabled whenever the device has the feature.
+	[[nodiscard]] bool large_points() const noexcept { return large_points_; }
+
+	[[nodiscard]] bool extension_enabled(std::string_view extension_name) const noexcept;
+
 	void grab_physical_device();
 
 	void create_logical_device();
@@ -90,6 +138,11 @@ private:
 
 	bool check_device_extensions(VkPhysicalDevice device);
 
+	std::vector<const char*> select_device_extensions();
+
+	// drops the dynamic state the driver didn't return every command for.
+	void check_dynamic_state_commands();
+
 	void destroy_devices();
 };
 	
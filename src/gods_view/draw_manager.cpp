@@ -1,102 +1,311 @@
 #include "gods_view/draw_manager.h"
 #include "gods_view/vulkan_engine.h"
 
+#include <algorithm>
+
 namespace pg::gods_view {
 
 draw_manager::draw_manager(gods_view::vulkan_engine* init_engine) :
-	engine_{init_engine}
+	engine_{init_engine},
+	render_finished_semaphore_{VK_NULL_HANDLE},
+	inflight_fence_{VK_NULL_HANDLE},
+	graphics_timeline_{VK_NULL_HANDLE},
+	compute_wait_{0},
+	compute_wait_stages_{0},
+	submitted_frames_{0},
+	completed_frames_{0}
 { }
 
 draw_manager::~draw_manager() {
-	vkDestroySemaphore(engine_->device_manager()->logical_device(), render_finished_semaphore_, nullptr);
-	vkDestroySemaphore(engine_->device_manager()->logical_device(), image_available_semaphore_, nullptr);
-	vkDestroyFence(engine_->device_manager()->logical_device(), inflight_fence_, nullptr);
-	for (auto framebuffer : swap_chain_framebuffers_) {
-		vkDestroyFramebuffer(engine_->device_manager()->logical_device(), framebuffer, nullptr);
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.destroy_semaphore(engine_->device_manager()->logical_device(), render_finished_semaphore_, nullptr);
+	for (auto semaphore : image_available_semaphores_) {
+		vk.destroy_semaphore(engine_->device_manager()->logical_device(), semaphore, nullptr);
+	}
+	vk.destroy_fence(engine_->device_manager()->logical_device(), inflight_fence_, nullptr);
+	vk.destroy_semaphore(engine_->device_manager()->logical_device(), graphics_timeline_, nullptr);
+	for (const auto& framebuffers : swap_chain_framebuffers_) {
+		for (auto framebuffer : framebuffers) {
+			vk.destroy_framebuffer(engine_->device_manager()->logical_device(), framebuffer, nullptr);
+		}
 	}
 }
 
 void draw_manager::create_framebuffers() {
-	swap_chain_framebuffers_.resize(engine_->surface_manager()->swap_chain_image_views().size());
-	for (size_t i = 0; i < engine_->surface_manager()->swap_chain_image_views().size(); ++i) {
+	auto surface_manager = engine_->surface_manager();
+	engine_->post_processor()->create_targets();
+	for (size_t surface = swap_chain_framebuffers_.size(); surface < surface_manager->surface_count(); ++surface) {
+		swap_chain_framebuffers_.push_back(create_framebuffers(surface));
+	}
+}
+
+std::vector<VkFramebuffer> draw_manager::create_framebuffers(size_t surface_index) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto surface_manager = engine_->surface_manager();
+	auto post_processor = engine_->post_processor();
+	const auto& image_views = surface_manager->swap_chain_image_views(surface_index);
+	std::vector<VkFramebuffer> framebuffers(image_views.size());
+	for (size_t i = 0; i < image_views.size(); ++i) {
+		// with post processing every image of a window shares the one hdr attachment,
+		// only one frame is ever in flight.
 		VkImageView attachments[] = {
-			engine_->surface_manager()->swap_chain_image_views()[i]
+			image_views[i],
+			post_processor->enabled() ? post_processor->scene_view(surface_index) : VK_NULL_HANDLE
 		};
 		VkFramebufferCreateInfo framebuffer_info{};
 		framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		framebuffer_info.renderPass = engine_->graphics_pipeline_manager()->render_pass();
-		framebuffer_info.attachmentCount = 1;
+		framebuffer_info.attachmentCount = post_processor->enabled() ? 2 : 1;
 		framebuffer_info.pAttachments = attachments;
-		framebuffer_info.width = engine_->surface_manager()->swap_chain_extent().width;
-		framebuffer_info.height = engine_->surface_manager()->swap_chain_extent().height;
+		framebuffer_info.width = surface_manager->swap_chain_extent(surface_index).width;
+		framebuffer_info.height = surface_manager->swap_chain_extent(surface_index).height;
 		framebuffer_info.layers = 1;
 
-		if (vkCreateFramebuffer(engine_->device_manager()->logical_device(), &framebuffer_info, nullptr, &swap_chain_framebuffers_[i]) != VK_SUCCESS) {
+		if (vk.create_framebuffer(engine_->device_manager()->logical_device(), &framebuffer_info, nullptr, &framebuffers[i]) != VK_SUCCESS) {
+			for (size_t j = 0; j < i; ++j) {
+				vk.destroy_framebuffer(engine_->device_manager()->logical_device(), framebuffers[j], nullptr);
+			}
 			throw std::runtime_error{"Failed to create framebuffer"};
 		}
 	}
+	return framebuffers;
+}
+
+void draw_manager::recreate_swap_chain(size_t surface_index) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	// the frame fence is already signalled, this also waits out compute work and presents
+	// that may still read the old images and targets.
+	vk.device_wait_idle(vk.device);
+	for (auto framebuffer : swap_chain_framebuffers_[surface_index]) {
+		vk.destroy_framebuffer(vk.device, framebuffer, nullptr);
+	}
+	swap_chain_framebuffers_[surface_index].clear();
+	engine_->surface_manager()->recreate_swap_chain(surface_index);
+	engine_->post_processor()->recreate_target(surface_index);
+	engine_->resolution_scaler()->recreate_target(surface_index);
+	swap_chain_framebuffers_[surface_index] = create_framebuffers(surface_index);
+	out_of_date_[surface_index] = false;
+}
+
+VkResult draw_manager::acquire_image(size_t surface_index, uint32_t& image_index) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	return vk.acquire_next_image_khr(
+		vk.device,
+		engine_->surface_manager()->swapchain(surface_index),
+		UINT64_MAX,
+		image_available_semaphores_[surface_index],
+		VK_NULL_HANDLE,
+		&image_index
+	);
+}
+
+bool draw_manager::streaming() const {
+	return engine_->texture_manager()->busy() || engine_->mesh_manager()->busy() || engine_->capture_manager()->busy();
 }
 
 void draw_manager::create_sync_objects() {
+	const auto& vk = engine_->device_manager()->dispatch();
 	VkSemaphoreCreateInfo semaphore_info{};
 	semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-	
+
 	VkFenceCreateInfo fence_info{};
 	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 	fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-	if (vkCreateSemaphore(engine_->device_manager()->logical_device(), &semaphore_info, nullptr, &image_available_semaphore_) != VK_SUCCESS ||
-		vkCreateSemaphore(engine_->device_manager()->logical_device(), &semaphore_info, nullptr, &render_finished_semaphore_) != VK_SUCCESS ||
-		vkCreateFence(engine_->device_manager()->logical_device(), &fence_info, nullptr, &inflight_fence_) != VK_SUCCESS)
-	{
-		throw std::runtime_error{"Failed to create synchronization objects for a frame"};
+	VkSemaphoreTypeCreateInfo timeline_type_info{};
+	timeline_type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	timeline_type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timeline_type_info.initialValue = 0;
+	VkSemaphoreCreateInfo timeline_info{};
+	timeline_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	timeline_info.pNext = &timeline_type_info;
+
+	if (inflight_fence_ == VK_NULL_HANDLE) {
+		if (vk.create_semaphore(engine_->device_manager()->logical_device(), &semaphore_info, nullptr, &render_finished_semaphore_) != VK_SUCCESS ||
+			vk.create_semaphore(engine_->device_manager()->logical_device(), &timeline_info, nullptr, &graphics_timeline_) != VK_SUCCESS ||
+			vk.create_fence(engine_->device_manager()->logical_device(), &fence_info, nullptr, &inflight_fence_) != VK_SUCCESS)
+		{
+			throw std::runtime_error{"Failed to create synchronization objects for a frame"};
+		}
 	}
+	const size_t surface_count = engine_->surface_manager()->surface_count();
+	while (image_available_semaphores_.size() < surface_count) {
+		VkSemaphore semaphore;
+		if (vk.create_semaphore(engine_->device_manager()->logical_device(), &semaphore_info, nullptr, &semaphore) != VK_SUCCESS) {
+			throw std::runtime_error{"Failed to create synchronization objects for a frame"};
+		}
+		image_available_semaphores_.push_back(semaphore);
+	}
+	out_of_date_.resize(surface_count, false);
+	frame_targets_.reserve(surface_count);
+	wait_stages_.reserve(surface_count + 1);
+	wait_semaphores_.reserve(surface_count + 1);
+	wait_values_.reserve(surface_count + 1);
+	present_swapchains_.reserve(surface_count);
+	present_image_indices_.reserve(surface_count);
+	present_results_.reserve(surface_count);
+}
+
+void draw_manager::wait_for_compute(uint64_t value, VkPipelineStageFlags stages) noexcept {
+	compute_wait_ = std::max(compute_wait_, value);
+	compute_wait_stages_ |= stages;
 }
 
 void draw_manager::draw_frame() {
-	vkWaitForFences(engine_->device_manager()->logical_device(), 1, &inflight_fence_, VK_TRUE, UINT64_MAX);
-	vkResetFences(engine_->device_manager()->logical_device(), 1, &inflight_fence_);
+	auto surface_manager = engine_->surface_manager();
+	presentable_.resize(surface_manager->surface_count());
+	for (size_t surface = 0; surface < presentable_.size(); ++surface) {
+		presentable_[surface] = surface_manager->presentable(surface);
+	}
+	draw_frame(presentable_);
+}
+
+void draw_manager::draw_frame(const std::vector<bool>& presentable) {
+	PG_GODS_VIEW_PROFILE_SCOPE("draw_frame");
+	const auto& vk = engine_->device_manager()->dispatch();
+	engine_->frame_counters()->begin_frame();
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("wait frame fence");
+		vk.wait_for_fences(engine_->device_manager()->logical_device(), 1, &inflight_fence_, VK_TRUE, UINT64_MAX);
+	}
+	completed_frames_ = submitted_frames_;
+	engine_->resolution_scaler()->update();
+	engine_->descriptor_allocator()->begin_frame();
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("stream updates");
+		engine_->capture_manager()->update();
+		engine_->texture_manager()->update();
+		engine_->mesh_manager()->update();
+	}
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("frame jobs");
+		engine_->job_system()->run(frame_jobs_);
+	}
+	frame_jobs_.clear();
+	// after the frame jobs so whatever they animated lands in this frame.
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("transforms");
+		engine_->transform_manager()->update();
+	}
+	engine_->overlay_renderer()->upload();
+	engine_->point_cloud_renderer()->upload();
+	engine_->post_processor()->update();
+
+	auto surface_manager = engine_->surface_manager();
+	frame_targets_.clear();
+	wait_semaphores_.clear();
+	wait_stages_.clear();
+	wait_values_.clear();
+	present_swapchains_.clear();
+	present_image_indices_.clear();
+	bool resized{false};
+	for (size_t surface = 0; surface < std::min(presentable.size(), surface_manager->surface_count()); ++surface) {
+		if (!presentable[surface]) { continue; }
+		PG_GODS_VIEW_PROFILE_SCOPE("acquire image");
+		if (out_of_date_[surface]) {
+			recreate_swap_chain(surface);
+			resized = true;
+		}
+		uint32_t image_index;
+		auto result = acquire_image(surface, image_index);
+		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+			recreate_swap_chain(surface);
+			resized = true;
+			result = acquire_image(surface, image_index);
+		}
+		if (result == VK_SUBOPTIMAL_KHR) {
+			// still presentable, it's replaced before the window's next acquire.
+			out_of_date_[surface] = true;
+		} else if (result != VK_SUCCESS) {
+			// a window whose swap chain can't hand out an image sits this frame out, the others still draw.
+			out_of_date_[surface] = result == VK_ERROR_OUT_OF_DATE_KHR;
+			continue;
+		}
+		frame_targets_.push_back({surface, image_index});
+		wait_semaphores_.push_back(image_available_semaphores_[surface]);
+		wait_stages_.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		wait_values_.push_back(0);
+		present_swapchains_.push_back(surface_manager->swapchain(surface));
+		present_image_indices_.push_back(image_index);
+	}
+	if (frame_targets_.empty()) {
+		// nothing was submitted, but the frame still ends so the counters' frames stay paired.
+		engine_->frame_counters()->end_frame(streaming() || resized);
+		return;
+	}
+	// closes the frame's records, everything reported since the last drawn frame belongs to it.
+	engine_->trace_recorder()->frame();
+	vk.reset_fences(engine_->device_manager()->logical_device(), 1, &inflight_fence_);
 
-	uint32_t image_index;
-	vkAcquireNextImageKHR(
-		engine_->device_manager()->logical_device(),
-		engine_->surface_manager()->swapchain(),
-		UINT64_MAX,
-		image_available_semaphore_,
-		VK_NULL_HANDLE,
-		&image_index
-	);
 	auto command_buffer = engine_->command_manager()->command_buffer();
-	vkResetCommandBuffer(command_buffer, 0);
-	engine_->command_manager()->record_command_buffer(command_buffer, image_index);
+	vk.reset_command_buffer(command_buffer, 0);
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("record commands");
+		engine_->command_manager()->record_command_buffer(command_buffer, frame_targets_);
+	}
+
+	// async work recorded for this frame goes out first so it runs beside the render passes.
+	engine_->compute_manager()->flush();
+	if (compute_wait_ != 0) {
+		wait_semaphores_.push_back(engine_->compute_manager()->timeline());
+		wait_stages_.push_back(compute_wait_stages_);
+		wait_values_.push_back(compute_wait_);
+		compute_wait_ = 0;
+		compute_wait_stages_ = 0;
+	}
+
+	// binary semaphores ignore their entries in the value arrays.
+	const uint64_t frame = submitted_frames_ + 1;
+	const uint64_t signal_values[] = {0, frame};
+	VkTimelineSemaphoreSubmitInfo timeline_submit_info{};
+	timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timeline_submit_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values_.size());
+	timeline_submit_info.pWaitSemaphoreValues = wait_values_.data();
+	timeline_submit_info.signalSemaphoreValueCount = 2;
+	timeline_submit_info.pSignalSemaphoreValues = signal_values;
 
 	VkSubmitInfo submit_info{};
 	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	VkSemaphore wait_semaphores[] = {image_available_semaphore_};
-	VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-	submit_info.waitSemaphoreCount = 1;
-	submit_info.pWaitSemaphores = wait_semaphores;
-	submit_info.pWaitDstStageMask = wait_stages;
+	submit_info.pNext = &timeline_submit_info;
+	submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores_.size());
+	submit_info.pWaitSemaphores = wait_semaphores_.data();
+	submit_info.pWaitDstStageMask = wait_stages_.data();
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers = &command_buffer;
 
-	VkSemaphore signal_semaphores[] = {render_finished_semaphore_};
-	submit_info.signalSemaphoreCount = 1;
+	VkSemaphore signal_semaphores[] = {render_finished_semaphore_, graphics_timeline_};
+	submit_info.signalSemaphoreCount = 2;
 	submit_info.pSignalSemaphores = signal_semaphores;
 
-	if (vkQueueSubmit(engine_->device_manager()->graphics_queue(), 1, &submit_info, inflight_fence_) != VK_SUCCESS) {
-		throw std::runtime_error{"Failed to submit draw command buffer"};
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("submit");
+		if (vk.queue_submit(engine_->device_manager()->graphics_queue(), 1, &submit_info, inflight_fence_) != VK_SUCCESS) {
+			throw std::runtime_error{"Failed to submit draw command buffer"};
+		}
 	}
+	++submitted_frames_;
 
 	VkPresentInfoKHR present_info{};
 	present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	present_info.waitSemaphoreCount = 1;
 	present_info.pWaitSemaphores = signal_semaphores;
-	VkSwapchainKHR swapchains[] = {engine_->surface_manager()->swapchain()};
-	present_info.swapchainCount = 1;
-	present_info.pSwapchains = swapchains;
-	present_info.pImageIndices = &image_index;
-	vkQueuePresentKHR(engine_->device_manager()->present_queue(), &present_info);
+	present_info.swapchainCount = static_cast<uint32_t>(present_swapchains_.size());
+	present_info.pSwapchains = present_swapchains_.data();
+	present_info.pImageIndices = present_image_indices_.data();
+	present_results_.resize(present_swapchains_.size());
+	present_info.pResults = present_results_.data();
+	PG_GODS_VIEW_PROFILE_SCOPE("present");
+	const auto present_result = vk.queue_present_khr(engine_->device_manager()->present_queue(), &present_info);
+	if (present_result != VK_SUCCESS && present_result != VK_SUBOPTIMAL_KHR && present_result != VK_ERROR_OUT_OF_DATE_KHR) {
+		throw std::runtime_error{"Failed to present swap chain image"};
+	}
+	// each window's own result says which swap chains to replace, the call's is only the worst of them.
+	for (size_t i = 0; i < frame_targets_.size(); ++i) {
+		if (present_results_[i] == VK_SUBOPTIMAL_KHR || present_results_[i] == VK_ERROR_OUT_OF_DATE_KHR) {
+			out_of_date_[frame_targets_[i].surface_index] = true;
+		}
+	}
+	engine_->frame_counters()->end_frame(streaming() || resized);
 }
 
-} // end namespace pg::gods_view
\ No newline at end of file
+} // end namespace pg::gods_view
@@ -2,8 +2,13 @@
 #define PG_GODS_VIEW_DRAW_MANAGER_HEADER_INCLUDED
 #pragma once
 
+#include "gods_view/job_system.h"
+#include "gods_view/surface_manager.h"
+
 #include <vulkan/vulkan.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace pg::gods_view {
@@ -13,23 +18,74 @@ class vulkan_engine;
 class draw_manager {
 private:
 	gods_view::vulkan_engine* engine_;
-	std::vector<VkFramebuffer> swap_chain_framebuffers_;
-	VkSemaphore image_available_semaphore_;
+	std::vector<std::vector<VkFramebuffer>> swap_chain_framebuffers_;
+	std::vector<VkSemaphore> image_available_semaphores_;
 	VkSemaphore render_finished_semaphore_;
 	VkFence inflight_fence_;
+	// signalled with each frame's number once its gpu work is done, for other queues to wait on.
+	VkSemaphore graphics_timeline_;
+	uint64_t compute_wait_;
+	VkPipelineStageFlags compute_wait_stages_;
+	gods_view::job_graph frame_jobs_;
+	uint64_t submitted_frames_;
+	uint64_t completed_frames_;
+	// per frame scratch, reused so a frame allocates nothing.
+	std::vector<frame_target> frame_targets_;
+	std::vector<VkSemaphore> wait_semaphores_;
+	std::vector<VkPipelineStageFlags> wait_stages_;
+	std::vector<uint64_t> wait_values_;
+	std::vector<VkSwapchainKHR> present_swapchains_;
+	std::vector<uint32_t> present_image_indices_;
+	std::vector<VkResult> present_results_;
+	std::vector<bool> presentable_;
+	// windows whose swap chain reported out of date or suboptimal, replaced before their next acquire.
+	std::vector<bool> out_of_date_;
 
 public:	
 	draw_manager(gods_view::vulkan_engine* init_engine);
 
 	~draw_manager();
 
-	[[nodiscard]] const std::vector<VkFramebuffer>& swap_chain_framebuffers() const noexcept { return swap_chain_framebuffers_; }
+	[[nodiscard]] const std::vector<VkFramebuffer>& swap_chain_framebuffers(size_t surface_index = 0) const noexcept { return swap_chain_framebuffers_[surface_index]; }
+
+	// cpu work for the next frame such as culling and transform updates. it runs on the job
+	// system once the previous frame's fence has signalled, before recording, and is cleared after.
+	[[nodiscard]] gods_view::job_graph& frame_jobs() noexcept { return frame_jobs_; }
+
+	// frames handed to the graphics queue so far.
+	[[nodiscard]] uint64_t submitted_frames() const noexcept { return submitted_frames_; }
+
+	// frames whose fence has been seen signalled, their gpu work is finished.
+	[[nodiscard]] uint64_t completed_frames() const noexcept { return completed_frames_; }
+
+	[[nodiscard]] VkSemaphore graphics_timeline() const noexcept { return graphics_timeline_; }
+
+	// the next frame's `stages` wait for the compute timeline to reach `value`, stages before
+	// them still overlap the compute work.
+	void wait_for_compute(uint64_t value, VkPipelineStageFlags stages) noexcept;
 
+	// both only create what surfaces added since the last call are missing.
 	void create_framebuffers();
 
 	void create_sync_objects();
 
+	// renders every window in one submission and presents all of them with one vkQueuePresentKHR.
 	void draw_frame();
+
+	// same, with each window's presentability already known. glfw may only be asked from the
+	// thread that pumps events, so this is what the render thread calls.
+	void draw_frame(const std::vector<bool>& presentable);
+
+private:
+	[[nodiscard]] std::vector<VkFramebuffer> create_framebuffers(size_t surface_index);
+
+	// a new swap chain for the window at its current size, with everything sized after it.
+	void recreate_swap_chain(size_t surface_index);
+
+	VkResult acquire_image(size_t surface_index, uint32_t& image_index);
+
+	// whether textures, meshes or captures are still in flight, see `frame_counters::end_frame`.
+	[[nodiscard]] bool streaming() const;
 };
 
 } // end namespace pg::gods_view
@@ -0,0 +1,81 @@
+#include "gods_view/frame_counters.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace pg::gods_view {
+
+namespace details {
+
+static frame_counts read_frame_totals() noexcept {
+	frame_counts totals{};
+	totals.allocations = allocation_total.load(std::memory_order_relaxed);
+	totals.allocated_bytes = allocated_bytes_total.load(std::memory_order_relaxed);
+	for (const auto& calls : device_call_totals) {
+		totals.vulkan_calls += calls.load(std::memory_order_relaxed);
+	}
+	totals.barriers = device_call_totals[static_cast<size_t>(device_call_kind::barrier)].load(std::memory_order_relaxed);
+	totals.binds = device_call_totals[static_cast<size_t>(device_call_kind::bind)].load(std::memory_order_relaxed);
+	totals.draws = device_call_totals[static_cast<size_t>(device_call_kind::draw)].load(std::memory_order_relaxed);
+	totals.dispatches = device_call_totals[static_cast<size_t>(device_call_kind::dispatch)].load(std::memory_order_relaxed);
+	totals.submits = device_call_totals[static_cast<size_t>(device_call_kind::submit)].load(std::memory_order_relaxed);
+	return totals;
+}
+
+} // end namespace pg::gods_view::details
+
+frame_counters::frame_counters() :
+	begin_{},
+	last_{},
+	total_{},
+	frames_{0},
+	check_allocations_{false},
+	warmup_frames_{details::default_allocation_warmup_frames},
+	steady_frames_{0}
+{ }
+
+void frame_counters::zero_allocation_check(bool enabled, uint32_t warmup_frames) {
+	if (enabled && !details::allocation_hook_installed.load()) {
+		throw std::runtime_error{"Zero allocation check needs gods_view/allocation_hook.h in the program"};
+	}
+	check_allocations_ = enabled;
+	warmup_frames_ = warmup_frames;
+	steady_frames_ = 0;
+}
+
+void frame_counters::begin_frame() noexcept {
+	begin_ = details::read_frame_totals();
+}
+
+void frame_counters::end_frame(bool streaming) {
+	const auto end = details::read_frame_totals();
+	last_ = {
+		end.allocations - begin_.allocations,
+		end.allocated_bytes - begin_.allocated_bytes,
+		end.vulkan_calls - begin_.vulkan_calls,
+		end.barriers - begin_.barriers,
+		end.binds - begin_.binds,
+		end.draws - begin_.draws,
+		end.dispatches - begin_.dispatches,
+		end.submits - begin_.submits
+	};
+	total_.allocations += last_.allocations;
+	total_.allocated_bytes += last_.allocated_bytes;
+	total_.vulkan_calls += last_.vulkan_calls;
+	total_.barriers += last_.barriers;
+	total_.binds += last_.binds;
+	total_.draws += last_.draws;
+	total_.dispatches += last_.dispatches;
+	total_.submits += last_.submits;
+	++frames_;
+
+	steady_frames_ = streaming ? 0 : steady_frames_ + 1;
+	if (check_allocations_ && steady_frames_ > warmup_frames_ && last_.allocations != 0) {
+		throw std::runtime_error{
+			"Steady state frame " + std::to_string(frames_) + " allocated " + std::to_string(last_.allocations) +
+			" times (" + std::to_string(last_.allocated_bytes) + " bytes)"
+		};
+	}
+}
+
+} // end namespace pg::gods_view
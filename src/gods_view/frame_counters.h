@@ -0,0 +1,115 @@
+#if !defined PG_GODS_VIEW_FRAME_COUNTERS_HEADER_INCLUDED
+#define PG_GODS_VIEW_FRAME_COUNTERS_HEADER_INCLUDED
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// device call counting is compiled into debug builds, release builds opt in by defining PG_GODS_VIEW_COUNTERS.
+#if !defined PG_GODS_VIEW_COUNTERS && !defined NDEBUG
+#define PG_GODS_VIEW_COUNTERS
+#endif
+
+namespace pg::gods_view {
+
+struct frame_counts {
+	// heap allocations on any thread, zero unless the program includes `allocation_hook.h`.
+	uint64_t allocations;
+	uint64_t allocated_bytes;
+	// device level commands through the dispatch table, zero unless PG_GODS_VIEW_COUNTERS is defined.
+	uint64_t vulkan_calls;
+	uint64_t barriers;
+	uint64_t binds;
+	uint64_t draws;
+	uint64_t dispatches;
+	uint64_t submits;
+};
+
+namespace details {
+
+enum class device_call_kind : uint32_t {
+	other = 0,
+	barrier = 1,
+	bind = 2,
+	draw = 3,
+	dispatch = 4,
+	submit = 5
+};
+
+constexpr std::size_t device_call_kinds = 6;
+// frames without streaming work a `zero_allocation_check` lets by before it starts judging.
+constexpr uint32_t default_allocation_warmup_frames = 8;
+
+[[nodiscard]] constexpr device_call_kind classify_device_call(std::string_view function) noexcept {
+	if (function == "vkCmdPipelineBarrier") { return device_call_kind::barrier; }
+	if (function.substr(0, 9) == "vkCmdBind") { return device_call_kind::bind; }
+	if (function.substr(0, 9) == "vkCmdDraw") { return device_call_kind::draw; }
+	if (function.substr(0, 13) == "vkCmdDispatch") { return device_call_kind::dispatch; }
+	if (function == "vkQueueSubmit") { return device_call_kind::submit; }
+	return device_call_kind::other;
+}
+
+// running totals since the program started, bumped with relaxed increments from any thread.
+inline std::array<std::atomic<uint64_t>, device_call_kinds> device_call_totals{};
+inline std::atomic<uint64_t> allocation_total{0};
+inline std::atomic<uint64_t> allocated_bytes_total{0};
+inline std::atomic<bool> allocation_hook_installed{false};
+
+inline void count_device_call(device_call_kind kind) noexcept {
+	device_call_totals[static_cast<std::size_t>(kind)].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void count_allocation(std::size_t size) noexcept {
+	allocation_total.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes_total.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // end namespace pg::gods_view::details
+
+// what each `draw_frame` cost, measured from its start to its present. the totals are
+// program wide, so whatever other threads do meanwhile is counted too; with a render thread
+// that includes the event thread building the next packet. used from the thread that draws.
+class frame_counters {
+private:
+	frame_counts begin_;
+	frame_counts last_;
+	frame_counts total_;
+	uint64_t frames_;
+	bool check_allocations_;
+	uint32_t warmup_frames_;
+	// frames in a row without streaming work, the check starts once this reaches the warmup.
+	uint32_t steady_frames_;
+
+public:
+	frame_counters();
+
+	frame_counters(const frame_counters&) = delete;
+
+	frame_counters& operator=(const frame_counters&) = delete;
+
+	// the last drawn frame's counts.
+	[[nodiscard]] const frame_counts& last_frame() const noexcept { return last_; }
+
+	// summed over every drawn frame, divide by `frames` for the averages.
+	[[nodiscard]] const frame_counts& total() const noexcept { return total_; }
+
+	[[nodiscard]] uint64_t frames() const noexcept { return frames_; }
+
+	// makes `end_frame` throw once a frame allocates after `warmup_frames` frames in a row
+	// without streaming. needs `allocation_hook.h` in the program, or nothing is counted.
+	void zero_allocation_check(bool enabled, uint32_t warmup_frames = details::default_allocation_warmup_frames);
+
+	// called by the draw manager around each frame it submits.
+	void begin_frame() noexcept;
+
+	// `streaming` is whether textures, meshes or captures are still in flight, those frames
+	// are allowed to allocate.
+	void end_frame(bool streaming);
+};
+
+} // end namespace pg::gods_view
+
+#endif
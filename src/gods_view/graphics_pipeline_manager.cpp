@@ -1,12 +1,22 @@
 #include "gods_view/graphics_pipeline_manager.h"
+#include "gods_view/shader_reflection.h"
 #include "gods_view/vulkan_engine.h"
 
 #include <fstream>
+#include <utility>
 
 namespace pg::gods_view {
 
 graphics_pipeline_manager::graphics_pipeline_manager(gods_view::vulkan_engine* init_engine) :
-	engine_{init_engine}
+	engine_{init_engine},
+	render_pass_{VK_NULL_HANDLE},
+	pipeline_layout_{VK_NULL_HANDLE},
+	vertex_shader_module_{VK_NULL_HANDLE},
+	fragment_shader_module_{VK_NULL_HANDLE},
+	mesh_pipeline_layout_{VK_NULL_HANDLE},
+	mesh_vertex_shader_module_{VK_NULL_HANDLE},
+	mesh_fragment_shader_module_{VK_NULL_HANDLE},
+	graphics_pipeline_{VK_NULL_HANDLE}
 { }
 
 graphics_pipeline_manager::~graphics_pipeline_manager() {
@@ -14,32 +24,150 @@ graphics_pipeline_manager::~graphics_pipeline_manager() {
 }
 
 void graphics_pipeline_manager::create_graphics_pipeline() {
-	auto vertex_shader_module = shader_module(read_shader("shaders/vert.spv"));
-	auto fragment_shader_module = shader_module(read_shader("shaders/frag.spv"));
+	const auto vertex_shader = read_shader("shaders/vert.spv");
+	const auto fragment_shader = read_shader("shaders/frag.spv");
+	const std::vector<shader_reflection> reflections{reflect_shader(vertex_shader), reflect_shader(fragment_shader)};
+	// kept for pipelines built later for other states.
+	vertex_shader_module_ = shader_module(vertex_shader);
+	fragment_shader_module_ = shader_module(fragment_shader);
+	vertex_input_ = reflect_vertex_input(reflections.front());
+
+	auto layout_info = engine_->layout_cache()->pipeline_layout(reflections);
+	pipeline_layout_ = layout_info.layout;
+	descriptor_set_layouts_ = std::move(layout_info.set_layouts);
+
+	const auto mesh_vertex_shader = read_shader("shaders/mesh_vert.spv");
+	const auto mesh_fragment_shader = read_shader("shaders/mesh_frag.spv");
+	const std::vector<shader_reflection> mesh_reflections{reflect_shader(mesh_vertex_shader), reflect_shader(mesh_fragment_shader)};
+	mesh_vertex_shader_module_ = shader_module(mesh_vertex_shader);
+	mesh_fragment_shader_module_ = shader_module(mesh_fragment_shader);
+	mesh_pipeline_layout_ = engine_->layout_cache()->pipeline_layout(mesh_reflections).layout;
+	// reflection only sees the floats the shader reads, not how the stream packs them.
+	const auto packed_attributes = packed_vertex::attribute_descriptions();
+	mesh_vertex_input_.bindings = {packed_vertex::binding_description()};
+	mesh_vertex_input_.attributes.assign(packed_attributes.begin(), packed_attributes.end());
+	if (reflect_vertex_input(mesh_reflections.front()).attributes.size() != mesh_vertex_input_.attributes.size()) {
+		throw std::runtime_error{"Mesh shader inputs don't match the packed vertex layout"};
+	}
+
+	graphics_pipeline_ = pipeline(pipeline_state{});
+}
+
+VkPipeline graphics_pipeline_manager::pipeline(const pipeline_state& state, const specialization_info& variant) {
+	return pipelines_.get<0>(pipeline_handle_for(state, variant));
+}
+
+pipeline_handle graphics_pipeline_manager::pipeline_handle_for(const pipeline_state& state, const specialization_info& variant) {
+	return pipeline_handle_for(state, variant, pipeline_program::scene);
+}
+
+VkPipeline graphics_pipeline_manager::mesh_pipeline(const pipeline_state& state, const specialization_info& variant) {
+	return pipelines_.get<0>(pipeline_handle_for(state, variant, pipeline_program::packed_mesh));
+}
+
+pipeline_handle graphics_pipeline_manager::pipeline_handle_for(const pipeline_state& state, const specialization_info& variant, pipeline_program program) {
+	auto key = details::make_pipeline_key(state, engine_->device_manager()->dynamic_state_support());
+	key.variant[0] = static_cast<uint32_t>(variant.key);
+	key.variant[1] = static_cast<uint32_t>(variant.key >> 32);
+	key.program = static_cast<uint32_t>(program);
+	auto& entries = pipeline_handles_[key];
+	for (const auto& entry : entries) {
+		if (entry.constants.matches(variant)) { return entry.handle; }
+	}
+	// traces only carry scene pipelines, mesh ones are built again when the mesh is drawn.
+	if (program == pipeline_program::scene) {
+		engine_->trace_recorder()->pipeline(state, variant);
+	}
+	const auto result = pipelines_.create(create_pipeline(state, variant, program));
+	entries.push_back({specialization_constants{variant}, result});
+	return result;
+}
+
+void graphics_pipeline_manager::bind(VkCommandBuffer command_buffer, const pipeline_state& state, const specialization_info& variant) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline(state, variant));
+	set_dynamic_state(command_buffer, state);
+}
+
+void graphics_pipeline_manager::bind_mesh(VkCommandBuffer command_buffer, const pipeline_state& state, const specialization_info& variant) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mesh_pipeline(state, variant));
+	set_dynamic_state(command_buffer, state);
+}
+
+void graphics_pipeline_manager::set_dynamic_state(VkCommandBuffer command_buffer, const pipeline_state& state) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const auto& support = engine_->device_manager()->dynamic_state_support();
+	if (support.extended) {
+		vk.cmd_set_cull_mode(command_buffer, state.cull_mode);
+		vk.cmd_set_front_face(command_buffer, state.front_face);
+		vk.cmd_set_primitive_topology(command_buffer, state.topology);
+		vk.cmd_set_depth_test_enable(command_buffer, state.depth_test ? VK_TRUE : VK_FALSE);
+		vk.cmd_set_depth_write_enable(command_buffer, state.depth_write ? VK_TRUE : VK_FALSE);
+		vk.cmd_set_depth_compare_op(command_buffer, state.depth_compare);
+	}
+	if (support.extended2) {
+		vk.cmd_set_primitive_restart_enable(command_buffer, state.primitive_restart ? VK_TRUE : VK_FALSE);
+		vk.cmd_set_depth_bias_enable(command_buffer, state.depth_bias ? VK_TRUE : VK_FALSE);
+	}
+	if (support.polygon_mode) {
+		vk.cmd_set_polygon_mode(command_buffer, state.polygon_mode);
+	}
+	if (support.color_blend_enable) {
+		const VkBool32 blend = state.blend ? VK_TRUE : VK_FALSE;
+		vk.cmd_set_color_blend_enable(command_buffer, 0, 1, &blend);
+	}
+	if (support.color_blend_equation) {
+		const VkColorBlendEquationEXT equation{
+			state.src_color_factor,
+			state.dst_color_factor,
+			state.color_op,
+			state.src_alpha_factor,
+			state.dst_alpha_factor,
+			state.alpha_op
+		};
+		vk.cmd_set_color_blend_equation(command_buffer, 0, 1, &equation);
+	}
+	if (support.color_write_mask) {
+		vk.cmd_set_color_write_mask(command_buffer, 0, 1, &state.color_write_mask);
+	}
+}
+
+VkPipeline graphics_pipeline_manager::create_pipeline(const pipeline_state& state, const specialization_info& variant, pipeline_program program) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const bool mesh = program == pipeline_program::packed_mesh;
+	const auto& vertex_input = mesh ? mesh_vertex_input_ : vertex_input_;
+	// one set of constants for both stages, each only picks up the ids it declares.
+	const VkSpecializationInfo* specialization = variant.info.mapEntryCount != 0 ? &variant.info : nullptr;
 
 	VkPipelineShaderStageCreateInfo vertex_shader_stage_info{};
 	vertex_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	vertex_shader_stage_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertex_shader_stage_info.module = vertex_shader_module;
+	vertex_shader_stage_info.module = mesh ? mesh_vertex_shader_module_ : vertex_shader_module_;
 	vertex_shader_stage_info.pName = "main";
+	vertex_shader_stage_info.pSpecializationInfo = specialization;
 
 	VkPipelineShaderStageCreateInfo fragment_shader_stage_info{};
 	fragment_shader_stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	fragment_shader_stage_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragment_shader_stage_info.module = fragment_shader_module;
+	fragment_shader_stage_info.module = mesh ? mesh_fragment_shader_module_ : fragment_shader_module_;
 	fragment_shader_stage_info.pName = "main";
+	fragment_shader_stage_info.pSpecializationInfo = specialization;
 
 	VkPipelineShaderStageCreateInfo shader_stages[] = {vertex_shader_stage_info, fragment_shader_stage_info};
 
 	VkPipelineVertexInputStateCreateInfo vertex_input_info{};
 	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertex_input_info.vertexBindingDescriptionCount = 0;
-	vertex_input_info.vertexAttributeDescriptionCount = 0;
+	vertex_input_info.vertexBindingDescriptionCount = static_cast<uint32_t>(vertex_input.bindings.size());
+	vertex_input_info.pVertexBindingDescriptions = vertex_input.bindings.data();
+	vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertex_input.attributes.size());
+	vertex_input_info.pVertexAttributeDescriptions = vertex_input.attributes.data();
 
+	// values that are dynamic on this device are placeholders, `bind` sets the real ones.
 	VkPipelineInputAssemblyStateCreateInfo input_assembly{};
 	input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-	input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-	input_assembly.primitiveRestartEnable = VK_FALSE;
+	input_assembly.topology = state.topology;
+	input_assembly.primitiveRestartEnable = state.primitive_restart ? VK_TRUE : VK_FALSE;
 
 	VkPipelineViewportStateCreateInfo viewport_state{};
 	viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -50,20 +178,32 @@ void graphics_pipeline_manager::create_graphics_pipeline() {
 	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
 	rasterizer.depthClampEnable = VK_FALSE;
 	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.polygonMode = state.polygon_mode;
 	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-	rasterizer.depthBiasEnable = VK_FALSE;
+	rasterizer.cullMode = state.cull_mode;
+	rasterizer.frontFace = state.front_face;
+	rasterizer.depthBiasEnable = state.depth_bias ? VK_TRUE : VK_FALSE;
 
 	VkPipelineMultisampleStateCreateInfo multisampling{};
 	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 	multisampling.sampleShadingEnable = VK_FALSE;
 	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
+	VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+	depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil.depthTestEnable = state.depth_test ? VK_TRUE : VK_FALSE;
+	depth_stencil.depthWriteEnable = state.depth_write ? VK_TRUE : VK_FALSE;
+	depth_stencil.depthCompareOp = state.depth_compare;
+
 	VkPipelineColorBlendAttachmentState color_blend_attachment{};
-	color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	color_blend_attachment.blendEnable = VK_FALSE;
+	color_blend_attachment.colorWriteMask = state.color_write_mask;
+	color_blend_attachment.blendEnable = state.blend ? VK_TRUE : VK_FALSE;
+	color_blend_attachment.srcColorBlendFactor = state.src_color_factor;
+	color_blend_attachment.dstColorBlendFactor = state.dst_color_factor;
+	color_blend_attachment.colorBlendOp = state.color_op;
+	color_blend_attachment.srcAlphaBlendFactor = state.src_alpha_factor;
+	color_blend_attachment.dstAlphaBlendFactor = state.dst_alpha_factor;
+	color_blend_attachment.alphaBlendOp = state.alpha_op;
 
 	VkPipelineColorBlendStateCreateInfo color_blending{};
 	color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -76,25 +216,44 @@ void graphics_pipeline_manager::create_graphics_pipeline() {
 	color_blending.blendConstants[2] = 0.0f;
 	color_blending.blendConstants[3] = 0.0f;
 
+	const auto& support = engine_->device_manager()->dynamic_state_support();
 	std::vector<VkDynamicState> dynamic_states {
 		VK_DYNAMIC_STATE_VIEWPORT,
 		VK_DYNAMIC_STATE_SCISSOR
 	};
+	if (support.extended) {
+		dynamic_states.insert(dynamic_states.end(), {
+			VK_DYNAMIC_STATE_CULL_MODE_EXT,
+			VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+			VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+			VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+			VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+			VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT
+		});
+	}
+	if (support.extended2) {
+		dynamic_states.insert(dynamic_states.end(), {
+			VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT,
+			VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT
+		});
+	}
+	if (support.polygon_mode) {
+		dynamic_states.push_back(VK_DYNAMIC_STATE_POLYGON_MODE_EXT);
+	}
+	if (support.color_blend_enable) {
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT);
+	}
+	if (support.color_blend_equation) {
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT);
+	}
+	if (support.color_write_mask) {
+		dynamic_states.push_back(VK_DYNAMIC_STATE_COLOR_WRITE_MASK_EXT);
+	}
 	VkPipelineDynamicStateCreateInfo dynamic_state{};
 	dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 	dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
 	dynamic_state.pDynamicStates = dynamic_states.data();
 
-	VkPipelineLayoutCreateInfo pipeline_layout_info{};
-	pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipeline_layout_info.setLayoutCount = 0;
-	pipeline_layout_info.pushConstantRangeCount = 0;
-
-	auto result = vkCreatePipelineLayout(engine_->device_manager()->logical_device(), &pipeline_layout_info, nullptr, &pipeline_layout_);
-	if (result != VK_SUCCESS) {
-		throw std::runtime_error{"Failed to crate pipeline layout"};
-	}
-
 	VkGraphicsPipelineCreateInfo pipeline_info{};
 	pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	pipeline_info.stageCount = 2;
@@ -104,21 +263,31 @@ void graphics_pipeline_manager::create_graphics_pipeline() {
 	pipeline_info.pViewportState = &viewport_state;
 	pipeline_info.pRasterizationState = &rasterizer;
 	pipeline_info.pMultisampleState = &multisampling;
+	pipeline_info.pDepthStencilState = &depth_stencil;
 	pipeline_info.pColorBlendState = &color_blending;
 	pipeline_info.pDynamicState = &dynamic_state;
-	pipeline_info.layout = pipeline_layout_;
+	pipeline_info.layout = mesh ? mesh_pipeline_layout_ : pipeline_layout_;
 	pipeline_info.renderPass = render_pass_;
 	pipeline_info.subpass = 0;
 	pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
-	if (vkCreateGraphicsPipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &graphics_pipeline_) != VK_SUCCESS) {
+	VkPipeline result;
+	if (vk.create_graphics_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &result) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create graphics pipeline"};
 	}
-
-	vkDestroyShaderModule(engine_->device_manager()->logical_device(), fragment_shader_module, nullptr);
-	vkDestroyShaderModule(engine_->device_manager()->logical_device(), vertex_shader_module, nullptr);
+	return result;
 }
 
 void graphics_pipeline_manager::create_render_pass() {
+	// the scene goes into subpass 0 either way, so the pipelines built against it don't change.
+	if (const auto post_processor = engine_->post_processor(); post_processor->enabled()) {
+		render_pass_ = post_processor->create_render_pass(
+			engine_->surface_manager()->swap_chain_image_format(),
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			VK_ATTACHMENT_LOAD_OP_CLEAR
+		);
+		return;
+	}
+	const auto& vk = engine_->device_manager()->dispatch();
 	VkAttachmentDescription color_attachment{};
 	color_attachment.format = engine_->surface_manager()->swap_chain_image_format();
 	color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -145,7 +314,7 @@ void graphics_pipeline_manager::create_render_pass() {
 	renderpass_info.subpassCount = 1;
 	renderpass_info.pSubpasses = &subpass;
 
-	if (vkCreateRenderPass(engine_->device_manager()->logical_device(), &renderpass_info, nullptr, &render_pass_) != VK_SUCCESS) {
+	if (vk.create_render_pass(engine_->device_manager()->logical_device(), &renderpass_info, nullptr, &render_pass_) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create render pass"};
 	}
 }
@@ -164,22 +333,34 @@ std::vector<char> graphics_pipeline_manager::read_shader(const std::string& file
 }
 
 VkShaderModule graphics_pipeline_manager::shader_module(const std::vector<char>& shader_bytecode) {
+	const auto& vk = engine_->device_manager()->dispatch();
 	VkShaderModuleCreateInfo create_info{};
 	create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 	create_info.codeSize = shader_bytecode.size();
 	create_info.pCode = reinterpret_cast<const uint32_t*>(shader_bytecode.data());
 
 	VkShaderModule shader_module;
-	if (vkCreateShaderModule(engine_->device_manager()->logical_device(), &create_info, nullptr, &shader_module) != VK_SUCCESS) {
+	if (vk.create_shader_module(engine_->device_manager()->logical_device(), &create_info, nullptr, &shader_module) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create shader module"};
 	}
 	return shader_module;
 }
 
 void graphics_pipeline_manager::destroy_pipeline() {
-	vkDestroyPipeline(engine_->device_manager()->logical_device(), graphics_pipeline_, nullptr);
-	vkDestroyPipelineLayout(engine_->device_manager()->logical_device(), pipeline_layout_, nullptr);
-	vkDestroyRenderPass(engine_->device_manager()->logical_device(), render_pass_, nullptr);
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (const auto& [key, entries] : pipeline_handles_) {
+		for (const auto& entry : entries) {
+			vk.destroy_pipeline(device, pipelines_.get<0>(entry.handle), nullptr);
+			pipelines_.destroy(entry.handle);
+		}
+	}
+	pipeline_handles_.clear();
+	vk.destroy_shader_module(device, mesh_fragment_shader_module_, nullptr);
+	vk.destroy_shader_module(device, mesh_vertex_shader_module_, nullptr);
+	vk.destroy_shader_module(device, fragment_shader_module_, nullptr);
+	vk.destroy_shader_module(device, vertex_shader_module_, nullptr);
+	vk.destroy_render_pass(engine_->device_manager()->logical_device(), render_pass_, nullptr);
 }
 
 } // end namespace pg::gods_view
\ No newline at end of file
@@ -2,20 +2,52 @@
 #define PG_GODS_VIEW_GRAPHICS_PIPELINE_HEADER_INCLUDED
 #pragma once
 
+#include "gods_view/handle_pool.h"
+#include "gods_view/pipeline_state.h"
+#include "gods_view/shader_reflection.h"
+#include "gods_view/shader_variant.h"
+#include "gods_view/vertex.h"
+
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace pg::gods_view {
 
 class vulkan_engine;
 
+enum class pipeline_program : uint32_t {
+	// shaders/shader.vert and shader.frag, vertex input reflected from the shader.
+	scene = 0,
+	// shaders/mesh.vert and mesh.frag over the `packed_vertex` layout.
+	packed_mesh = 1
+};
+
 class graphics_pipeline_manager {
 private:	
+	struct pipeline_entry {
+		specialization_constants constants;
+		pipeline_handle handle;
+	};
+
 	gods_view::vulkan_engine* engine_;
 	VkRenderPass render_pass_;
 	VkPipelineLayout pipeline_layout_;
+	std::vector<VkDescriptorSetLayout> descriptor_set_layouts_;
+	VkShaderModule vertex_shader_module_;
+	VkShaderModule fragment_shader_module_;
+	vertex_input_layout vertex_input_;
+	VkPipelineLayout mesh_pipeline_layout_;
+	VkShaderModule mesh_vertex_shader_module_;
+	VkShaderModule mesh_fragment_shader_module_;
+	vertex_input_layout mesh_vertex_input_;
+	// one pipeline per distinct baked state and shader variant, dynamic state never adds an entry.
+	// variants whose keys collide share a bucket.
+	std::unordered_map<pipeline_key, std::vector<pipeline_entry>, pipeline_key_hash> pipeline_handles_;
+	handle_pool<pipeline_handle, VkPipeline> pipelines_;
 	VkPipeline graphics_pipeline_;
 
 public:
@@ -25,8 +57,45 @@ public:
 
 	[[nodiscard]] VkRenderPass render_pass() const noexcept { return render_pass_; }
 
+	// the pipeline for a default `pipeline_state`.
 	[[nodiscard]] VkPipeline graphics_pipeline() const noexcept { return graphics_pipeline_; }
 
+	[[nodiscard]] size_t pipeline_count() const noexcept { return pipelines_.size(); }
+
+	// looks up or builds the pipeline for the baked part of `state`, specialized for `variant`.
+	VkPipeline pipeline(const pipeline_state& state, const specialization_info& variant = {});
+
+	// same, as a handle to keep in draw items; resolving it later skips hashing the state.
+	pipeline_handle pipeline_handle_for(const pipeline_state& state, const specialization_info& variant = {});
+
+	[[nodiscard]] VkPipeline pipeline(pipeline_handle id) const noexcept { return pipelines_.get<0>(id); }
+
+	template <typename... Constants>
+	VkPipeline pipeline(const pipeline_state& state, const shader_variant<Constants...>& variant) {
+		return pipeline(state, variant.specialization());
+	}
+
+	// binds the pipeline for `state` and sets the parts of it the device keeps dynamic.
+	void bind(VkCommandBuffer command_buffer, const pipeline_state& state, const specialization_info& variant = {});
+
+	template <typename... Constants>
+	void bind(VkCommandBuffer command_buffer, const pipeline_state& state, const shader_variant<Constants...>& variant) {
+		bind(command_buffer, state, variant.specialization());
+	}
+
+	// pipelines for meshes of `vertex_format::packed`. `mesh_manager::draw` pushes the bounds
+	// their positions decode with, the caller pushes the model view projection matrix.
+	VkPipeline mesh_pipeline(const pipeline_state& state, const specialization_info& variant = {});
+
+	void bind_mesh(VkCommandBuffer command_buffer, const pipeline_state& state, const specialization_info& variant = {});
+
+	// owned by the engine's layout cache, shared with every pipeline of the same interface.
+	[[nodiscard]] VkPipelineLayout pipeline_layout() const noexcept { return pipeline_layout_; }
+
+	[[nodiscard]] VkPipelineLayout mesh_pipeline_layout() const noexcept { return mesh_pipeline_layout_; }
+
+	[[nodiscard]] const std::vector<VkDescriptorSetLayout>& descriptor_set_layouts() const noexcept { return descriptor_set_layouts_; }
+
 	void create_graphics_pipeline();
 
 	void create_render_pass();
@@ -36,6 +105,13 @@ public:
 	VkShaderModule shader_module(const std::vector<char>& shader_bytecode);
 
 private:
+	pipeline_handle pipeline_handle_for(const pipeline_state& state, const specialization_info& variant, pipeline_program program);
+
+	// the parts of `state` the device keeps dynamic.
+	void set_dynamic_state(VkCommandBuffer command_buffer, const pipeline_state& state);
+
+	VkPipeline create_pipeline(const pipeline_state& state, const specialization_info& variant, pipeline_program program);
+
 	void destroy_pipeline();
 };
 
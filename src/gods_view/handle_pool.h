@@ -0,0 +1,164 @@
+#if !defined PG_GODS_VIEW_HANDLE_POOL_HEADER_INCLUDED
+#define PG_GODS_VIEW_HANDLE_POOL_HEADER_INCLUDED
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr uint32_t handle_index_bits = 24;
+constexpr uint32_t handle_index_mask = (1u << handle_index_bits) - 1;
+constexpr uint32_t handle_max_slots = 1u << handle_index_bits;
+constexpr uint32_t handle_generation_mask = (1u << (32 - handle_index_bits)) - 1;
+
+} // end namespace pg::gods_view::details
+
+// a slot index in the low 24 bits and the slot's generation in the high 8. generations
+// start at 1, so a zero handle never refers to anything. `Tag` keeps handles of different
+// pools from converting into each other.
+template <typename Tag>
+struct handle {
+	uint32_t value{0};
+
+	[[nodiscard]] constexpr uint32_t index() const noexcept { return value & details::handle_index_mask; }
+
+	[[nodiscard]] constexpr uint32_t generation() const noexcept { return value >> details::handle_index_bits; }
+
+	constexpr explicit operator bool() const noexcept { return value != 0; }
+
+	friend constexpr bool operator==(handle lhs, handle rhs) noexcept { return lhs.value == rhs.value; }
+
+	friend constexpr bool operator!=(handle lhs, handle rhs) noexcept { return lhs.value != rhs.value; }
+};
+
+using buffer_handle = handle<struct buffer_tag>;
+using image_handle = handle<struct image_tag>;
+using pipeline_handle = handle<struct pipeline_tag>;
+using mesh_handle = handle<struct mesh_tag>;
+
+// slots for `Handle`, each field in an array of its own so a pass over one field touches
+// nothing else. destroyed slots go on a free list and are reused before the arrays grow;
+// their generation moves on, which is all it takes to tell a stale handle from a live one.
+// a slot's generation wraps after 255 reuses, so a handle held that long past its
+// destruction could alias a newer one.
+template <typename Handle, typename... Columns>
+class handle_pool {
+	static_assert(sizeof...(Columns) > 0, "handle_pool needs at least one column");
+	static_assert((!std::is_same_v<Columns, bool> && ...), "handle_pool columns can't be bool, std::vector<bool> hands out no references");
+
+public:
+	using handle_type = Handle;
+
+private:
+	std::tuple<std::vector<Columns>...> columns_;
+	std::vector<uint8_t> generations_;
+	std::vector<uint8_t> live_;
+	std::vector<uint32_t> free_;
+	uint32_t size_;
+
+public:
+	handle_pool() :
+		size_{0}
+	{ }
+
+	[[nodiscard]] uint32_t size() const noexcept { return size_; }
+
+	// live and free slots, the bound for sweeping a column by index.
+	[[nodiscard]] uint32_t slot_count() const noexcept { return static_cast<uint32_t>(generations_.size()); }
+
+	void reserve(uint32_t slots) {
+		std::apply([slots](auto&... column) { (column.reserve(slots), ...); }, columns_);
+		generations_.reserve(slots);
+		live_.reserve(slots);
+	}
+
+	handle_type create(Columns... values) {
+		uint32_t index;
+		if (!free_.empty()) {
+			index = free_.back();
+			free_.pop_back();
+			assign(index, std::index_sequence_for<Columns...>{}, std::move(values)...);
+		} else {
+			if (generations_.size() == details::handle_max_slots) {
+				throw std::runtime_error{"Handle pool is full"};
+			}
+			index = static_cast<uint32_t>(generations_.size());
+			append(std::index_sequence_for<Columns...>{}, std::move(values)...);
+			generations_.push_back(1);
+			live_.push_back(0);
+		}
+		live_[index] = 1;
+		++size_;
+		return {index | (static_cast<uint32_t>(generations_[index]) << details::handle_index_bits)};
+	}
+
+	// false for a stale or empty handle, which leaves the pool as it was.
+	bool destroy(handle_type id) noexcept {
+		if (!valid(id)) { return false; }
+		const auto index = id.index();
+		live_[index] = 0;
+		generations_[index] = static_cast<uint8_t>(generations_[index] == details::handle_generation_mask ? 1 : generations_[index] + 1);
+		free_.push_back(index);
+		--size_;
+		return true;
+	}
+
+	[[nodiscard]] bool valid(handle_type id) const noexcept {
+		const auto index = id.index();
+		return id.value != 0 && index < generations_.size() && live_[index] != 0 && generations_[index] == id.generation();
+	}
+
+	[[nodiscard]] bool live(uint32_t index) const noexcept { return live_[index] != 0; }
+
+	// the handle currently naming a live slot.
+	[[nodiscard]] handle_type handle_at(uint32_t index) const noexcept {
+		return {index | (static_cast<uint32_t>(generations_[index]) << details::handle_index_bits)};
+	}
+
+	// unchecked, `valid` first where the handle may be stale.
+	template <std::size_t Column>
+	[[nodiscard]] auto& get(handle_type id) noexcept { return std::get<Column>(columns_)[id.index()]; }
+
+	template <std::size_t Column>
+	[[nodiscard]] const auto& get(handle_type id) const noexcept { return std::get<Column>(columns_)[id.index()]; }
+
+	// a whole field, indexed by slot. free slots keep whatever their last owner left.
+	template <std::size_t Column>
+	[[nodiscard]] auto& column() noexcept { return std::get<Column>(columns_); }
+
+	template <std::size_t Column>
+	[[nodiscard]] const auto& column() const noexcept { return std::get<Column>(columns_); }
+
+	// calls `visit(handle)` for every live slot in slot order.
+	template <typename Visitor>
+	void for_each(Visitor&& visit) const {
+		for (uint32_t index = 0; index < generations_.size(); ++index) {
+			if (live_[index] != 0) {
+				visit(handle_at(index));
+			}
+		}
+	}
+
+private:
+	template <std::size_t... I>
+	void assign(uint32_t index, std::index_sequence<I...>, Columns&&... values) {
+		((std::get<I>(columns_)[index] = std::move(values)), ...);
+	}
+
+	template <std::size_t... I>
+	void append(std::index_sequence<I...>, Columns&&... values) {
+		(std::get<I>(columns_).push_back(std::move(values)), ...);
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,307 @@
+#include "gods_view/job_system.h"
+
+#include <string>
+#include <system_error>
+
+namespace pg::gods_view {
+
+namespace details {
+
+static thread_local job_system* current_job_system{nullptr};
+static thread_local uint32_t current_job_worker{0};
+
+struct detached_job {
+	details::job job;
+	std::function<void()> task;
+};
+
+static details::job* make_detached_job(job_counter& counter, std::function<void()> task) {
+	counter.fetch_add(1, std::memory_order_relaxed);
+	auto* detached = new details::detached_job{};
+	detached->task = std::move(task);
+	detached->job.execute = [](details::job& self) {
+		std::unique_ptr<details::detached_job> owner{static_cast<details::detached_job*>(self.context)};
+		owner->task();
+	};
+	detached->job.context = detached;
+	detached->job.counter = &counter;
+	detached->job.dependents = nullptr;
+	return &detached->job;
+}
+
+} // end namespace pg::gods_view::details
+
+job_graph::job_graph() :
+	size_{0}
+{ }
+
+job_graph::job_handle job_graph::add(std::function<void()> task, std::initializer_list<job_handle> dependencies) {
+	if (size_ == nodes_.size()) {
+		nodes_.emplace_back();
+	}
+	auto& node = nodes_[size_];
+	node.task = std::move(task);
+	node.dependents.clear();
+	node.dependency_count = 0;
+	const auto handle = static_cast<job_handle>(size_++);
+	for (auto dependency : dependencies) {
+		depend(dependency, handle);
+	}
+	return handle;
+}
+
+void job_graph::depend(job_handle before, job_handle after) {
+	if (before >= size_ || after >= size_ || before == after) {
+		throw std::runtime_error{"Invalid job dependency"};
+	}
+	nodes_[before].dependents.push_back(&nodes_[after].job);
+	++nodes_[after].dependency_count;
+}
+
+void job_graph::clear() noexcept {
+	for (std::size_t i = 0; i < size_; ++i) {
+		// drop captured state now rather than when the node is reused.
+		nodes_[i].task = nullptr;
+	}
+	size_ = 0;
+}
+
+job_system::job_system() :
+	injected_jobs_{0},
+	background_jobs_{0},
+	failure_count_{0},
+	queued_jobs_{0},
+	sleeping_workers_{0},
+	stopping_{false}
+{ }
+
+job_system::~job_system() {
+	{
+		std::lock_guard<std::mutex> lock{sleep_mutex_};
+		stopping_.store(true);
+	}
+	sleep_cv_.notify_all();
+	for (auto& worker : workers_) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+	if (details::current_job_system == this) {
+		details::current_job_system = nullptr;
+	}
+}
+
+void job_system::initialize(uint32_t background_workers) {
+	if (!workers_.empty()) {
+		throw std::runtime_error{"Job system is already initialized"};
+	}
+	// every deque exists before any thread looks at its neighbours.
+	for (uint32_t i = 0; i <= background_workers; ++i) {
+		workers_.push_back(std::make_unique<worker>());
+	}
+	details::current_job_system = this;
+	details::current_job_worker = 0;
+	for (uint32_t i = 1; i <= background_workers; ++i) {
+		workers_[i]->thread = std::thread{[this, i]() { worker_loop(i); }};
+	}
+}
+
+void job_system::run(job_graph& graph) {
+	if (graph.empty()) { return; }
+	job_counter counter{static_cast<uint32_t>(graph.size())};
+	bool has_root{false};
+	for (std::size_t i = 0; i < graph.size(); ++i) {
+		auto& node = graph.nodes_[i];
+		node.job.execute = [](details::job& self) {
+			(*static_cast<std::function<void()>*>(self.context))();
+		};
+		node.job.context = &node.task;
+		node.job.counter = &counter;
+		node.job.dependents = &node.dependents;
+		node.job.pending_dependencies.store(node.dependency_count, std::memory_order_relaxed);
+		has_root = has_root || node.dependency_count == 0;
+	}
+	if (!has_root) {
+		throw std::runtime_error{"Job graph has no job without dependencies"};
+	}
+	for (std::size_t i = 0; i < graph.size(); ++i) {
+		if (graph.nodes_[i].dependency_count == 0) {
+			push(&graph.nodes_[i].job);
+		}
+	}
+	wait(counter);
+}
+
+void job_system::submit(job_counter& counter, std::function<void()> task) {
+	push(details::make_detached_job(counter, std::move(task)));
+}
+
+void job_system::submit_background(job_counter& counter, std::function<void()> task) {
+	if (workers_.size() <= 1) {
+		submit(counter, std::move(task));
+		return;
+	}
+	auto job = details::make_detached_job(counter, std::move(task));
+	{
+		std::lock_guard<std::mutex> lock{background_mutex_};
+		background_queue_.push_back(job);
+	}
+	background_jobs_.fetch_add(1);
+	if (sleeping_workers_.load() != 0) {
+		std::lock_guard<std::mutex> lock{sleep_mutex_};
+		sleep_cv_.notify_one();
+	}
+}
+
+void job_system::wait(const job_counter& counter) {
+	while (counter.load(std::memory_order_acquire) != 0) {
+		if (auto job = find_job(); job != nullptr) {
+			execute(job);
+		} else {
+			// what is left is running on other threads.
+			std::this_thread::yield();
+		}
+	}
+	rethrow_failure(counter);
+}
+
+void job_system::wait_background(const job_counter& counter) {
+	while (counter.load(std::memory_order_acquire) != 0) {
+		if (auto job = find_job(); job != nullptr) {
+			execute(job);
+		} else if (auto background = find_background_job(); background != nullptr) {
+			execute(background);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	rethrow_failure(counter);
+}
+
+void job_system::worker_loop(uint32_t index) {
+	details::current_job_system = this;
+	details::current_job_worker = index;
+	PG_GODS_VIEW_PROFILE_THREAD("job worker " + std::to_string(index));
+	uint32_t spins{0};
+	while (!stopping_.load(std::memory_order_relaxed)) {
+		if (auto job = find_job(); job != nullptr) {
+			execute(job);
+			spins = 0;
+			continue;
+		}
+		// background work only once nothing else is queued, a job it waits on inside is never one.
+		if (auto job = find_background_job(); job != nullptr) {
+			execute(job);
+			spins = 0;
+			continue;
+		}
+		if (++spins < details::job_spin_count) {
+			std::this_thread::yield();
+			continue;
+		}
+		spins = 0;
+		std::unique_lock<std::mutex> lock{sleep_mutex_};
+		sleeping_workers_.fetch_add(1);
+		sleep_cv_.wait(lock, [this]() {
+			return stopping_.load() || static_cast<int32_t>(queued_jobs_.load()) > 0 || background_jobs_.load() != 0;
+		});
+		sleeping_workers_.fetch_sub(1);
+	}
+}
+
+void job_system::push(details::job* job) {
+	bool pushed{false};
+	if (details::current_job_system == this) {
+		pushed = workers_[details::current_job_worker]->deque.push(job);
+	}
+	if (!pushed) {
+		std::lock_guard<std::mutex> lock{injection_mutex_};
+		injection_queue_.push_back(job);
+		injected_jobs_.fetch_add(1, std::memory_order_release);
+	}
+	// pairs with the sleeper raising `sleeping_workers_` before it checks `queued_jobs_`.
+	queued_jobs_.fetch_add(1);
+	if (sleeping_workers_.load() != 0) {
+		std::lock_guard<std::mutex> lock{sleep_mutex_};
+		sleep_cv_.notify_one();
+	}
+}
+
+details::job* job_system::find_job() {
+	const bool is_worker = details::current_job_system == this;
+	const auto self = details::current_job_worker;
+	details::job* job{nullptr};
+	if (is_worker) {
+		job = workers_[self]->deque.pop();
+	}
+	if (job == nullptr && injected_jobs_.load(std::memory_order_acquire) != 0) {
+		std::lock_guard<std::mutex> lock{injection_mutex_};
+		if (!injection_queue_.empty()) {
+			job = injection_queue_.front();
+			injection_queue_.pop_front();
+			injected_jobs_.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+	const auto worker_count = static_cast<uint32_t>(workers_.size());
+	for (uint32_t i = 1; job == nullptr && i <= worker_count; ++i) {
+		const uint32_t victim = (self + i) % worker_count;
+		if (is_worker && victim == self) { continue; }
+		job = workers_[victim]->deque.steal();
+	}
+	if (job != nullptr) {
+		queued_jobs_.fetch_sub(1);
+	}
+	return job;
+}
+
+details::job* job_system::find_background_job() {
+	if (background_jobs_.load(std::memory_order_acquire) == 0) { return nullptr; }
+	std::lock_guard<std::mutex> lock{background_mutex_};
+	if (background_queue_.empty()) { return nullptr; }
+	auto job = background_queue_.front();
+	background_queue_.pop_front();
+	background_jobs_.fetch_sub(1, std::memory_order_relaxed);
+	return job;
+}
+
+void job_system::execute(details::job* job) {
+	// detached jobs free themselves, so everything needed afterwards is read up front.
+	auto counter = job->counter;
+	auto dependents = job->dependents;
+	try {
+		PG_GODS_VIEW_PROFILE_SCOPE("job");
+		job->execute(*job);
+	} catch (...) {
+		// the counter and dependents still go down below, or its waiter would hang.
+		std::lock_guard<std::mutex> lock{failure_mutex_};
+		const bool first = std::none_of(failures_.begin(), failures_.end(), [counter](const auto& failure) { return failure.first == counter; });
+		if (first) {
+			failures_.emplace_back(counter, std::current_exception());
+			failure_count_.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if (dependents != nullptr) {
+		for (auto dependent : *dependents) {
+			if (dependent->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				push(dependent);
+			}
+		}
+	}
+	counter->fetch_sub(1, std::memory_order_release);
+}
+
+void job_system::rethrow_failure(const job_counter& counter) {
+	if (failure_count_.load(std::memory_order_relaxed) == 0) { return; }
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock{failure_mutex_};
+		auto failure = std::find_if(failures_.begin(), failures_.end(), [&counter](const auto& entry) { return entry.first == &counter; });
+		if (failure == failures_.end()) { return; }
+		error = failure->second;
+		failures_.erase(failure);
+		failure_count_.fetch_sub(1, std::memory_order_relaxed);
+	}
+	std::rethrow_exception(error);
+}
+
+} // end namespace pg::gods_view
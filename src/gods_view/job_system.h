@@ -0,0 +1,210 @@
+#if !defined PG_GODS_VIEW_JOB_SYSTEM_HEADER_INCLUDED
+#define PG_GODS_VIEW_JOB_SYSTEM_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/profiler.h"
+#include "gods_view/work_stealing_deque.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pg::gods_view {
+
+// counts jobs that have been submitted but not finished, `job_system::wait` blocks on it.
+using job_counter = std::atomic<uint32_t>;
+
+namespace details {
+
+constexpr std::size_t job_deque_capacity = 4096;
+constexpr uint32_t job_spin_count = 64;
+// most chunks one `parallel_for` splits into, its jobs live on the caller's stack.
+constexpr std::size_t max_parallel_chunks = 64;
+
+struct job {
+	void (*execute)(job& self);
+	void* context;
+	std::size_t begin;
+	std::size_t end;
+	job_counter* counter;
+	// graph nodes release their dependents when they finish.
+	std::atomic<uint32_t> pending_dependencies;
+	const std::vector<job*>* dependents;
+};
+
+} // end namespace pg::gods_view::details
+
+// a set of jobs with dependencies between them, rebuilt every frame. storage is kept across
+// `clear` so a graph of the same shape does not allocate again.
+class job_graph {
+private:
+	friend class job_system;
+
+	struct node {
+		details::job job;
+		std::function<void()> task;
+		std::vector<details::job*> dependents;
+		uint32_t dependency_count;
+	};
+
+	std::deque<node> nodes_;
+	std::size_t size_;
+
+public:
+	using job_handle = uint32_t;
+
+	job_graph();
+
+	job_graph(const job_graph&) = delete;
+
+	job_graph& operator=(const job_graph&) = delete;
+
+	[[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+	[[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+	// `task` starts once every job in `dependencies` has finished.
+	job_handle add(std::function<void()> task, std::initializer_list<job_handle> dependencies = {});
+
+	// makes `after` wait for `before`.
+	void depend(job_handle before, job_handle after);
+
+	void clear() noexcept;
+};
+
+// work stealing scheduler shared by every engine subsystem. each worker owns a deque it pushes
+// and pops at one end while idle workers steal from the other; threads that are not workers
+// hand jobs in through a shared queue. the thread that calls `initialize` becomes worker 0 and
+// runs jobs itself whenever it waits, so waiting never idles a core.
+class job_system {
+private:
+	struct worker {
+		gods_view::work_stealing_deque<details::job, details::job_deque_capacity> deque;
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<worker>> workers_;
+	std::mutex injection_mutex_;
+	std::deque<details::job*> injection_queue_;
+	std::atomic<uint32_t> injected_jobs_;
+	// long running work, only idle background workers take from here.
+	std::mutex background_mutex_;
+	std::deque<details::job*> background_queue_;
+	std::atomic<uint32_t> background_jobs_;
+	// the first exception thrown by a job of each counter, handed to whoever waits on it.
+	std::mutex failure_mutex_;
+	std::vector<std::pair<const job_counter*, std::exception_ptr>> failures_;
+	std::atomic<uint32_t> failure_count_;
+	std::atomic<uint32_t> queued_jobs_;
+	std::atomic<uint32_t> sleeping_workers_;
+	std::mutex sleep_mutex_;
+	std::condition_variable sleep_cv_;
+	std::atomic<bool> stopping_;
+
+public:
+	job_system();
+
+	~job_system();
+
+	job_system(const job_system&) = delete;
+
+	job_system& operator=(const job_system&) = delete;
+
+	// threads including the caller, 1 until `initialize` runs.
+	[[nodiscard]] uint32_t thread_count() const noexcept { return workers_.empty() ? 1 : static_cast<uint32_t>(workers_.size()); }
+
+	// `background_workers` threads are started next to the calling thread.
+	void initialize(uint32_t background_workers);
+
+	// runs every job in `graph` and returns once all of them finished. a job that throws
+	// still releases its dependents, the first exception is rethrown here afterwards.
+	void run(job_graph& graph);
+
+	// fire and forget, `counter` is raised now and lowered when `task` returns or throws.
+	void submit(job_counter& counter, std::function<void()> task);
+
+	// like `submit`, but the task goes to a lane only idle background workers take from.
+	// `run` and `wait` never pick it up, so a thread waiting on frame work can't end up inside
+	// a long task. without background workers there is no lane and this is `submit`.
+	void submit_background(job_counter& counter, std::function<void()> task);
+
+	// runs other jobs until `counter` drops to zero, then rethrows the first exception one
+	// of its jobs threw.
+	void wait(const job_counter& counter);
+
+	// `wait` for counters of background jobs, runs those on the caller too when it has to.
+	// not for frame paths.
+	void wait_background(const job_counter& counter);
+
+	// calls `function(chunk_begin, chunk_end)` over [begin, end) in chunks of at least `grain`
+	// spread over all threads, returns when every chunk is done.
+	template <typename Function>
+	void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Function&& function) {
+		if (end <= begin) { return; }
+		const std::size_t count = end - begin;
+		grain = grain == 0 ? 1 : grain;
+		// a few chunks per thread leave room for stealing to even out uneven chunks.
+		const std::size_t chunk_count = std::min({
+			(count + grain - 1) / grain,
+			static_cast<std::size_t>(thread_count()) * 4,
+			details::max_parallel_chunks
+		});
+		if (chunk_count <= 1) {
+			function(begin, end);
+			return;
+		}
+		using function_type = std::remove_reference_t<Function>;
+		// on the stack so a parallel loop in a frame doesn't allocate.
+		details::job jobs[details::max_parallel_chunks]{};
+		job_counter counter{static_cast<uint32_t>(chunk_count)};
+		const std::size_t chunk_size = count / chunk_count;
+		const std::size_t remainder = count % chunk_count;
+		std::size_t chunk_begin = begin;
+		for (std::size_t i = 0; i < chunk_count; ++i) {
+			auto& job = jobs[i];
+			job.execute = [](details::job& self) {
+				(*static_cast<function_type*>(self.context))(self.begin, self.end);
+			};
+			job.context = const_cast<void*>(static_cast<const void*>(std::addressof(function)));
+			job.begin = chunk_begin;
+			job.end = chunk_begin + chunk_size + (i < remainder ? 1 : 0);
+			job.counter = &counter;
+			job.dependents = nullptr;
+			chunk_begin = job.end;
+		}
+		for (std::size_t i = 1; i < chunk_count; ++i) {
+			push(&jobs[i]);
+		}
+		execute(&jobs[0]);
+		wait(counter);
+	}
+
+private:
+	void worker_loop(uint32_t index);
+
+	void push(details::job* job);
+
+	details::job* find_job();
+
+	details::job* find_background_job();
+
+	void execute(details::job* job);
+
+	void rethrow_failure(const job_counter& counter);
+};
+
+} // end namespace pg::gods_view
+
+#endif
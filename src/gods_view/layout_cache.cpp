@@ -0,0 +1,132 @@
+#include "gods_view/layout_cache.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pg::gods_view {
+
+layout_cache::layout_cache(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine}
+{ }
+
+layout_cache::~layout_cache() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto& [key, layout] : pipeline_layouts_) {
+		vk.destroy_pipeline_layout(device, layout, nullptr);
+	}
+	for (auto& [key, layout] : set_layouts_) {
+		vk.destroy_descriptor_set_layout(device, layout, nullptr);
+	}
+}
+
+VkDescriptorSetLayout layout_cache::descriptor_set_layout(std::vector<VkDescriptorSetLayoutBinding> bindings) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	std::sort(bindings.begin(), bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+		return a.binding < b.binding;
+	});
+	std::vector<uint32_t> key;
+	key.reserve(bindings.size() * 4);
+	for (const auto& binding : bindings) {
+		key.insert(key.end(), {binding.binding, static_cast<uint32_t>(binding.descriptorType), binding.descriptorCount, binding.stageFlags});
+	}
+	if (auto it = set_layouts_.find(key); it != set_layouts_.end()) {
+		return it->second;
+	}
+
+	VkDescriptorSetLayoutCreateInfo layout_info{};
+	layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
+	layout_info.pBindings = bindings.data();
+
+	VkDescriptorSetLayout layout;
+	if (vk.create_descriptor_set_layout(engine_->device_manager()->logical_device(), &layout_info, nullptr, &layout) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create descriptor set layout"};
+	}
+	set_layouts_.emplace(std::move(key), layout);
+	return layout;
+}
+
+VkPipelineLayout layout_cache::pipeline_layout(
+	const std::vector<VkDescriptorSetLayout>& set_layouts,
+	const std::vector<VkPushConstantRange>& push_constant_ranges
+)
+{
+	const auto& vk = engine_->device_manager()->dispatch();
+	std::vector<uint64_t> key;
+	key.reserve(set_layouts.size() + push_constant_ranges.size() * 2 + 1);
+	key.push_back(set_layouts.size());
+	for (auto set_layout : set_layouts) {
+		uint64_t handle{0};
+		std::memcpy(&handle, &set_layout, sizeof(set_layout));
+		key.push_back(handle);
+	}
+	for (const auto& range : push_constant_ranges) {
+		key.push_back(range.stageFlags);
+		key.push_back((static_cast<uint64_t>(range.offset) << 32) | range.size);
+	}
+	if (auto it = pipeline_layouts_.find(key); it != pipeline_layouts_.end()) {
+		return it->second;
+	}
+
+	VkPipelineLayoutCreateInfo pipeline_layout_info{};
+	pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipeline_layout_info.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+	pipeline_layout_info.pSetLayouts = set_layouts.data();
+	pipeline_layout_info.pushConstantRangeCount = static_cast<uint32_t>(push_constant_ranges.size());
+	pipeline_layout_info.pPushConstantRanges = push_constant_ranges.data();
+
+	VkPipelineLayout layout;
+	if (vk.create_pipeline_layout(engine_->device_manager()->logical_device(), &pipeline_layout_info, nullptr, &layout) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create pipeline layout"};
+	}
+	pipeline_layouts_.emplace(std::move(key), layout);
+	return layout;
+}
+
+pipeline_layout_info layout_cache::pipeline_layout(const std::vector<shader_reflection>& stages) {
+	std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets;
+	pipeline_layout_info info{};
+	for (const auto& stage : stages) {
+		for (const auto& binding : stage.bindings) {
+			if (binding.set >= sets.size()) {
+				sets.resize(binding.set + 1);
+			}
+			auto& set = sets[binding.set];
+			auto it = std::find_if(set.begin(), set.end(), [&](const VkDescriptorSetLayoutBinding& b) { return b.binding == binding.binding; });
+			if (it != set.end()) {
+				if (it->descriptorType != binding.type) {
+					throw std::runtime_error{"Shader stages disagree on a descriptor binding"};
+				}
+				it->descriptorCount = std::max(it->descriptorCount, binding.count);
+				it->stageFlags |= stage.stage;
+				continue;
+			}
+			VkDescriptorSetLayoutBinding layout_binding{};
+			layout_binding.binding = binding.binding;
+			layout_binding.descriptorType = binding.type;
+			layout_binding.descriptorCount = binding.count;
+			layout_binding.stageFlags = stage.stage;
+			set.push_back(layout_binding);
+		}
+		// one range shared by every stage that declares push constants, pushed with the union of their flags.
+		if (stage.push_constant_size != 0) {
+			info.push_constant_range.stageFlags |= stage.stage;
+			info.push_constant_range.size = std::max(info.push_constant_range.size, stage.push_constant_size);
+		}
+	}
+
+	// sets skipped by the shaders still need a layout, an empty one.
+	for (auto& set : sets) {
+		info.set_layouts.push_back(descriptor_set_layout(std::move(set)));
+	}
+	std::vector<VkPushConstantRange> push_constant_ranges;
+	if (info.push_constant_range.size != 0) {
+		push_constant_ranges.push_back(info.push_constant_range);
+	}
+	info.layout = pipeline_layout(info.set_layouts, push_constant_ranges);
+	return info;
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,55 @@
+#if !defined PG_GODS_VIEW_LAYOUT_CACHE_HEADER_INCLUDED
+#define PG_GODS_VIEW_LAYOUT_CACHE_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/shader_reflection.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace pg::gods_view {
+
+struct pipeline_layout_info {
+	VkPipelineLayout layout;
+	std::vector<VkDescriptorSetLayout> set_layouts;
+	VkPushConstantRange push_constant_range;
+};
+
+class vulkan_engine;
+
+// owns every descriptor set layout and pipeline layout. identical descriptions resolve to
+// the same handle, so pipelines built from shaders with matching interfaces share layouts
+// and stay compatible for descriptor sets bound across pipeline switches.
+class layout_cache {
+private:
+	gods_view::vulkan_engine* engine_;
+	std::map<std::vector<uint32_t>, VkDescriptorSetLayout> set_layouts_;
+	std::map<std::vector<uint64_t>, VkPipelineLayout> pipeline_layouts_;
+
+public:
+	layout_cache(gods_view::vulkan_engine* init_engine);
+
+	~layout_cache();
+
+	layout_cache(const layout_cache&) = delete;
+
+	layout_cache& operator=(const layout_cache&) = delete;
+
+	VkDescriptorSetLayout descriptor_set_layout(std::vector<VkDescriptorSetLayoutBinding> bindings);
+
+	VkPipelineLayout pipeline_layout(const std::vector<VkDescriptorSetLayout>& set_layouts, const std::vector<VkPushConstantRange>& push_constant_ranges);
+
+	// merges the reflected stages of one pipeline and resolves its layouts.
+	pipeline_layout_info pipeline_layout(const std::vector<shader_reflection>& stages);
+
+	[[nodiscard]] size_t descriptor_set_layout_count() const noexcept { return set_layouts_.size(); }
+
+	[[nodiscard]] size_t pipeline_layout_count() const noexcept { return pipeline_layouts_.size(); }
+};
+
+} // end namespace pg::gods_view
+
+#endif
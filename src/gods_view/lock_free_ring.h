@@ -0,0 +1,90 @@
+#if !defined PG_GODS_VIEW_LOCK_FREE_RING_HEADER_INCLUDED
+#define PG_GODS_VIEW_LOCK_FREE_RING_HEADER_INCLUDED
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr std::size_t cache_line_size = 64;
+
+} // end namespace pg::gods_view::details
+
+// bounded multi producer / single consumer ring. producers never block or allocate,
+// a full ring simply rejects the push.
+template <typename T, std::size_t Capacity>
+class mpsc_ring {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "mpsc_ring capacity must be a power of two");
+
+private:
+	struct slot {
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	std::array<slot, Capacity> slots_;
+	alignas(details::cache_line_size) std::atomic<std::size_t> head_;
+	alignas(details::cache_line_size) std::size_t tail_;
+
+public:
+	mpsc_ring() :
+		head_{0},
+		tail_{0}
+	{
+		for (std::size_t i = 0; i < Capacity; ++i) {
+			slots_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	mpsc_ring(const mpsc_ring&) = delete;
+
+	mpsc_ring& operator=(const mpsc_ring&) = delete;
+
+	[[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+	// `write` fills the claimed slot in place so large payloads are never copied twice.
+	template <typename Writer>
+	bool try_push(Writer&& write) noexcept {
+		std::size_t position = head_.load(std::memory_order_relaxed);
+		for (;;) {
+			slot& target = slots_[position & (Capacity - 1)];
+			const std::size_t sequence = target.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+			if (difference == 0) {
+				if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					write(target.value);
+					target.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = head_.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// consumer side only.
+	template <typename Reader>
+	bool try_pop(Reader&& read) {
+		slot& source = slots_[tail_ & (Capacity - 1)];
+		const std::size_t sequence = source.sequence.load(std::memory_order_acquire);
+		if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail_ + 1) < 0) {
+			return false;
+		}
+		read(source.value);
+		source.sequence.store(tail_ + Capacity, std::memory_order_release);
+		++tail_;
+		return true;
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif
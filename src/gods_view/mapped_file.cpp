@@ -0,0 +1,92 @@
+#include "gods_view/mapped_file.h"
+
+#include <system_error>
+
+#if defined _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pg::gods_view {
+
+#if defined _WIN32
+
+mapped_file::mapped_file(const std::string& filename) :
+	data_{nullptr},
+	size_{0},
+	file_{INVALID_HANDLE_VALUE},
+	mapping_{nullptr}
+{
+	file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_ == INVALID_HANDLE_VALUE) {
+		throw std::runtime_error{"Failed to open file"};
+	}
+	LARGE_INTEGER file_size{};
+	GetFileSizeEx(file_, &file_size);
+	size_ = static_cast<std::size_t>(file_size.QuadPart);
+	if (size_ == 0) { return; }
+	mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_ == nullptr) {
+		CloseHandle(file_);
+		throw std::runtime_error{"Failed to map file"};
+	}
+	data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		CloseHandle(mapping_);
+		CloseHandle(file_);
+		throw std::runtime_error{"Failed to map file"};
+	}
+}
+
+mapped_file::~mapped_file() {
+	if (data_ != nullptr) { UnmapViewOfFile(data_); }
+	if (mapping_ != nullptr) { CloseHandle(mapping_); }
+	if (file_ != INVALID_HANDLE_VALUE) { CloseHandle(file_); }
+}
+
+#else
+
+mapped_file::mapped_file(const std::string& filename) :
+	data_{nullptr},
+	size_{0}
+{
+	const int descriptor = open(filename.c_str(), O_RDONLY);
+	if (descriptor < 0) {
+		throw std::runtime_error{"Failed to open file"};
+	}
+	struct stat file_stat{};
+	if (fstat(descriptor, &file_stat) != 0) {
+		close(descriptor);
+		throw std::runtime_error{"Failed to stat file"};
+	}
+	size_ = static_cast<std::size_t>(file_stat.st_size);
+	if (size_ != 0) {
+		void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mapping == MAP_FAILED) {
+			close(descriptor);
+			throw std::runtime_error{"Failed to map file"};
+		}
+		// loads read every byte once front to back.
+		madvise(mapping, size_, MADV_SEQUENTIAL);
+		madvise(mapping, size_, MADV_WILLNEED);
+		data_ = static_cast<const std::byte*>(mapping);
+	}
+	// the mapping keeps the file referenced on its own.
+	close(descriptor);
+}
+
+mapped_file::~mapped_file() {
+	if (data_ != nullptr) {
+		munmap(const_cast<std::byte*>(data_), size_);
+	}
+}
+
+#endif
+
+} // end namespace pg::gods_view
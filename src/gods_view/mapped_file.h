@@ -0,0 +1,36 @@
+#if !defined PG_GODS_VIEW_MAPPED_FILE_HEADER_INCLUDED
+#define PG_GODS_VIEW_MAPPED_FILE_HEADER_INCLUDED
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace pg::gods_view {
+
+// read only memory mapping of a whole file.
+class mapped_file {
+private:
+	const std::byte* data_;
+	std::size_t size_;
+#if defined _WIN32
+	void* file_;
+	void* mapping_;
+#endif
+
+public:
+	explicit mapped_file(const std::string& filename);
+
+	~mapped_file();
+
+	mapped_file(const mapped_file&) = delete;
+
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	[[nodiscard]] const std::byte* data() const noexcept { return data_; }
+
+	[[nodiscard]] std::size_t size() const noexcept { return size_; }
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,203 @@
+#if !defined PG_GODS_VIEW_MEMORY_HEADER_INCLUDED
+#define PG_GODS_VIEW_MEMORY_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/device_dispatch.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <optional>
+#include <system_error>
+
+namespace pg::gods_view {
+
+struct gpu_buffer {
+	VkBuffer buffer{VK_NULL_HANDLE};
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+	VkDeviceSize size{0};
+	void* mapped{nullptr};
+};
+
+struct gpu_image {
+	VkImage image{VK_NULL_HANDLE};
+	VkDeviceMemory memory{VK_NULL_HANDLE};
+	VkImageView view{VK_NULL_HANDLE};
+	VkDeviceSize size{0};
+};
+
+namespace details {
+
+static std::optional<uint32_t> find_memory_type(
+	const VkPhysicalDeviceMemoryProperties& memory_properties,
+	uint32_t type_bits,
+	VkMemoryPropertyFlags properties
+)
+{
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+		if ((type_bits & (1u << i)) && (memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+			return i;
+		}
+	}
+	return std::nullopt;
+}
+
+static VkDeviceMemory allocate_memory(
+	const device_dispatch& vk,
+	const VkPhysicalDeviceMemoryProperties& memory_properties,
+	const VkMemoryRequirements& requirements,
+	VkMemoryPropertyFlags properties
+)
+{
+	auto memory_type = find_memory_type(memory_properties, requirements.memoryTypeBits, properties);
+	if (!memory_type.has_value()) {
+		throw std::runtime_error{"Failed to find a suitable memory type"};
+	}
+	VkMemoryAllocateInfo allocate_info{};
+	allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocate_info.allocationSize = requirements.size;
+	allocate_info.memoryTypeIndex = memory_type.value();
+
+	VkDeviceMemory memory;
+	if (vk.allocate_memory(vk.device, &allocate_info, nullptr, &memory) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to allocate device memory"};
+	}
+	return memory;
+}
+
+// host visible buffers come back persistently mapped.
+static gpu_buffer create_buffer(
+	const device_dispatch& vk,
+	const VkPhysicalDeviceMemoryProperties& memory_properties,
+	VkDeviceSize size,
+	VkBufferUsageFlags usage,
+	VkMemoryPropertyFlags properties
+)
+{
+	gpu_buffer result{};
+	result.size = size;
+
+	VkBufferCreateInfo buffer_info{};
+	buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	buffer_info.size = size;
+	buffer_info.usage = usage;
+	buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (vk.create_buffer(vk.device, &buffer_info, nullptr, &result.buffer) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create buffer"};
+	}
+
+	VkMemoryRequirements requirements;
+	vk.get_buffer_memory_requirements(vk.device, result.buffer, &requirements);
+	result.memory = allocate_memory(vk, memory_properties, requirements, properties);
+	vk.bind_buffer_memory(vk.device, result.buffer, result.memory, 0);
+
+	if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+		if (vk.map_memory(vk.device, result.memory, 0, size, 0, &result.mapped) != VK_SUCCESS) {
+			throw std::runtime_error{"Failed to map buffer memory"};
+		}
+	}
+	return result;
+}
+
+static gpu_image create_image(
+	const device_dispatch& vk,
+	const VkPhysicalDeviceMemoryProperties& memory_properties,
+	VkFormat format,
+	VkExtent2D extent,
+	uint32_t mip_levels,
+	VkImageUsageFlags usage,
+	VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT
+)
+{
+	gpu_image result{};
+
+	VkImageCreateInfo image_info{};
+	image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_info.imageType = VK_IMAGE_TYPE_2D;
+	image_info.format = format;
+	image_info.extent = {extent.width, extent.height, 1};
+	image_info.mipLevels = mip_levels;
+	image_info.arrayLayers = 1;
+	image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_info.usage = usage;
+	image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (vk.create_image(vk.device, &image_info, nullptr, &result.image) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create image"};
+	}
+
+	VkMemoryRequirements requirements;
+	vk.get_image_memory_requirements(vk.device, result.image, &requirements);
+	result.memory = allocate_memory(vk, memory_properties, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	result.size = requirements.size;
+	vk.bind_image_memory(vk.device, result.image, result.memory, 0);
+
+	VkImageViewCreateInfo view_info{};
+	view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	view_info.image = result.image;
+	view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	view_info.format = format;
+	view_info.subresourceRange.aspectMask = aspect;
+	view_info.subresourceRange.baseMipLevel = 0;
+	view_info.subresourceRange.levelCount = mip_levels;
+	view_info.subresourceRange.baseArrayLayer = 0;
+	view_info.subresourceRange.layerCount = 1;
+	if (vk.create_image_view(vk.device, &view_info, nullptr, &result.view) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create image view"};
+	}
+	return result;
+}
+
+static void destroy_buffer(const device_dispatch& vk, gpu_buffer& buffer) {
+	if (buffer.mapped != nullptr) {
+		vk.unmap_memory(vk.device, buffer.memory);
+	}
+	vk.destroy_buffer(vk.device, buffer.buffer, nullptr);
+	vk.free_memory(vk.device, buffer.memory, nullptr);
+	buffer = {};
+}
+
+static void destroy_image(const device_dispatch& vk, gpu_image& image) {
+	vk.destroy_image_view(vk.device, image.view, nullptr);
+	vk.destroy_image(vk.device, image.image, nullptr);
+	vk.free_memory(vk.device, image.memory, nullptr);
+	image = {};
+}
+
+static void transition_image_layout(
+	const device_dispatch& vk,
+	VkCommandBuffer command_buffer,
+	VkImage image,
+	VkImageLayout old_layout,
+	VkImageLayout new_layout,
+	VkAccessFlags src_access,
+	VkAccessFlags dst_access,
+	VkPipelineStageFlags src_stage,
+	VkPipelineStageFlags dst_stage,
+	uint32_t base_mip_level = 0,
+	uint32_t level_count = VK_REMAINING_MIP_LEVELS
+)
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = src_access;
+	barrier.dstAccessMask = dst_access;
+	barrier.oldLayout = old_layout;
+	barrier.newLayout = new_layout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = base_mip_level;
+	barrier.subresourceRange.levelCount = level_count;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+	vk.cmd_pipeline_barrier(command_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+} // end namespace pg::gods_view::details
+
+} // end namespace pg::gods_view
+
+#endif
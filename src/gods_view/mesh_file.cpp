@@ -0,0 +1,260 @@
+#include "gods_view/mesh_file.h"
+#include "gods_view/vertex_quantization.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <system_error>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr float vertex_cache_decay_power = 1.5f;
+constexpr float vertex_last_triangle_score = 0.75f;
+constexpr float vertex_valence_boost_scale = 2.0f;
+constexpr float vertex_valence_boost_power = 0.5f;
+
+static float vertex_score(int32_t cache_position, uint32_t remaining_triangles) {
+	if (remaining_triangles == 0) { return -1.0f; }
+	float score{0.0f};
+	if (cache_position >= 0) {
+		if (cache_position < 3) {
+			// the triangle just emitted, don't reward reusing it straight away.
+			score = vertex_last_triangle_score;
+		} else {
+			const float scaler = 1.0f / static_cast<float>(vertex_cache_size - 3);
+			score = std::pow(1.0f - static_cast<float>(cache_position - 3) * scaler, vertex_cache_decay_power);
+		}
+	}
+	// boost vertices with few triangles left so they get finished off and leave the cache.
+	score += vertex_valence_boost_scale * std::pow(static_cast<float>(remaining_triangles), -vertex_valence_boost_power);
+	return score;
+}
+
+static uint64_t align_offset(uint64_t offset) {
+	return (offset + mesh_file_stream_alignment - 1) & ~(mesh_file_stream_alignment - 1);
+}
+
+void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count) {
+	// a triangle naming a vertex twice would sit in that vertex's list twice, the removal below
+	// assumes each triangle appears once per vertex.
+	size_t kept{0};
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		const uint32_t a = indices[t];
+		const uint32_t b = indices[t + 1];
+		const uint32_t c = indices[t + 2];
+		if (a == b || b == c || a == c) { continue; }
+		indices[kept++] = a;
+		indices[kept++] = b;
+		indices[kept++] = c;
+	}
+	indices.resize(kept);
+	const size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0) { return; }
+
+	// per vertex list of triangles still to be emitted, packed into one array.
+	std::vector<uint32_t> remaining(vertex_count, 0);
+	for (auto index : indices) {
+		++remaining[index];
+	}
+	std::vector<uint32_t> offsets(vertex_count + 1, 0);
+	for (uint32_t v = 0; v < vertex_count; ++v) {
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> fill{offsets.begin(), offsets.end() - 1};
+	for (size_t t = 0; t < triangle_count; ++t) {
+		for (size_t k = 0; k < 3; ++k) {
+			adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+		}
+	}
+
+	std::vector<int32_t> cache_position(vertex_count, -1);
+	std::vector<float> scores(vertex_count);
+	for (uint32_t v = 0; v < vertex_count; ++v) {
+		scores[v] = vertex_score(-1, remaining[v]);
+	}
+	std::vector<float> triangle_scores(triangle_count);
+	std::vector<bool> emitted(triangle_count, false);
+	int64_t best{-1};
+	float best_score{-1.0f};
+	for (size_t t = 0; t < triangle_count; ++t) {
+		triangle_scores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+		if (triangle_scores[t] > best_score) {
+			best_score = triangle_scores[t];
+			best = static_cast<int64_t>(t);
+		}
+	}
+
+	std::array<uint32_t, vertex_cache_size + 3> cache{};
+	std::array<uint32_t, vertex_cache_size + 3> next_cache{};
+	size_t cache_count{0};
+	size_t scan_cursor{0};
+	std::vector<uint32_t> output;
+	output.reserve(indices.size());
+
+	while (output.size() < triangle_count * 3) {
+		if (best < 0) {
+			// nothing in the cache touches a live triangle, restart from the next unemitted one.
+			while (emitted[scan_cursor]) { ++scan_cursor; }
+			best = static_cast<int64_t>(scan_cursor);
+		}
+		const auto triangle = static_cast<size_t>(best);
+		emitted[triangle] = true;
+
+		size_t next_count{0};
+		for (size_t k = 0; k < 3; ++k) {
+			const uint32_t v = indices[triangle * 3 + k];
+			output.push_back(v);
+			auto begin = adjacency.begin() + offsets[v];
+			auto end = begin + remaining[v];
+			std::iter_swap(std::find(begin, end, static_cast<uint32_t>(triangle)), end - 1);
+			--remaining[v];
+			if (std::find(next_cache.begin(), next_cache.begin() + next_count, v) == next_cache.begin() + next_count) {
+				next_cache[next_count++] = v;
+			}
+		}
+		for (size_t i = 0; i < cache_count; ++i) {
+			const uint32_t v = cache[i];
+			if (std::find(next_cache.begin(), next_cache.begin() + 3, v) == next_cache.begin() + 3) {
+				next_cache[next_count++] = v;
+			}
+		}
+
+		for (size_t i = 0; i < next_count; ++i) {
+			const uint32_t v = next_cache[i];
+			cache_position[v] = i < vertex_cache_size ? static_cast<int32_t>(i) : -1;
+			scores[v] = vertex_score(cache_position[v], remaining[v]);
+		}
+
+		best = -1;
+		best_score = -1.0f;
+		for (size_t i = 0; i < next_count; ++i) {
+			const uint32_t v = next_cache[i];
+			for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; ++j) {
+				const uint32_t t = adjacency[j];
+				triangle_scores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+				if (triangle_scores[t] > best_score) {
+					best_score = triangle_scores[t];
+					best = t;
+				}
+			}
+		}
+
+		cache_count = std::min(next_count, static_cast<size_t>(vertex_cache_size));
+		std::copy(next_cache.begin(), next_cache.begin() + cache_count, cache.begin());
+	}
+	indices.swap(output);
+}
+
+void optimize_vertex_fetch(std::vector<gods_view::vertex>& vertices, std::vector<uint32_t>& indices) {
+	constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap(vertices.size(), unused);
+	uint32_t next{0};
+	for (auto& index : indices) {
+		if (remap[index] == unused) {
+			remap[index] = next++;
+		}
+		index = remap[index];
+	}
+	std::vector<gods_view::vertex> reordered(next);
+	for (size_t v = 0; v < vertices.size(); ++v) {
+		if (remap[v] != unused) {
+			reordered[remap[v]] = vertices[v];
+		}
+	}
+	vertices.swap(reordered);
+}
+
+float average_cache_miss_ratio(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size) {
+	if (indices.size() < 3) { return 0.0f; }
+	std::vector<uint64_t> cached_at(vertex_count, 0);
+	uint64_t clock{0};
+	uint64_t misses{0};
+	for (auto index : indices) {
+		// fifo: a vertex stays cached until `cache_size` further misses pushed it out.
+		if (cached_at[index] == 0 || clock - cached_at[index] >= cache_size) {
+			++clock;
+			cached_at[index] = clock;
+			++misses;
+		}
+	}
+	return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+} // end namespace pg::gods_view::details
+
+void write_mesh_file(
+	const std::string& filename,
+	std::vector<gods_view::vertex> vertices,
+	std::vector<uint32_t> indices,
+	vertex_format format
+)
+{
+	if (indices.size() % 3 != 0) {
+		throw std::runtime_error{"Mesh indices must form a triangle list"};
+	}
+	for (auto index : indices) {
+		if (index >= vertices.size()) {
+			throw std::runtime_error{"Mesh index out of range"};
+		}
+	}
+	details::optimize_vertex_cache(indices, static_cast<uint32_t>(vertices.size()));
+	details::optimize_vertex_fetch(vertices, indices);
+
+	mesh_file_header header{};
+	std::memcpy(header.magic, "GVMS", 4);
+	header.version = details::mesh_file_version;
+	header.vertex_stride = vertex_stride(format);
+	header.vertex_format = static_cast<uint32_t>(format);
+	header.vertex_count = static_cast<uint32_t>(vertices.size());
+	header.index_count = static_cast<uint32_t>(indices.size());
+	// 0xffff stays free for primitive restart.
+	const bool short_indices = vertices.size() < std::numeric_limits<uint16_t>::max();
+	header.index_type = short_indices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	header.vertex_offset = details::align_offset(sizeof(mesh_file_header));
+	const uint64_t vertex_bytes = vertices.size() * header.vertex_stride;
+	header.index_offset = details::align_offset(header.vertex_offset + vertex_bytes);
+	for (size_t axis = 0; axis < 3; ++axis) {
+		header.bounds_min[axis] = std::numeric_limits<float>::max();
+		header.bounds_max[axis] = std::numeric_limits<float>::lowest();
+	}
+	for (const auto& v : vertices) {
+		for (size_t axis = 0; axis < 3; ++axis) {
+			header.bounds_min[axis] = std::min(header.bounds_min[axis], v.position[axis]);
+			header.bounds_max[axis] = std::max(header.bounds_max[axis], v.position[axis]);
+		}
+	}
+	std::vector<gods_view::packed_vertex> packed;
+	if (format == vertex_format::packed) {
+		packed = quantize_vertices(vertices, indices, header.bounds_min, header.bounds_max);
+	}
+	const auto* vertex_data = format == vertex_format::packed ?
+		reinterpret_cast<const char*>(packed.data()) :
+		reinterpret_cast<const char*>(vertices.data());
+
+	std::ofstream file{filename, std::ios::binary | std::ios::trunc};
+	if (!file.is_open()) {
+		throw std::runtime_error{"Failed to open file"};
+	}
+	const std::array<char, details::mesh_file_stream_alignment> padding{};
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(padding.data(), static_cast<std::streamsize>(header.vertex_offset - sizeof(header)));
+	file.write(vertex_data, static_cast<std::streamsize>(vertex_bytes));
+	file.write(padding.data(), static_cast<std::streamsize>(header.index_offset - header.vertex_offset - vertex_bytes));
+	if (short_indices) {
+		std::vector<uint16_t> narrowed{indices.begin(), indices.end()};
+		file.write(reinterpret_cast<const char*>(narrowed.data()), static_cast<std::streamsize>(narrowed.size() * sizeof(uint16_t)));
+	} else {
+		file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size() * sizeof(uint32_t)));
+	}
+	if (!file) {
+		throw std::runtime_error{"Failed to write mesh file"};
+	}
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,64 @@
+#if !defined PG_GODS_VIEW_MESH_FILE_HEADER_INCLUDED
+#define PG_GODS_VIEW_MESH_FILE_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/vertex.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pg::gods_view {
+
+// GPU ready mesh container. the vertex stream is an array of `vertex` or `packed_vertex`, as
+// `vertex_format` says, and the index stream is already in its final VkIndexType, both
+// aligned so they can be copied out of a mapping into staging memory without any per
+// element work. packed positions are relative to the bounds.
+struct mesh_file_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t vertex_stride;
+	uint32_t vertex_count;
+	uint32_t index_count;
+	uint32_t index_type;
+	uint64_t vertex_offset;
+	uint64_t index_offset;
+	float bounds_min[3];
+	float bounds_max[3];
+	uint32_t vertex_format;
+	uint32_t reserved;
+};
+
+namespace details {
+
+constexpr uint32_t mesh_file_version = 2;
+constexpr uint64_t mesh_file_stream_alignment = 16;
+constexpr uint32_t vertex_cache_size = 32;
+
+// reorders triangles for the post transform cache (Forsyth, linear speed vertex cache optimisation).
+// degenerate triangles cover no pixels and are dropped.
+void optimize_vertex_cache(std::vector<uint32_t>& indices, uint32_t vertex_count);
+
+// renumbers vertices in first use order so vertex fetch walks memory linearly. unreferenced
+// vertices are dropped.
+void optimize_vertex_fetch(std::vector<gods_view::vertex>& vertices, std::vector<uint32_t>& indices);
+
+// average transformed vertices per triangle for a FIFO cache of `cache_size` entries.
+float average_cache_miss_ratio(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size = vertex_cache_size);
+
+} // end namespace pg::gods_view::details
+
+// offline build step: optimises the triangle list and writes it as a mesh file, quantized
+// with `quantize_vertices` for `vertex_format::packed`.
+void write_mesh_file(
+	const std::string& filename,
+	std::vector<gods_view::vertex> vertices,
+	std::vector<uint32_t> indices,
+	vertex_format format = vertex_format::full
+);
+
+} // end namespace pg::gods_view
+
+#endif
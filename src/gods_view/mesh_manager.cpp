@@ -0,0 +1,364 @@
+#include "gods_view/mesh_manager.h"
+#include "gods_view/mapped_file.h"
+#include "gods_view/vertex_quantization.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace pg::gods_view {
+
+namespace details {
+
+// where mesh.vert's push constants keep the bounds, after the model view projection matrix.
+constexpr uint32_t mesh_bounds_push_offset = 64;
+
+static uint64_t index_size(uint32_t index_type) {
+	return index_type == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+// runs `cleanup` when the scope is left, unless `release` was called first.
+template <typename Cleanup>
+class scope_exit {
+private:
+	Cleanup cleanup_;
+	bool active_;
+
+public:
+	explicit scope_exit(Cleanup cleanup) :
+		cleanup_{std::move(cleanup)},
+		active_{true}
+	{ }
+
+	~scope_exit() {
+		if (active_) { cleanup_(); }
+	}
+
+	scope_exit(const scope_exit&) = delete;
+
+	scope_exit& operator=(const scope_exit&) = delete;
+
+	void release() noexcept { active_ = false; }
+};
+
+} // end namespace pg::gods_view::details
+
+mesh_manager::mesh_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	command_pool_{VK_NULL_HANDLE}
+{ }
+
+mesh_manager::~mesh_manager() {
+	if (command_pool_ == VK_NULL_HANDLE) { return; }
+
+	auto device = engine_->device_manager()->logical_device();
+	const auto& vk = engine_->device_manager()->dispatch();
+	for (auto& upload : uploads_) {
+		vk.wait_for_fences(device, 1, &upload.fence, VK_TRUE, UINT64_MAX);
+		destroy_upload(upload);
+	}
+	// the resource pool frees the meshes' buffers, including those of retired meshes.
+	vk.destroy_command_pool(device, command_pool_, nullptr);
+}
+
+void mesh_manager::initialize() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	VkCommandPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	pool_info.queueFamilyIndex = engine_->device_manager()->queue_families().graphics_family.value();
+	if (vk.create_command_pool(engine_->device_manager()->logical_device(), &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create mesh upload command pool"};
+	}
+}
+
+mesh_id mesh_manager::load_mesh(const std::string& filename) {
+	mapped_file file{filename};
+	if (file.size() < sizeof(mesh_file_header)) {
+		throw std::runtime_error{"Invalid mesh file"};
+	}
+	mesh_file_header header{};
+	std::memcpy(&header, file.data(), sizeof(header));
+	const uint64_t vertex_bytes = static_cast<uint64_t>(header.vertex_count) * header.vertex_stride;
+	const uint64_t index_bytes = static_cast<uint64_t>(header.index_count) * details::index_size(header.index_type);
+	if (std::memcmp(header.magic, "GVMS", 4) != 0 || header.version != details::mesh_file_version ||
+		header.vertex_format > static_cast<uint32_t>(vertex_format::packed) ||
+		header.vertex_stride != vertex_stride(static_cast<vertex_format>(header.vertex_format)) ||
+		header.vertex_count == 0 || header.index_count == 0 ||
+		(header.index_type != VK_INDEX_TYPE_UINT16 && header.index_type != VK_INDEX_TYPE_UINT32) ||
+		header.vertex_offset > file.size() || vertex_bytes > file.size() - header.vertex_offset ||
+		header.index_offset > file.size() || index_bytes > file.size() - header.index_offset)
+	{
+		throw std::runtime_error{"Invalid mesh file"};
+	}
+
+	mesh_bounds bounds{};
+	std::memcpy(bounds.min, header.bounds_min, sizeof(bounds.min));
+	std::memcpy(bounds.max, header.bounds_max, sizeof(bounds.max));
+	// both streams are already in their gpu layout, a straight copy out of the mapping is all
+	// the cpu does.
+	const auto id = submit_upload(
+		file.data() + header.vertex_offset,
+		vertex_bytes,
+		file.data() + header.index_offset,
+		index_bytes,
+		header.index_count,
+		static_cast<VkIndexType>(header.index_type),
+		bounds,
+		static_cast<vertex_format>(header.vertex_format)
+	);
+	engine_->trace_recorder()->mesh_load(id, filename);
+	return id;
+}
+
+mesh_id mesh_manager::create_mesh(
+	const std::vector<gods_view::vertex>& vertices,
+	const std::vector<uint32_t>& indices,
+	vertex_format format
+)
+{
+	if (vertices.empty() || indices.empty() || indices.size() % 3 != 0 ||
+		std::any_of(indices.begin(), indices.end(), [&vertices](uint32_t index) { return index >= vertices.size(); }))
+	{
+		throw std::runtime_error{"Invalid mesh"};
+	}
+	mesh_bounds bounds{};
+	for (size_t axis = 0; axis < 3; ++axis) {
+		bounds.min[axis] = std::numeric_limits<float>::max();
+		bounds.max[axis] = std::numeric_limits<float>::lowest();
+	}
+	for (const auto& v : vertices) {
+		for (size_t axis = 0; axis < 3; ++axis) {
+			bounds.min[axis] = std::min(bounds.min[axis], v.position[axis]);
+			bounds.max[axis] = std::max(bounds.max[axis], v.position[axis]);
+		}
+	}
+	std::vector<gods_view::packed_vertex> packed;
+	if (format == vertex_format::packed) {
+		packed = quantize_vertices(vertices, indices, bounds.min, bounds.max);
+	}
+	const auto* vertex_data = format == vertex_format::packed ?
+		reinterpret_cast<const std::byte*>(packed.data()) :
+		reinterpret_cast<const std::byte*>(vertices.data());
+	return submit_upload(
+		vertex_data,
+		static_cast<uint64_t>(vertices.size()) * vertex_stride(format),
+		reinterpret_cast<const std::byte*>(indices.data()),
+		indices.size() * sizeof(uint32_t),
+		static_cast<uint32_t>(indices.size()),
+		VK_INDEX_TYPE_UINT32,
+		bounds,
+		format
+	);
+}
+
+mesh_id mesh_manager::submit_upload(
+	const std::byte* vertex_data,
+	uint64_t vertex_bytes,
+	const std::byte* index_data,
+	uint64_t index_bytes,
+	uint32_t index_count,
+	VkIndexType index_type,
+	const mesh_bounds& bounds,
+	vertex_format format
+)
+{
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	const auto& memory_properties = engine_->device_manager()->memory_properties();
+
+	pending_upload upload{};
+	auto resources = engine_->resource_pool();
+	buffer_handle vertices{};
+	buffer_handle indices{};
+	// whatever was made before a step throws goes again, nothing reached the gpu yet.
+	details::scope_exit cleanup{[this, &vk, device, resources, &upload, &vertices, &indices] {
+		if (upload.fence != VK_NULL_HANDLE) {
+			vk.destroy_fence(device, upload.fence, nullptr);
+		}
+		if (upload.command_buffer != VK_NULL_HANDLE) {
+			vk.free_command_buffers(device, command_pool_, 1, &upload.command_buffer);
+		}
+		if (upload.staging.buffer != VK_NULL_HANDLE) {
+			details::destroy_buffer(vk, upload.staging);
+		}
+		if (meshes_.valid(upload.id)) {
+			meshes_.destroy(upload.id);
+		}
+		resources->destroy(indices);
+		resources->destroy(vertices);
+	}};
+	upload.staging = details::create_buffer(
+		vk,
+		memory_properties,
+		vertex_bytes + index_bytes,
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	);
+	std::memcpy(upload.staging.mapped, vertex_data, vertex_bytes);
+	std::memcpy(static_cast<std::byte*>(upload.staging.mapped) + vertex_bytes, index_data, index_bytes);
+
+	vertices = resources->create_buffer(
+		vertex_bytes,
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+	);
+	indices = resources->create_buffer(
+		index_bytes,
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+	);
+
+	VkCommandBufferAllocateInfo allocate_info{};
+	allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocate_info.commandPool = command_pool_;
+	allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocate_info.commandBufferCount = 1;
+	if (vk.allocate_command_buffers(device, &allocate_info, &upload.command_buffer) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to allocate mesh upload command buffer"};
+	}
+	VkFenceCreateInfo fence_info{};
+	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	if (vk.create_fence(device, &fence_info, nullptr, &upload.fence) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create mesh upload fence"};
+	}
+
+	VkCommandBufferBeginInfo begin_info{};
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	if (vk.begin_command_buffer(upload.command_buffer, &begin_info) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to begin mesh upload command buffer"};
+	}
+	VkBufferCopy vertex_region{0, 0, vertex_bytes};
+	vk.cmd_copy_buffer(upload.command_buffer, upload.staging.buffer, resources->buffer(vertices), 1, &vertex_region);
+	VkBufferCopy index_region{vertex_bytes, 0, index_bytes};
+	vk.cmd_copy_buffer(upload.command_buffer, upload.staging.buffer, resources->buffer(indices), 1, &index_region);
+
+	std::array<VkBufferMemoryBarrier, 2> barriers{};
+	for (auto& barrier : barriers) {
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+	}
+	barriers[0].dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	barriers[0].buffer = resources->buffer(vertices);
+	barriers[1].dstAccessMask = VK_ACCESS_INDEX_READ_BIT;
+	barriers[1].buffer = resources->buffer(indices);
+	vk.cmd_pipeline_barrier(
+		upload.command_buffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+		0,
+		0, nullptr,
+		static_cast<uint32_t>(barriers.size()), barriers.data(),
+		0, nullptr
+	);
+	if (vk.end_command_buffer(upload.command_buffer) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to record mesh upload command buffer"};
+	}
+
+	upload.id = meshes_.create(
+		vertices,
+		indices,
+		index_count,
+		index_type,
+		bounds,
+		format,
+		0
+	);
+	// nothing after the submit may throw, the gpu would be left reading freed buffers.
+	uploads_.reserve(uploads_.size() + 1);
+
+	VkSubmitInfo submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &upload.command_buffer;
+	if (vk.queue_submit(engine_->device_manager()->graphics_queue(), 1, &submit_info, upload.fence) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to submit mesh upload"};
+	}
+	cleanup.release();
+	uploads_.push_back(upload);
+
+	return upload.id;
+}
+
+void mesh_manager::update() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto it = uploads_.begin(); it != uploads_.end();) {
+		if (vk.get_fence_status(device, it->fence) != VK_SUCCESS) {
+			++it;
+			continue;
+		}
+		// a mesh unloaded mid upload has nothing left to flag.
+		if (meshes_.valid(it->id)) {
+			meshes_.get<resident_column>(it->id) = 1;
+		}
+		destroy_upload(*it);
+		it = uploads_.erase(it);
+	}
+
+	const uint64_t completed = engine_->draw_manager()->completed_frames();
+	auto resources = engine_->resource_pool();
+	for (auto it = retired_.begin(); it != retired_.end();) {
+		if (it->frame > completed) {
+			++it;
+			continue;
+		}
+		resources->destroy(it->vertices);
+		resources->destroy(it->indices);
+		it = retired_.erase(it);
+	}
+}
+
+void mesh_manager::unload_mesh(mesh_id id) {
+	if (!meshes_.valid(id)) { return; }
+	// the next frame's fence also covers an upload still in flight, it was submitted earlier.
+	retired_.push_back({
+		meshes_.get<vertices_column>(id),
+		meshes_.get<indices_column>(id),
+		engine_->draw_manager()->submitted_frames() + 1
+	});
+	meshes_.destroy(id);
+}
+
+void mesh_manager::draw(VkCommandBuffer command_buffer, mesh_id id, uint32_t instance_count) const {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (!resident(id)) { return; }
+	auto resources = engine_->resource_pool();
+	const VkBuffer vertices = resources->buffer(meshes_.get<vertices_column>(id));
+	VkDeviceSize offset{0};
+	vk.cmd_bind_vertex_buffers(command_buffer, 0, 1, &vertices, &offset);
+	vk.cmd_bind_index_buffer(command_buffer, resources->buffer(meshes_.get<indices_column>(id)), 0, meshes_.get<index_type_column>(id));
+	if (meshes_.get<vertex_format_column>(id) == vertex_format::packed) {
+		const auto& bounds = meshes_.get<bounds_column>(id);
+		const float constants[8] = {
+			bounds.min[0], bounds.min[1], bounds.min[2], 0.0f,
+			bounds.max[0] - bounds.min[0], bounds.max[1] - bounds.min[1], bounds.max[2] - bounds.min[2], 0.0f
+		};
+		vk.cmd_push_constants(
+			command_buffer,
+			engine_->graphics_pipeline_manager()->mesh_pipeline_layout(),
+			VK_SHADER_STAGE_VERTEX_BIT,
+			details::mesh_bounds_push_offset,
+			sizeof(constants),
+			constants
+		);
+	}
+	vk.cmd_draw_indexed(command_buffer, meshes_.get<index_count_column>(id), instance_count, 0, 0, 0);
+}
+
+void mesh_manager::destroy_upload(pending_upload& upload) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	vk.free_command_buffers(device, command_pool_, 1, &upload.command_buffer);
+	vk.destroy_fence(device, upload.fence, nullptr);
+	details::destroy_buffer(vk, upload.staging);
+}
+
+} // end namespace pg::gods_view
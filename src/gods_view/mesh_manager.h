@@ -0,0 +1,125 @@
+#if !defined PG_GODS_VIEW_MESH_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_MESH_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/handle_pool.h"
+#include "gods_view/memory.h"
+#include "gods_view/mesh_file.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pg::gods_view {
+
+using mesh_id = mesh_handle;
+
+struct mesh_bounds {
+	float min[3];
+	float max[3];
+};
+
+class vulkan_engine;
+
+// owns device local vertex/index buffers for meshes loaded from mesh files. loading maps the
+// file, copies both streams straight from the mapping into staging memory and submits the
+// gpu copy without waiting for it; a mesh becomes drawable once `update` sees its fence.
+// meshes live in a handle pool, one array per field, and their buffers in the engine's
+// resource pool, so a mesh id stays 32 bits wherever draws are kept.
+class mesh_manager {
+private:
+	static constexpr std::size_t vertices_column = 0;
+	static constexpr std::size_t indices_column = 1;
+	static constexpr std::size_t index_count_column = 2;
+	static constexpr std::size_t index_type_column = 3;
+	static constexpr std::size_t bounds_column = 4;
+	static constexpr std::size_t vertex_format_column = 5;
+	static constexpr std::size_t resident_column = 6;
+
+	struct pending_upload {
+		mesh_id id;
+		VkCommandBuffer command_buffer;
+		VkFence fence;
+		gpu_buffer staging;
+	};
+
+	// buffers of an unloaded mesh, freed once the frames that may still read them are done.
+	struct retired_mesh {
+		buffer_handle vertices;
+		buffer_handle indices;
+		uint64_t frame;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	handle_pool<mesh_id, buffer_handle, buffer_handle, uint32_t, VkIndexType, mesh_bounds, vertex_format, uint8_t> meshes_;
+	std::vector<pending_upload> uploads_;
+	std::vector<retired_mesh> retired_;
+	VkCommandPool command_pool_;
+
+public:
+	mesh_manager(gods_view::vulkan_engine* init_engine);
+
+	~mesh_manager();
+
+	void initialize();
+
+	mesh_id load_mesh(const std::string& filename);
+
+	// uploads a triangle list built at runtime, quantized with `quantize_vertices` over its
+	// bounds for `vertex_format::packed`. unlike loaded meshes these are not in traces.
+	mesh_id create_mesh(
+		const std::vector<gods_view::vertex>& vertices,
+		const std::vector<uint32_t>& indices,
+		vertex_format format = vertex_format::packed
+	);
+
+	// the id goes stale at once, the buffers are freed once no submitted frame can draw them.
+	void unload_mesh(mesh_id id);
+
+	// false for ids of unloaded meshes.
+	[[nodiscard]] bool valid(mesh_id id) const noexcept { return meshes_.valid(id); }
+
+	[[nodiscard]] uint32_t mesh_count() const noexcept { return meshes_.size(); }
+
+	[[nodiscard]] bool resident(mesh_id id) const noexcept { return meshes_.valid(id) && meshes_.get<resident_column>(id) != 0; }
+
+	[[nodiscard]] uint32_t index_count(mesh_id id) const noexcept { return meshes_.get<index_count_column>(id); }
+
+	[[nodiscard]] const float* bounds_min(mesh_id id) const noexcept { return meshes_.get<bounds_column>(id).min; }
+
+	[[nodiscard]] const float* bounds_max(mesh_id id) const noexcept { return meshes_.get<bounds_column>(id).max; }
+
+	// packed meshes draw with `graphics_pipeline_manager::mesh_pipeline`, which decodes them.
+	[[nodiscard]] vertex_format format(mesh_id id) const noexcept { return meshes_.get<vertex_format_column>(id); }
+
+	[[nodiscard]] bool busy() const noexcept { return !uploads_.empty(); }
+
+	// called once per frame from the render thread; never waits on the gpu.
+	void update();
+
+	// records an indexed draw, meshes still uploading or unloaded are skipped. packed meshes
+	// also push their bounds for a pipeline from `graphics_pipeline_manager::mesh_pipeline`.
+	void draw(VkCommandBuffer command_buffer, mesh_id id, uint32_t instance_count = 1) const;
+
+private:
+	// copies both streams into staging memory and submits their upload.
+	mesh_id submit_upload(
+		const std::byte* vertex_data,
+		uint64_t vertex_bytes,
+		const std::byte* index_data,
+		uint64_t index_bytes,
+		uint32_t index_count,
+		VkIndexType index_type,
+		const mesh_bounds& bounds,
+		vertex_format format
+	);
+
+	void destroy_upload(pending_upload& upload);
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,484 @@
+#include "gods_view/overlay_renderer.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace pg::gods_view {
+
+namespace details {
+
+struct overlay_push_constants {
+	float inverse_extent[2];
+	uint32_t coverage_atlas;
+};
+
+// decodes the code point at `position` and moves past it, malformed bytes come back as U+FFFD.
+static uint32_t next_codepoint(std::string_view utf8, size_t& position) noexcept {
+	const auto lead = static_cast<uint8_t>(utf8[position++]);
+	if (lead < 0x80) { return lead; }
+	size_t length;
+	uint32_t codepoint;
+	if ((lead & 0xe0) == 0xc0) {
+		length = 1;
+		codepoint = lead & 0x1f;
+	} else if ((lead & 0xf0) == 0xe0) {
+		length = 2;
+		codepoint = lead & 0x0f;
+	} else if ((lead & 0xf8) == 0xf0) {
+		length = 3;
+		codepoint = lead & 0x07;
+	} else {
+		return 0xfffd;
+	}
+	for (size_t i = 0; i < length; ++i) {
+		if (position >= utf8.size() || (static_cast<uint8_t>(utf8[position]) & 0xc0) != 0x80) { return 0xfffd; }
+		codepoint = (codepoint << 6) | (static_cast<uint8_t>(utf8[position++]) & 0x3f);
+	}
+	return codepoint;
+}
+
+} // end namespace pg::gods_view::details
+
+overlay_renderer::overlay_renderer(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	last_batch_{0},
+	max_quads_{0},
+	region_{0},
+	quad_count_{0},
+	dropped_quads_{0},
+	stats_{},
+	set_layout_{VK_NULL_HANDLE},
+	pipeline_layout_{VK_NULL_HANDLE},
+	vertex_shader_module_{VK_NULL_HANDLE},
+	fragment_shader_module_{VK_NULL_HANDLE},
+	pipeline_{VK_NULL_HANDLE}
+{ }
+
+overlay_renderer::~overlay_renderer() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (max_quads_ == 0) { return; }
+	auto device = engine_->device_manager()->logical_device();
+	vk.destroy_pipeline(device, pipeline_, nullptr);
+	vk.destroy_shader_module(device, fragment_shader_module_, nullptr);
+	vk.destroy_shader_module(device, vertex_shader_module_, nullptr);
+	details::destroy_buffer(vk, index_buffer_);
+	details::destroy_buffer(vk, vertex_buffer_);
+}
+
+void overlay_renderer::initialize(uint32_t max_quads) {
+	if (max_quads == 0) {
+		throw std::runtime_error{"Overlay needs room for at least one quad"};
+	}
+	const auto& vk = engine_->device_manager()->dispatch();
+	const auto& memory_properties = engine_->device_manager()->memory_properties();
+	max_quads_ = max_quads;
+	vertex_buffer_ = details::create_buffer(
+		vk,
+		memory_properties,
+		static_cast<VkDeviceSize>(max_quads_) * 4 * sizeof(overlay_vertex) * details::overlay_regions,
+		VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	);
+	// every quad uses the same two triangles, so the indices are written once.
+	index_buffer_ = details::create_buffer(
+		vk,
+		memory_properties,
+		static_cast<VkDeviceSize>(max_quads_) * 6 * sizeof(uint32_t),
+		VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	);
+	auto indices = static_cast<uint32_t*>(index_buffer_.mapped);
+	for (uint32_t quad = 0; quad < max_quads_; ++quad) {
+		const uint32_t first = quad * 4;
+		const uint32_t pattern[] = {first, first + 1, first + 2, first + 2, first + 3, first};
+		std::memcpy(indices + quad * 6, pattern, sizeof(pattern));
+	}
+	create_pipeline();
+}
+
+overlay_atlas_id overlay_renderer::add_font(const overlay_font_desc& font) {
+	const uint32_t size = font.atlas_size;
+	auto texels = std::make_shared<std::vector<std::byte>>(static_cast<size_t>(size) * size, std::byte{0});
+	for (uint32_t y = 0; y < details::overlay_white_texels; ++y) {
+		for (uint32_t x = 0; x < details::overlay_white_texels; ++x) {
+			(*texels)[static_cast<size_t>(y) * size + x] = std::byte{0xff};
+		}
+	}
+
+	atlas entry{};
+	entry.inverse_width = 1.0f / static_cast<float>(size);
+	entry.inverse_height = 1.0f / static_cast<float>(size);
+	entry.coverage = true;
+	entry.white_u = 1.0f * entry.inverse_width;
+	entry.white_v = 1.0f * entry.inverse_height;
+	entry.line_height = font.line_height;
+	entry.ascent = font.ascent;
+
+	// shelf packing, tallest glyphs first so shelves waste little height.
+	std::vector<const overlay_glyph_bitmap*> order;
+	order.reserve(font.glyphs.size());
+	for (const auto& bitmap : font.glyphs) {
+		order.push_back(&bitmap);
+	}
+	std::sort(order.begin(), order.end(), [](const overlay_glyph_bitmap* a, const overlay_glyph_bitmap* b) { return a->height > b->height; });
+	const uint32_t padding = details::overlay_glyph_padding;
+	uint32_t shelf_x = details::overlay_white_texels + padding;
+	uint32_t shelf_y = 0;
+	uint32_t shelf_height = details::overlay_white_texels;
+	for (const auto* bitmap : order) {
+		if (bitmap->coverage.size() < static_cast<size_t>(bitmap->width) * bitmap->height) {
+			throw std::runtime_error{"Glyph bitmap is smaller than its size"};
+		}
+		if (shelf_x + bitmap->width > size) {
+			shelf_x = 0;
+			shelf_y += shelf_height + padding;
+			shelf_height = 0;
+		}
+		if (bitmap->width > size || shelf_y + bitmap->height > size) {
+			throw std::runtime_error{"Glyphs don't fit the font atlas"};
+		}
+		for (uint32_t row = 0; row < bitmap->height; ++row) {
+			std::memcpy(
+				texels->data() + static_cast<size_t>(shelf_y + row) * size + shelf_x,
+				bitmap->coverage.data() + static_cast<size_t>(row) * bitmap->width,
+				bitmap->width
+			);
+		}
+		glyph placed{};
+		placed.x_offset = static_cast<float>(bitmap->bearing_x);
+		placed.y_offset = font.ascent - static_cast<float>(bitmap->bearing_y);
+		placed.width = static_cast<float>(bitmap->width);
+		placed.height = static_cast<float>(bitmap->height);
+		placed.advance = bitmap->advance;
+		placed.u0 = static_cast<float>(shelf_x) * entry.inverse_width;
+		placed.v0 = static_cast<float>(shelf_y) * entry.inverse_height;
+		placed.u1 = static_cast<float>(shelf_x + bitmap->width) * entry.inverse_width;
+		placed.v1 = static_cast<float>(shelf_y + bitmap->height) * entry.inverse_height;
+		placed.present = true;
+		if (bitmap->codepoint < entry.ascii.size()) {
+			entry.ascii[bitmap->codepoint] = placed;
+		} else {
+			entry.glyphs.emplace(bitmap->codepoint, placed);
+		}
+		shelf_x += bitmap->width + padding;
+		shelf_height = std::max(shelf_height, bitmap->height);
+	}
+
+	texture_desc desc{};
+	desc.width = size;
+	desc.height = size;
+	desc.mip_levels = 1;
+	desc.format = VK_FORMAT_R8_UNORM;
+	desc.decode = [texels](uint32_t) { return *texels; };
+	{
+		// replaying the font rebuilds its atlas texture.
+		trace_recorder::nested nested{engine_->trace_recorder()};
+		entry.texture = engine_->texture_manager()->create_texture(std::move(desc));
+	}
+	atlases_.push_back(std::move(entry));
+	const auto id = static_cast<overlay_atlas_id>(atlases_.size() - 1);
+	engine_->trace_recorder()->overlay_font(id, font);
+	return id;
+}
+
+overlay_atlas_id overlay_renderer::add_sprite_atlas(texture_id texture, uint32_t width, uint32_t height, VkOffset2D white) {
+	atlas entry{};
+	entry.texture = texture;
+	entry.inverse_width = 1.0f / static_cast<float>(width);
+	entry.inverse_height = 1.0f / static_cast<float>(height);
+	entry.coverage = false;
+	entry.white_u = (static_cast<float>(white.x) + 0.5f) * entry.inverse_width;
+	entry.white_v = (static_cast<float>(white.y) + 0.5f) * entry.inverse_height;
+	atlases_.push_back(std::move(entry));
+	const auto id = static_cast<overlay_atlas_id>(atlases_.size() - 1);
+	engine_->trace_recorder()->overlay_sprite_atlas(id, texture, width, height, white);
+	return id;
+}
+
+void overlay_renderer::quad(size_t surface_index, overlay_atlas_id atlas, const overlay_rect& rect, const overlay_rect& texels, uint32_t color) {
+	engine_->trace_recorder()->overlay_quad(surface_index, atlas, rect, texels, color);
+	auto vertices = batch_vertices(surface_index, atlas);
+	if (vertices == nullptr) { return; }
+	const auto& entry = atlases_[atlas];
+	push_quad(
+		*vertices,
+		rect.x, rect.y, rect.x + rect.width, rect.y + rect.height,
+		texels.x * entry.inverse_width,
+		texels.y * entry.inverse_height,
+		(texels.x + texels.width) * entry.inverse_width,
+		(texels.y + texels.height) * entry.inverse_height,
+		color
+	);
+}
+
+void overlay_renderer::rect(size_t surface_index, overlay_atlas_id atlas, const overlay_rect& rect, uint32_t color) {
+	engine_->trace_recorder()->overlay_rect(surface_index, atlas, rect, color);
+	auto vertices = batch_vertices(surface_index, atlas);
+	if (vertices == nullptr) { return; }
+	const auto& entry = atlases_[atlas];
+	push_quad(*vertices, rect.x, rect.y, rect.x + rect.width, rect.y + rect.height, entry.white_u, entry.white_v, entry.white_u, entry.white_v, color);
+}
+
+float overlay_renderer::text(size_t surface_index, overlay_atlas_id font, float x, float y, std::string_view utf8, uint32_t color, float scale) {
+	engine_->trace_recorder()->overlay_text(surface_index, font, x, y, utf8, color, scale);
+	const auto& entry = atlases_[font];
+	float pen_x = x;
+	float pen_y = y;
+	float widest{0.0f};
+	for (size_t position = 0; position < utf8.size();) {
+		const uint32_t codepoint = details::next_codepoint(utf8, position);
+		if (codepoint == '\n') {
+			widest = std::max(widest, pen_x - x);
+			pen_x = x;
+			pen_y += entry.line_height * scale;
+			continue;
+		}
+		const auto* placed = find_glyph(entry, codepoint);
+		if (placed == nullptr) { continue; }
+		if (placed->width > 0.0f && placed->height > 0.0f) {
+			// looked up per glyph since a dropped quad leaves no batch behind.
+			auto vertices = batch_vertices(surface_index, font);
+			if (vertices == nullptr) { break; }
+			const float x0 = pen_x + placed->x_offset * scale;
+			const float y0 = pen_y + placed->y_offset * scale;
+			push_quad(*vertices, x0, y0, x0 + placed->width * scale, y0 + placed->height * scale, placed->u0, placed->v0, placed->u1, placed->v1, color);
+		}
+		pen_x += placed->advance * scale;
+	}
+	return std::max(widest, pen_x - x);
+}
+
+float overlay_renderer::text_width(overlay_atlas_id font, std::string_view utf8, float scale) const {
+	const auto& entry = atlases_[font];
+	float line{0.0f};
+	float widest{0.0f};
+	for (size_t position = 0; position < utf8.size();) {
+		const uint32_t codepoint = details::next_codepoint(utf8, position);
+		if (codepoint == '\n') {
+			widest = std::max(widest, line);
+			line = 0.0f;
+			continue;
+		}
+		if (const auto* placed = find_glyph(entry, codepoint)) {
+			line += placed->advance * scale;
+		}
+	}
+	return std::max(widest, line);
+}
+
+void overlay_renderer::upload() {
+	if (max_quads_ == 0) { return; }
+	PG_GODS_VIEW_PROFILE_SCOPE("overlay upload");
+	region_ = (region_ + 1) % details::overlay_regions;
+	const uint32_t region_first = region_ * max_quads_ * 4;
+	auto mapped = static_cast<overlay_vertex*>(vertex_buffer_.mapped) + region_first;
+	uint32_t written{0};
+	stats_ = {quad_count_, 0, dropped_quads_};
+	for (auto& entry : batches_) {
+		entry.first_vertex = region_first + written;
+		entry.vertex_count = static_cast<uint32_t>(entry.vertices.size());
+		if (entry.vertex_count == 0) { continue; }
+		std::memcpy(mapped + written, entry.vertices.data(), entry.vertices.size() * sizeof(overlay_vertex));
+		written += entry.vertex_count;
+		entry.vertices.clear();
+		++stats_.draws;
+		// keeps the atlas resident at full resolution while it is on screen, a replay does the same.
+		const auto& used = atlases_[entry.atlas];
+		trace_recorder::nested nested{engine_->trace_recorder()};
+		engine_->texture_manager()->request(used.texture, 1.0f / std::min(used.inverse_width, used.inverse_height));
+	}
+	quad_count_ = 0;
+	dropped_quads_ = 0;
+}
+
+void overlay_renderer::record(VkCommandBuffer command_buffer, const frame_target& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (max_quads_ == 0) { return; }
+	bool bound{false};
+	for (const auto& entry : batches_) {
+		if (entry.surface_index != target.surface_index || entry.vertex_count == 0) { continue; }
+		if (!bound) {
+			const auto extent = engine_->surface_manager()->swap_chain_extent(target.surface_index);
+			vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+			const VkDeviceSize offset{0};
+			vk.cmd_bind_vertex_buffers(command_buffer, 0, 1, &vertex_buffer_.buffer, &offset);
+			vk.cmd_bind_index_buffer(command_buffer, index_buffer_.buffer, 0, VK_INDEX_TYPE_UINT32);
+			VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+			vk.cmd_set_viewport(command_buffer, 0, 1, &viewport);
+			VkRect2D scissor{{0, 0}, extent};
+			vk.cmd_set_scissor(command_buffer, 0, 1, &scissor);
+			bound = true;
+		}
+		const auto& used = atlases_[entry.atlas];
+		const auto extent = engine_->surface_manager()->swap_chain_extent(target.surface_index);
+		const details::overlay_push_constants constants{
+			{1.0f / static_cast<float>(extent.width), 1.0f / static_cast<float>(extent.height)},
+			used.coverage ? 1u : 0u
+		};
+		vk.cmd_push_constants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+		// a frame set, the atlas view changes whenever the texture manager streams it.
+		const auto set = engine_->descriptor_allocator()->allocate(set_layout_, {image_binding(
+			0,
+			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			engine_->texture_manager()->sampler(),
+			engine_->texture_manager()->image_view(used.texture),
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		)});
+		vk.cmd_bind_descriptor_sets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1, &set, 0, nullptr);
+		vk.cmd_draw_indexed(command_buffer, entry.vertex_count / 4 * 6, 1, 0, static_cast<int32_t>(entry.first_vertex), 0);
+	}
+}
+
+const overlay_renderer::glyph* overlay_renderer::find_glyph(const atlas& font, uint32_t codepoint) const noexcept {
+	if (codepoint < font.ascii.size()) {
+		return font.ascii[codepoint].present ? &font.ascii[codepoint] : nullptr;
+	}
+	auto it = font.glyphs.find(codepoint);
+	return it != font.glyphs.end() ? &it->second : nullptr;
+}
+
+std::vector<overlay_vertex>* overlay_renderer::batch_vertices(size_t surface_index, overlay_atlas_id atlas) {
+	if (quad_count_ >= max_quads_) {
+		++dropped_quads_;
+		return nullptr;
+	}
+	++quad_count_;
+	// consecutive calls nearly always go to the same batch.
+	if (last_batch_ < batches_.size() && batches_[last_batch_].surface_index == surface_index && batches_[last_batch_].atlas == atlas) {
+		return &batches_[last_batch_].vertices;
+	}
+	for (size_t i = 0; i < batches_.size(); ++i) {
+		if (batches_[i].surface_index == surface_index && batches_[i].atlas == atlas) {
+			last_batch_ = i;
+			return &batches_[i].vertices;
+		}
+	}
+	// batches stay around empty once created, so their vectors keep their capacity.
+	batches_.push_back({surface_index, atlas, {}, 0, 0});
+	last_batch_ = batches_.size() - 1;
+	return &batches_.back().vertices;
+}
+
+void overlay_renderer::push_quad(std::vector<overlay_vertex>& vertices, float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color) {
+	vertices.push_back({x0, y0, u0, v0, color});
+	vertices.push_back({x1, y0, u1, v0, color});
+	vertices.push_back({x1, y1, u1, v1, color});
+	vertices.push_back({x0, y1, u0, v1, color});
+}
+
+void overlay_renderer::create_pipeline() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto graphics_pipeline_manager = engine_->graphics_pipeline_manager();
+	vertex_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/overlay_vert.spv"));
+	fragment_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/overlay_frag.spv"));
+
+	VkDescriptorSetLayoutBinding atlas_binding{};
+	atlas_binding.binding = 0;
+	atlas_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	atlas_binding.descriptorCount = 1;
+	atlas_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	set_layout_ = engine_->layout_cache()->descriptor_set_layout({atlas_binding});
+	VkPushConstantRange push_constant_range{};
+	push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	push_constant_range.offset = 0;
+	push_constant_range.size = sizeof(details::overlay_push_constants);
+	pipeline_layout_ = engine_->layout_cache()->pipeline_layout({set_layout_}, {push_constant_range});
+
+	VkPipelineShaderStageCreateInfo shader_stages[2]{};
+	shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shader_stages[0].module = vertex_shader_module_;
+	shader_stages[0].pName = "main";
+	shader_stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shader_stages[1].module = fragment_shader_module_;
+	shader_stages[1].pName = "main";
+
+	VkVertexInputBindingDescription binding{};
+	binding.binding = 0;
+	binding.stride = sizeof(overlay_vertex);
+	binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	VkVertexInputAttributeDescription attributes[3]{};
+	attributes[0] = {0, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(overlay_vertex, x))};
+	attributes[1] = {1, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(overlay_vertex, u))};
+	attributes[2] = {2, 0, VK_FORMAT_R8G8B8A8_UNORM, static_cast<uint32_t>(offsetof(overlay_vertex, color))};
+
+	VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertex_input_info.vertexBindingDescriptionCount = 1;
+	vertex_input_info.pVertexBindingDescriptions = &binding;
+	vertex_input_info.vertexAttributeDescriptionCount = 3;
+	vertex_input_info.pVertexAttributeDescriptions = attributes;
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+	input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	input_assembly.primitiveRestartEnable = VK_FALSE;
+
+	VkPipelineViewportStateCreateInfo viewport_state{};
+	viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewport_state.viewportCount = 1;
+	viewport_state.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+	depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil.depthTestEnable = VK_FALSE;
+	depth_stencil.depthWriteEnable = VK_FALSE;
+
+	VkPipelineColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	color_blend_attachment.blendEnable = VK_TRUE;
+	color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	color_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+	color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	color_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo color_blending{};
+	color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	color_blending.logicOpEnable = VK_FALSE;
+	color_blending.attachmentCount = 1;
+	color_blending.pAttachments = &color_blend_attachment;
+
+	const VkDynamicState dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic_state{};
+	dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamic_state.dynamicStateCount = 2;
+	dynamic_state.pDynamicStates = dynamic_states;
+
+	VkGraphicsPipelineCreateInfo pipeline_info{};
+	pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipeline_info.stageCount = 2;
+	pipeline_info.pStages = shader_stages;
+	pipeline_info.pVertexInputState = &vertex_input_info;
+	pipeline_info.pInputAssemblyState = &input_assembly;
+	pipeline_info.pViewportState = &viewport_state;
+	pipeline_info.pRasterizationState = &rasterizer;
+	pipeline_info.pMultisampleState = &multisampling;
+	pipeline_info.pDepthStencilState = &depth_stencil;
+	pipeline_info.pColorBlendState = &color_blending;
+	pipeline_info.pDynamicState = &dynamic_state;
+	pipeline_info.layout = pipeline_layout_;
+	pipeline_info.renderPass = graphics_pipeline_manager->render_pass();
+	pipeline_info.subpass = engine_->post_processor()->composite_subpass();
+	pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+	if (vk.create_graphics_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create overlay pipeline"};
+	}
+}
+
+} // end namespace pg::gods_view
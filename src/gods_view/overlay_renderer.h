@@ -0,0 +1,192 @@
+#if !defined PG_GODS_VIEW_OVERLAY_RENDERER_HEADER_INCLUDED
+#define PG_GODS_VIEW_OVERLAY_RENDERER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/memory.h"
+#include "gods_view/surface_manager.h"
+#include "gods_view/texture_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pg::gods_view {
+
+using overlay_atlas_id = uint32_t;
+
+// rectangles are in pixels from the top left corner of the window.
+struct overlay_rect {
+	float x;
+	float y;
+	float width;
+	float height;
+};
+
+// one rasterized glyph as handed to `add_font`, `coverage` holds width * height bytes.
+struct overlay_glyph_bitmap {
+	uint32_t codepoint;
+	uint32_t width;
+	uint32_t height;
+	// from the pen position to the bitmap's left edge, and up from the baseline to its top.
+	int32_t bearing_x;
+	int32_t bearing_y;
+	float advance;
+	std::vector<uint8_t> coverage;
+};
+
+struct overlay_font_desc {
+	float line_height;
+	// baseline distance from the top of a line.
+	float ascent;
+	uint32_t atlas_size{512};
+	std::vector<overlay_glyph_bitmap> glyphs;
+};
+
+struct overlay_vertex {
+	float x;
+	float y;
+	float u;
+	float v;
+	// r8g8b8a8, see `overlay_color`.
+	uint32_t color;
+};
+
+struct overlay_stats {
+	uint32_t quads;
+	uint32_t draws;
+	// quads past `max_quads` this frame, they were not drawn.
+	uint32_t dropped_quads;
+};
+
+[[nodiscard]] constexpr uint32_t overlay_color(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) noexcept {
+	return static_cast<uint32_t>(r) | (static_cast<uint32_t>(g) << 8) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(a) << 24);
+}
+
+namespace details {
+
+constexpr uint32_t default_overlay_quads = 65536;
+// vertex regions written in turn, one per frame the draw manager can have in flight plus one.
+constexpr uint32_t overlay_regions = 2;
+// texels of solid white every font atlas keeps in its top left corner for `rect`.
+constexpr uint32_t overlay_white_texels = 2;
+constexpr uint32_t overlay_glyph_padding = 1;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// immediate style 2d layer drawn on top of each window: labels, hud panels and statistics.
+// calls only append quads to a cpu side batch per window and atlas, at the end of the frame
+// every batch is copied into one persistently mapped vertex buffer and drawn with a single
+// indexed draw, so thousands of labels cost a few draws rather than one per label.
+class overlay_renderer {
+private:
+	struct glyph {
+		float x_offset;
+		float y_offset;
+		float width;
+		float height;
+		float advance;
+		float u0;
+		float v0;
+		float u1;
+		float v1;
+		bool present;
+	};
+
+	struct atlas {
+		texture_id texture;
+		float inverse_width;
+		float inverse_height;
+		// single channel coverage rather than colour texels.
+		bool coverage;
+		float white_u;
+		float white_v;
+		float line_height;
+		float ascent;
+		std::array<glyph, 128> ascii;
+		std::unordered_map<uint32_t, glyph> glyphs;
+	};
+
+	struct batch {
+		size_t surface_index;
+		overlay_atlas_id atlas;
+		std::vector<overlay_vertex> vertices;
+		uint32_t first_vertex;
+		uint32_t vertex_count;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::vector<atlas> atlases_;
+	std::vector<batch> batches_;
+	size_t last_batch_;
+	gpu_buffer vertex_buffer_;
+	gpu_buffer index_buffer_;
+	uint32_t max_quads_;
+	uint32_t region_;
+	uint32_t quad_count_;
+	uint32_t dropped_quads_;
+	overlay_stats stats_;
+	VkDescriptorSetLayout set_layout_;
+	VkPipelineLayout pipeline_layout_;
+	VkShaderModule vertex_shader_module_;
+	VkShaderModule fragment_shader_module_;
+	VkPipeline pipeline_;
+
+public:
+	overlay_renderer(gods_view::vulkan_engine* init_engine);
+
+	~overlay_renderer();
+
+	overlay_renderer(const overlay_renderer&) = delete;
+
+	overlay_renderer& operator=(const overlay_renderer&) = delete;
+
+	// call once the render pass exists. quads past `max_quads` in a frame are dropped.
+	void initialize(uint32_t max_quads = details::default_overlay_quads);
+
+	// last frame's numbers.
+	[[nodiscard]] overlay_stats stats() const noexcept { return stats_; }
+
+	// packs the glyphs into a single channel atlas texture.
+	overlay_atlas_id add_font(const overlay_font_desc& font);
+
+	// an rgba texture of sprites, `white` is a texel of solid white used by `rect`.
+	overlay_atlas_id add_sprite_atlas(texture_id texture, uint32_t width, uint32_t height, VkOffset2D white = {0, 0});
+
+	// `texels` is the sprite's rectangle in the atlas.
+	void quad(size_t surface_index, overlay_atlas_id atlas, const overlay_rect& rect, const overlay_rect& texels, uint32_t color = overlay_color(255, 255, 255));
+
+	void rect(size_t surface_index, overlay_atlas_id atlas, const overlay_rect& rect, uint32_t color);
+
+	// utf-8 text with the top of its first line at `x`, `y`, returns the widest line's width.
+	float text(size_t surface_index, overlay_atlas_id font, float x, float y, std::string_view utf8, uint32_t color, float scale = 1.0f);
+
+	[[nodiscard]] float text_width(overlay_atlas_id font, std::string_view utf8, float scale = 1.0f) const;
+
+	[[nodiscard]] float line_height(overlay_atlas_id font, float scale = 1.0f) const noexcept { return atlases_[font].line_height * scale; }
+
+	// copies this frame's batches into the vertex buffer, called by the draw manager before recording.
+	void upload();
+
+	// draws the batches of `target`'s window, called inside its render pass.
+	void record(VkCommandBuffer command_buffer, const frame_target& target);
+
+private:
+	[[nodiscard]] const glyph* find_glyph(const atlas& font, uint32_t codepoint) const noexcept;
+
+	std::vector<overlay_vertex>* batch_vertices(size_t surface_index, overlay_atlas_id atlas);
+
+	void push_quad(std::vector<overlay_vertex>& vertices, float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, uint32_t color);
+
+	void create_pipeline();
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,143 @@
+#if !defined PG_GODS_VIEW_PIPELINE_STATE_HEADER_INCLUDED
+#define PG_GODS_VIEW_PIPELINE_STATE_HEADER_INCLUDED
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace pg::gods_view {
+
+// fixed function state a draw asks for. whatever the device can set while recording is
+// applied by `graphics_pipeline_manager::bind`, the rest selects a pipeline.
+struct pipeline_state {
+	VkPrimitiveTopology topology{VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+	bool primitive_restart{false};
+	VkPolygonMode polygon_mode{VK_POLYGON_MODE_FILL};
+	VkCullModeFlags cull_mode{VK_CULL_MODE_BACK_BIT};
+	VkFrontFace front_face{VK_FRONT_FACE_CLOCKWISE};
+	bool depth_bias{false};
+	bool depth_test{false};
+	bool depth_write{false};
+	VkCompareOp depth_compare{VK_COMPARE_OP_LESS_OR_EQUAL};
+	bool blend{false};
+	VkBlendFactor src_color_factor{VK_BLEND_FACTOR_SRC_ALPHA};
+	VkBlendFactor dst_color_factor{VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA};
+	VkBlendOp color_op{VK_BLEND_OP_ADD};
+	VkBlendFactor src_alpha_factor{VK_BLEND_FACTOR_ONE};
+	VkBlendFactor dst_alpha_factor{VK_BLEND_FACTOR_ZERO};
+	VkBlendOp alpha_op{VK_BLEND_OP_ADD};
+	VkColorComponentFlags color_write_mask{VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT};
+};
+
+// state the device lets command buffers set instead of baking it into pipelines.
+struct dynamic_state_support {
+	// VK_EXT_extended_dynamic_state: cull mode, front face, topology within its class and depth test.
+	bool extended{false};
+	// VK_EXT_extended_dynamic_state2: primitive restart and depth bias enable.
+	bool extended2{false};
+	// VK_EXT_extended_dynamic_state3, each is its own feature.
+	bool polygon_mode{false};
+	bool color_blend_enable{false};
+	bool color_blend_equation{false};
+	bool color_write_mask{false};
+};
+
+// the baked part of a `pipeline_state`, dynamic fields are left zero so states that only
+// differ in them share a pipeline.
+struct pipeline_key {
+	uint32_t topology{0};
+	uint32_t primitive_restart{0};
+	uint32_t polygon_mode{0};
+	uint32_t cull_mode{0};
+	uint32_t front_face{0};
+	uint32_t depth_bias{0};
+	uint32_t depth_test{0};
+	uint32_t depth_write{0};
+	uint32_t depth_compare{0};
+	uint32_t blend{0};
+	uint32_t blend_equation[6]{};
+	uint32_t color_write_mask{0};
+	// `specialization_info::key` split in words so the key has no padding.
+	uint32_t variant[2]{};
+	// the shaders the pipeline runs, a `pipeline_program`.
+	uint32_t program{0};
+
+	[[nodiscard]] bool operator==(const pipeline_key& other) const noexcept { return std::memcmp(this, &other, sizeof(pipeline_key)) == 0; }
+};
+
+static_assert(std::has_unique_object_representations_v<pipeline_key>, "pipeline_key is hashed and compared bytewise");
+
+namespace details {
+
+// dynamic topology may only move within the class the pipeline was built with.
+[[nodiscard]] constexpr VkPrimitiveTopology topology_class(VkPrimitiveTopology topology) noexcept {
+	switch (topology) {
+		case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+			return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+		case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+		case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+		case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+		case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+			return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+		case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+			return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+		default:
+			return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	}
+}
+
+[[nodiscard]] inline pipeline_key make_pipeline_key(const pipeline_state& state, const dynamic_state_support& support) noexcept {
+	pipeline_key key{};
+	key.topology = static_cast<uint32_t>(support.extended ? topology_class(state.topology) : state.topology);
+	if (!support.extended) {
+		key.cull_mode = static_cast<uint32_t>(state.cull_mode);
+		key.front_face = static_cast<uint32_t>(state.front_face);
+		key.depth_test = state.depth_test;
+		key.depth_write = state.depth_write;
+		key.depth_compare = static_cast<uint32_t>(state.depth_compare);
+	}
+	if (!support.extended2) {
+		key.primitive_restart = state.primitive_restart;
+		key.depth_bias = state.depth_bias;
+	}
+	if (!support.polygon_mode) {
+		key.polygon_mode = static_cast<uint32_t>(state.polygon_mode);
+	}
+	if (!support.color_blend_enable) {
+		key.blend = state.blend;
+	}
+	if (!support.color_blend_equation) {
+		key.blend_equation[0] = static_cast<uint32_t>(state.src_color_factor);
+		key.blend_equation[1] = static_cast<uint32_t>(state.dst_color_factor);
+		key.blend_equation[2] = static_cast<uint32_t>(state.color_op);
+		key.blend_equation[3] = static_cast<uint32_t>(state.src_alpha_factor);
+		key.blend_equation[4] = static_cast<uint32_t>(state.dst_alpha_factor);
+		key.blend_equation[5] = static_cast<uint32_t>(state.alpha_op);
+	}
+	if (!support.color_write_mask) {
+		key.color_write_mask = static_cast<uint32_t>(state.color_write_mask);
+	}
+	return key;
+}
+
+} // end namespace pg::gods_view::details
+
+struct pipeline_key_hash {
+	[[nodiscard]] size_t operator()(const pipeline_key& key) const noexcept {
+		// fnv-1a over the key's bytes.
+		uint64_t hash = 14695981039346656037ull;
+		const auto bytes = reinterpret_cast<const unsigned char*>(&key);
+		for (size_t i = 0; i < sizeof(pipeline_key); ++i) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,461 @@
+#include "gods_view/point_cloud_renderer.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace pg::gods_view {
+
+namespace details {
+
+struct point_cloud_push_constants {
+	float view_projection[16];
+	float point_size;
+};
+
+// where each level starts in a chunk's buffer, in vertices. the last entry is the chunk's size.
+static constexpr auto point_level_offsets = [] {
+	std::array<uint32_t, point_lod_levels + 1> offsets{};
+	for (uint32_t level = 0; level < point_lod_levels; ++level) {
+		offsets[level + 1] = offsets[level] + point_level_capacity(level);
+	}
+	return offsets;
+}();
+
+// device local memory the cpu can map is only worth it when it is more than the classic
+// 256 MiB window, which the chunks would soon run out of.
+constexpr VkDeviceSize point_mappable_heap_minimum = VkDeviceSize{256} << 20;
+
+static uint32_t point_level_count(uint32_t count, uint32_t level) noexcept {
+	if (count == 0) { return 0; }
+	// the kept points up to the latest one, then the latest point itself when it isn't kept.
+	return ((count - 1 + (1u << level) - 1) >> level) + 1;
+}
+
+static float point_distance(const float a[3], const float b[3]) noexcept {
+	const float x = a[0] - b[0];
+	const float y = a[1] - b[1];
+	const float z = a[2] - b[2];
+	return std::sqrt(x * x + y * y + z * z);
+}
+
+static bool mappable_device_memory(const VkPhysicalDeviceMemoryProperties& memory_properties) noexcept {
+	const VkMemoryPropertyFlags wanted = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	for (uint32_t type = 0; type < memory_properties.memoryTypeCount; ++type) {
+		const auto& memory_type = memory_properties.memoryTypes[type];
+		if ((memory_type.propertyFlags & wanted) == wanted &&
+			memory_properties.memoryHeaps[memory_type.heapIndex].size > point_mappable_heap_minimum)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+} // end namespace pg::gods_view::details
+
+point_cloud_renderer::point_cloud_renderer(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	settings_{},
+	point_size_range_{1.0f, 1.0f},
+	camera_{},
+	has_camera_{false},
+	chunk_memory_{0},
+	stats_{},
+	initialized_{false},
+	pipeline_layout_{VK_NULL_HANDLE},
+	vertex_shader_module_{VK_NULL_HANDLE},
+	fragment_shader_module_{VK_NULL_HANDLE},
+	points_pipeline_{VK_NULL_HANDLE},
+	lines_pipeline_{VK_NULL_HANDLE}
+{ }
+
+point_cloud_renderer::~point_cloud_renderer() {
+	if (!initialized_) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	vk.destroy_pipeline(device, lines_pipeline_, nullptr);
+	vk.destroy_pipeline(device, points_pipeline_, nullptr);
+	vk.destroy_shader_module(device, fragment_shader_module_, nullptr);
+	vk.destroy_shader_module(device, vertex_shader_module_, nullptr);
+	// the resource pool frees the chunk buffers.
+}
+
+void point_cloud_renderer::initialize(const point_cloud_settings& settings) {
+	validate(settings);
+	settings_ = settings;
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(engine_->device_manager()->physical_device(), &properties);
+	point_size_range_[0] = properties.limits.pointSizeRange[0];
+	point_size_range_[1] = properties.limits.pointSizeRange[1];
+	// chunks are written in place by the cpu; resizable bar or unified memory lets the gpu read
+	// them without crossing the bus every frame.
+	chunk_memory_ = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	if (details::mappable_device_memory(engine_->device_manager()->memory_properties())) {
+		chunk_memory_ |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	}
+	create_pipelines();
+	initialized_ = true;
+}
+
+void point_cloud_renderer::settings(const point_cloud_settings& settings) {
+	validate(settings);
+	settings_ = settings;
+}
+
+void point_cloud_renderer::camera(const point_cloud_camera& camera) noexcept {
+	camera_ = camera;
+	has_camera_ = true;
+	engine_->render_loop()->mark_dirty();
+}
+
+point_set_id point_cloud_renderer::create_set(point_primitive primitive) {
+	return sets_.create(primitive, 1, {}, {}, point_vertex{});
+}
+
+void point_cloud_renderer::destroy_set(point_set_id id) {
+	if (!sets_.valid(id)) { return; }
+	retire(sets_.get<chunks_column>(id));
+	sets_.get<pending_column>(id).clear();
+	sets_.destroy(id);
+	engine_->render_loop()->mark_dirty();
+}
+
+void point_cloud_renderer::visible(point_set_id id, bool visible) {
+	if (!sets_.valid(id)) { return; }
+	sets_.get<visible_column>(id) = visible ? 1 : 0;
+	engine_->render_loop()->mark_dirty();
+}
+
+void point_cloud_renderer::append(point_set_id id, const point_vertex* points, size_t count) {
+	if (!sets_.valid(id) || count == 0) { return; }
+	auto& pending = sets_.get<pending_column>(id);
+	pending.insert(pending.end(), points, points + count);
+	engine_->render_loop()->mark_dirty();
+}
+
+void point_cloud_renderer::clear(point_set_id id) {
+	if (!sets_.valid(id)) { return; }
+	retire(sets_.get<chunks_column>(id));
+	sets_.get<pending_column>(id).clear();
+	engine_->render_loop()->mark_dirty();
+}
+
+uint64_t point_cloud_renderer::point_count(point_set_id id) const noexcept {
+	if (!sets_.valid(id)) { return 0; }
+	const auto& owned = sets_.get<chunks_column>(id);
+	uint64_t count = sets_.get<pending_column>(id).size();
+	for (const auto index : owned) {
+		count += chunks_[index].count;
+	}
+	// every polyline chunk after the first repeats its predecessor's last point.
+	if (sets_.get<primitive_column>(id) == point_primitive::polyline && !owned.empty()) {
+		count -= owned.size() - 1;
+	}
+	return count;
+}
+
+void point_cloud_renderer::upload() {
+	if (!initialized_) { return; }
+	PG_GODS_VIEW_PROFILE_SCOPE("point cloud upload");
+	const uint64_t completed = engine_->draw_manager()->completed_frames();
+	for (auto it = retired_.begin(); it != retired_.end();) {
+		if (it->frame > completed) {
+			++it;
+			continue;
+		}
+		free_chunks_.insert(free_chunks_.end(), it->chunks.begin(), it->chunks.end());
+		it = retired_.erase(it);
+	}
+
+	stats_ = {};
+	sets_.for_each([this](point_set_id id) {
+		auto& owned = sets_.get<chunks_column>(id);
+		auto& pending = sets_.get<pending_column>(id);
+		auto& last = sets_.get<last_point_column>(id);
+		const bool polyline = sets_.get<primitive_column>(id) == point_primitive::polyline;
+		for (const auto& point : pending) {
+			if (owned.empty() || chunks_[owned.back()].count == details::point_chunk_capacity) {
+				const bool continues = polyline && !owned.empty();
+				owned.push_back(acquire_chunk());
+				// the strip carries on across the chunk boundary.
+				if (continues) { write_point(chunks_[owned.back()], last); }
+			}
+			auto& target = chunks_[owned.back()];
+			if (polyline && target.count > 0) {
+				target.path_length += details::point_distance(last.position, point.position);
+			}
+			write_point(target, point);
+			last = point;
+		}
+		pending.clear();
+		for (const auto index : owned) {
+			stats_.points_stored += chunks_[index].count;
+		}
+	});
+}
+
+void point_cloud_renderer::record(VkCommandBuffer command_buffer, VkExtent2D extent) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (!initialized_ || !has_camera_) { return; }
+	const float projection_scale = static_cast<float>(extent.height) / (2.0f * std::tan(camera_.vertical_fov * 0.5f));
+	auto resources = engine_->resource_pool();
+	VkPipeline bound{VK_NULL_HANDLE};
+	sets_.for_each([&](point_set_id id) {
+		if (sets_.get<visible_column>(id) == 0) { return; }
+		const auto primitive = sets_.get<primitive_column>(id);
+		const VkPipeline pipeline = primitive == point_primitive::points ? points_pipeline_ : lines_pipeline_;
+		const uint32_t minimum_count = primitive == point_primitive::points ? 1 : 2;
+		for (const auto index : sets_.get<chunks_column>(id)) {
+			const auto& source = chunks_[index];
+			if (source.count < minimum_count) { continue; }
+			if (outside_frustum(source)) {
+				++stats_.chunks_culled;
+				continue;
+			}
+			const uint32_t level = select_level(source, primitive, projection_scale);
+			const uint32_t count = details::point_level_count(source.count, level);
+			if (count < minimum_count) { continue; }
+			if (bound != pipeline) {
+				vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+				// both pipelines share the layout, the constants survive switching between them.
+				if (bound == VK_NULL_HANDLE) {
+					details::point_cloud_push_constants constants{};
+					std::copy(std::begin(camera_.view_projection), std::end(camera_.view_projection), constants.view_projection);
+					constants.point_size = std::clamp(settings_.point_size, point_size_range_[0], point_size_range_[1]);
+					vk.cmd_push_constants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+				}
+				bound = pipeline;
+			}
+			const VkBuffer buffer = resources->buffer(source.buffer);
+			const VkDeviceSize offset{0};
+			vk.cmd_bind_vertex_buffers(command_buffer, 0, 1, &buffer, &offset);
+			vk.cmd_draw(command_buffer, count, 1, details::point_level_offsets[level], 0);
+			++stats_.chunks_drawn;
+			stats_.points_drawn += count;
+		}
+	});
+}
+
+void point_cloud_renderer::validate(const point_cloud_settings& settings) const {
+	if (!(settings.point_size > 0.0f)) {
+		throw std::runtime_error{"Invalid point cloud settings"};
+	}
+	// without the feature the shader's point size is read as 1 whatever it writes.
+	if (settings.point_size != 1.0f && !engine_->device_manager()->large_points()) {
+		throw std::runtime_error{"Point sizes other than 1 need the large points feature"};
+	}
+}
+
+void point_cloud_renderer::retire(std::vector<uint32_t>& chunks) {
+	if (chunks.empty()) { return; }
+	// the frame being recorded next may still draw them, so they wait for its fence.
+	retired_.push_back({std::move(chunks), engine_->draw_manager()->submitted_frames() + 1});
+	chunks.clear();
+}
+
+uint32_t point_cloud_renderer::acquire_chunk() {
+	uint32_t index;
+	if (!free_chunks_.empty()) {
+		index = free_chunks_.back();
+		free_chunks_.pop_back();
+	} else {
+		auto resources = engine_->resource_pool();
+		const auto buffer = resources->create_buffer(
+			static_cast<VkDeviceSize>(details::point_level_offsets[details::point_lod_levels]) * sizeof(point_vertex),
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+			chunk_memory_
+		);
+		index = static_cast<uint32_t>(chunks_.size());
+		chunks_.push_back({buffer, static_cast<point_vertex*>(resources->mapped(buffer)), 0, {}, {}, 0.0f});
+	}
+	auto& target = chunks_[index];
+	target.count = 0;
+	target.path_length = 0.0f;
+	std::fill(std::begin(target.bounds_min), std::end(target.bounds_min), std::numeric_limits<float>::max());
+	std::fill(std::begin(target.bounds_max), std::end(target.bounds_max), std::numeric_limits<float>::lowest());
+	return index;
+}
+
+void point_cloud_renderer::write_point(chunk& target, const point_vertex& point) noexcept {
+	const uint32_t index = target.count++;
+	for (uint32_t level = 0; level < details::point_lod_levels; ++level) {
+		// a point level `level` keeps lands in its own slot, any other one in the slot after
+		// the last kept point, where the next kept point overwrites it.
+		const uint32_t slot = (index + (1u << level) - 1) >> level;
+		target.mapped[details::point_level_offsets[level] + slot] = point;
+	}
+	for (size_t axis = 0; axis < 3; ++axis) {
+		target.bounds_min[axis] = std::min(target.bounds_min[axis], point.position[axis]);
+		target.bounds_max[axis] = std::max(target.bounds_max[axis], point.position[axis]);
+	}
+}
+
+uint32_t point_cloud_renderer::select_level(const chunk& source, point_primitive primitive, float projection_scale) const noexcept {
+	float distance_squared{0.0f};
+	for (size_t axis = 0; axis < 3; ++axis) {
+		const float outside = std::max({source.bounds_min[axis] - camera_.eye[axis], 0.0f, camera_.eye[axis] - source.bounds_max[axis]});
+		distance_squared += outside * outside;
+	}
+	if (distance_squared <= 0.0f) { return 0; }
+	const float pixels_per_unit = projection_scale / std::sqrt(distance_squared);
+
+	// the spacing of level 0's points. a polyline's is its mean segment length; a cloud is
+	// taken to fill its bounds, so its spacing grows with the cube root of the points dropped.
+	const auto count = static_cast<float>(source.count);
+	const bool polyline = primitive == point_primitive::polyline;
+	const float spacing = polyline
+		? source.path_length / std::max(count - 1.0f, 1.0f)
+		: details::point_distance(source.bounds_min, source.bounds_max) / std::cbrt(count);
+	for (uint32_t level = details::point_lod_levels - 1; level > 0; --level) {
+		const auto dropped = static_cast<float>(1u << level);
+		const float level_spacing = polyline ? spacing * dropped : spacing * std::cbrt(dropped);
+		if (level_spacing * pixels_per_unit <= settings_.max_screen_error) { return level; }
+	}
+	return 0;
+}
+
+bool point_cloud_renderer::outside_frustum(const chunk& source) const noexcept {
+	// a chunk is out when all eight corners of its bounds are beyond the same clip plane.
+	uint32_t outside_all = 0x3f;
+	for (uint32_t corner = 0; corner < 8; ++corner) {
+		const float position[3] = {
+			(corner & 1) != 0 ? source.bounds_max[0] : source.bounds_min[0],
+			(corner & 2) != 0 ? source.bounds_max[1] : source.bounds_min[1],
+			(corner & 4) != 0 ? source.bounds_max[2] : source.bounds_min[2]
+		};
+		float clip[4];
+		for (size_t row = 0; row < 4; ++row) {
+			const float* m = camera_.view_projection;
+			clip[row] = m[row] * position[0] + m[4 + row] * position[1] + m[8 + row] * position[2] + m[12 + row];
+		}
+		uint32_t outside{0};
+		outside |= clip[0] < -clip[3] ? 0x01u : 0u;
+		outside |= clip[0] > clip[3] ? 0x02u : 0u;
+		outside |= clip[1] < -clip[3] ? 0x04u : 0u;
+		outside |= clip[1] > clip[3] ? 0x08u : 0u;
+		outside |= clip[2] < 0.0f ? 0x10u : 0u;
+		outside |= clip[2] > clip[3] ? 0x20u : 0u;
+		outside_all &= outside;
+		if (outside_all == 0) { return false; }
+	}
+	return true;
+}
+
+void point_cloud_renderer::create_pipelines() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto graphics_pipeline_manager = engine_->graphics_pipeline_manager();
+	vertex_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/point_cloud_vert.spv"));
+	fragment_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/point_cloud_frag.spv"));
+
+	VkPushConstantRange push_constant_range{};
+	push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	push_constant_range.offset = 0;
+	push_constant_range.size = sizeof(details::point_cloud_push_constants);
+	pipeline_layout_ = engine_->layout_cache()->pipeline_layout({}, {push_constant_range});
+
+	VkPipelineShaderStageCreateInfo shader_stages[2]{};
+	shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shader_stages[0].module = vertex_shader_module_;
+	shader_stages[0].pName = "main";
+	shader_stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shader_stages[1].module = fragment_shader_module_;
+	shader_stages[1].pName = "main";
+
+	VkVertexInputBindingDescription binding{};
+	binding.binding = 0;
+	binding.stride = sizeof(point_vertex);
+	binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	VkVertexInputAttributeDescription attributes[2]{};
+	attributes[0] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(point_vertex, position))};
+	attributes[1] = {1, 0, VK_FORMAT_R8G8B8A8_UNORM, static_cast<uint32_t>(offsetof(point_vertex, color))};
+
+	VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertex_input_info.vertexBindingDescriptionCount = 1;
+	vertex_input_info.pVertexBindingDescriptions = &binding;
+	vertex_input_info.vertexAttributeDescriptionCount = 2;
+	vertex_input_info.pVertexAttributeDescriptions = attributes;
+
+	// the two pipelines differ only in topology.
+	VkPipelineInputAssemblyStateCreateInfo input_assembly[2]{};
+	input_assembly[0].sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	input_assembly[0].topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+	input_assembly[0].primitiveRestartEnable = VK_FALSE;
+	input_assembly[1] = input_assembly[0];
+	input_assembly[1].topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+
+	VkPipelineViewportStateCreateInfo viewport_state{};
+	viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewport_state.viewportCount = 1;
+	viewport_state.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+	depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil.depthTestEnable = VK_FALSE;
+	depth_stencil.depthWriteEnable = VK_FALSE;
+
+	VkPipelineColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	color_blend_attachment.blendEnable = VK_TRUE;
+	color_blend_attachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	color_blend_attachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.colorBlendOp = VK_BLEND_OP_ADD;
+	color_blend_attachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	color_blend_attachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	color_blend_attachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo color_blending{};
+	color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	color_blending.logicOpEnable = VK_FALSE;
+	color_blending.attachmentCount = 1;
+	color_blending.pAttachments = &color_blend_attachment;
+
+	const VkDynamicState dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic_state{};
+	dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamic_state.dynamicStateCount = 2;
+	dynamic_state.pDynamicStates = dynamic_states;
+
+	VkGraphicsPipelineCreateInfo pipeline_info[2]{};
+	pipeline_info[0].sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipeline_info[0].stageCount = 2;
+	pipeline_info[0].pStages = shader_stages;
+	pipeline_info[0].pVertexInputState = &vertex_input_info;
+	pipeline_info[0].pInputAssemblyState = &input_assembly[0];
+	pipeline_info[0].pViewportState = &viewport_state;
+	pipeline_info[0].pRasterizationState = &rasterizer;
+	pipeline_info[0].pMultisampleState = &multisampling;
+	pipeline_info[0].pDepthStencilState = &depth_stencil;
+	pipeline_info[0].pColorBlendState = &color_blending;
+	pipeline_info[0].pDynamicState = &dynamic_state;
+	pipeline_info[0].layout = pipeline_layout_;
+	pipeline_info[0].renderPass = graphics_pipeline_manager->render_pass();
+	pipeline_info[0].subpass = 0;
+	pipeline_info[0].basePipelineHandle = VK_NULL_HANDLE;
+	pipeline_info[1] = pipeline_info[0];
+	pipeline_info[1].pInputAssemblyState = &input_assembly[1];
+	VkPipeline pipelines[2];
+	if (vk.create_graphics_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 2, pipeline_info, nullptr, pipelines) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create point cloud pipelines"};
+	}
+	points_pipeline_ = pipelines[0];
+	lines_pipeline_ = pipelines[1];
+}
+
+} // end namespace pg::gods_view
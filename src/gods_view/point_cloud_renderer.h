@@ -0,0 +1,179 @@
+#if !defined PG_GODS_VIEW_POINT_CLOUD_RENDERER_HEADER_INCLUDED
+#define PG_GODS_VIEW_POINT_CLOUD_RENDERER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/handle_pool.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+using point_set_id = handle<struct point_set_tag>;
+
+enum class point_primitive : uint32_t {
+	points = 0,
+	// one line strip through the points in the order they were appended.
+	polyline = 1
+};
+
+struct point_vertex {
+	float position[3];
+	// r8g8b8a8, see `overlay_color`.
+	uint32_t color;
+};
+
+// column major, as the shaders take it.
+struct point_cloud_camera {
+	float view_projection[16];
+	float eye[3];
+	float vertical_fov;
+};
+
+struct point_cloud_settings {
+	// coarsest level whose point spacing projects below this many pixels is drawn.
+	float max_screen_error{1.5f};
+	// anything but 1 needs the large points feature, clamped to the device's point size range.
+	float point_size{1.0f};
+};
+
+struct point_cloud_stats {
+	uint64_t points_stored;
+	uint64_t points_drawn;
+	uint32_t chunks_drawn;
+	uint32_t chunks_culled;
+};
+
+namespace details {
+
+constexpr uint32_t point_chunk_capacity = 16384;
+// level k keeps every 2^k-th point of a chunk.
+constexpr uint32_t point_lod_levels = 8;
+
+// vertex slots level `level` of a full chunk needs, its kept points plus one for the latest point.
+[[nodiscard]] constexpr uint32_t point_level_capacity(uint32_t level) noexcept {
+	return ((point_chunk_capacity - 1) >> level) + 2;
+}
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// large point clouds and polylines, such as lidar sweeps or vehicle tracks, that keep growing
+// while they are on screen. points live in fixed size chunks of persistently mapped vertex
+// memory, each chunk also holding decimated copies of itself. every frame a chunk outside the
+// frustum is skipped and the others draw the coarsest level whose point spacing stays under
+// `max_screen_error` pixels at their distance, so far away chunks cost a fraction of their points.
+// appends are queued and written in `upload`, after the frame fence, never under the gpu's reads.
+class point_cloud_renderer {
+private:
+	static constexpr std::size_t primitive_column = 0;
+	static constexpr std::size_t visible_column = 1;
+	static constexpr std::size_t chunks_column = 2;
+	static constexpr std::size_t pending_column = 3;
+	static constexpr std::size_t last_point_column = 4;
+
+	struct chunk {
+		buffer_handle buffer;
+		point_vertex* mapped;
+		uint32_t count;
+		float bounds_min[3];
+		float bounds_max[3];
+		// summed segment lengths, the spacing estimate of polyline chunks.
+		float path_length;
+	};
+
+	struct retired_chunks {
+		std::vector<uint32_t> chunks;
+		uint64_t frame;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	point_cloud_settings settings_;
+	// the device's smallest and largest point size.
+	float point_size_range_[2];
+	point_cloud_camera camera_;
+	bool has_camera_;
+	handle_pool<point_set_id, point_primitive, uint8_t, std::vector<uint32_t>, std::vector<point_vertex>, point_vertex> sets_;
+	std::vector<chunk> chunks_;
+	// chunks whose buffers wait to be reused by the next set that grows.
+	std::vector<uint32_t> free_chunks_;
+	std::vector<retired_chunks> retired_;
+	VkMemoryPropertyFlags chunk_memory_;
+	point_cloud_stats stats_;
+	bool initialized_;
+	VkPipelineLayout pipeline_layout_;
+	VkShaderModule vertex_shader_module_;
+	VkShaderModule fragment_shader_module_;
+	VkPipeline points_pipeline_;
+	VkPipeline lines_pipeline_;
+
+public:
+	point_cloud_renderer(gods_view::vulkan_engine* init_engine);
+
+	~point_cloud_renderer();
+
+	point_cloud_renderer(const point_cloud_renderer&) = delete;
+
+	point_cloud_renderer& operator=(const point_cloud_renderer&) = delete;
+
+	// call once the render pass exists.
+	void initialize(const point_cloud_settings& settings = {});
+
+	[[nodiscard]] const point_cloud_settings& settings() const noexcept { return settings_; }
+
+	void settings(const point_cloud_settings& settings);
+
+	// nothing is drawn until the camera is set.
+	void camera(const point_cloud_camera& camera) noexcept;
+
+	// last frame's numbers.
+	[[nodiscard]] point_cloud_stats stats() const noexcept { return stats_; }
+
+	point_set_id create_set(point_primitive primitive);
+
+	// its chunks are reused once the frame drawing them last has completed.
+	void destroy_set(point_set_id id);
+
+	[[nodiscard]] bool valid(point_set_id id) const noexcept { return sets_.valid(id); }
+
+	void visible(point_set_id id, bool visible);
+
+	// queued until the next frame's `upload`, a polyline continues from its last point.
+	void append(point_set_id id, const point_vertex* points, size_t count);
+
+	void append(point_set_id id, const std::vector<point_vertex>& points) { append(id, points.data(), points.size()); }
+
+	// empties the set, it keeps its primitive and can be appended to again.
+	void clear(point_set_id id);
+
+	[[nodiscard]] uint64_t point_count(point_set_id id) const noexcept;
+
+	// writes queued appends into the chunks, called by the draw manager once the frame fence is waited on.
+	void upload();
+
+	// draws every visible set, called inside the scene pass with its extent.
+	void record(VkCommandBuffer command_buffer, VkExtent2D extent);
+
+private:
+	void validate(const point_cloud_settings& settings) const;
+
+	void retire(std::vector<uint32_t>& chunks);
+
+	uint32_t acquire_chunk();
+
+	void write_point(chunk& target, const point_vertex& point) noexcept;
+
+	[[nodiscard]] uint32_t select_level(const chunk& source, point_primitive primitive, float projection_scale) const noexcept;
+
+	[[nodiscard]] bool outside_frustum(const chunk& source) const noexcept;
+
+	void create_pipelines();
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,444 @@
+#include "gods_view/post_processor.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pg::gods_view {
+
+namespace details {
+
+static bool blendable_attachment(VkPhysicalDevice physical_device, VkFormat format) {
+	VkFormatProperties properties{};
+	vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
+	const VkFormatFeatureFlags wanted = VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT | VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT;
+	return (properties.optimalTilingFeatures & wanted) == wanted;
+}
+
+} // end namespace pg::gods_view::details
+
+post_processor::post_processor(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	settings_{},
+	enabled_{false},
+	lut_dirty_{false},
+	lut_initialized_{false},
+	scene_format_{VK_FORMAT_UNDEFINED},
+	sampler_{VK_NULL_HANDLE},
+	passthrough_render_pass_{VK_NULL_HANDLE},
+	set_layout_{VK_NULL_HANDLE},
+	pipeline_layout_{VK_NULL_HANDLE},
+	vertex_shader_module_{VK_NULL_HANDLE},
+	fragment_shader_module_{VK_NULL_HANDLE},
+	pipeline_{VK_NULL_HANDLE}
+{ }
+
+post_processor::~post_processor() {
+	if (!enabled_) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto& target : scene_targets_) {
+		details::destroy_image(vk, target);
+	}
+	if (pipeline_ != VK_NULL_HANDLE) {
+		vk.destroy_pipeline(device, pipeline_, nullptr);
+		vk.destroy_shader_module(device, fragment_shader_module_, nullptr);
+		vk.destroy_shader_module(device, vertex_shader_module_, nullptr);
+		vk.destroy_render_pass(device, passthrough_render_pass_, nullptr);
+	}
+	vk.destroy_sampler(device, sampler_, nullptr);
+	details::destroy_image(vk, lut_);
+}
+
+void post_processor::initialize(const post_settings& settings) {
+	validate(settings);
+	const auto& vk = engine_->device_manager()->dispatch();
+	settings_ = settings;
+	// rgba16 is required to be renderable and blendable, the packed float format isn't.
+	scene_format_ = details::blendable_attachment(engine_->device_manager()->physical_device(), VK_FORMAT_B10G11R11_UFLOAT_PACK32)
+		? VK_FORMAT_B10G11R11_UFLOAT_PACK32
+		: VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	VkSamplerCreateInfo sampler_info{};
+	sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	sampler_info.magFilter = VK_FILTER_LINEAR;
+	sampler_info.minFilter = VK_FILTER_LINEAR;
+	sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	if (vk.create_sampler(engine_->device_manager()->logical_device(), &sampler_info, nullptr, &sampler_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create color grading sampler"};
+	}
+	lut_ = details::create_image(
+		vk,
+		engine_->device_manager()->memory_properties(),
+		VK_FORMAT_R16G16B16A16_SFLOAT,
+		{details::color_grade_lut_size * details::color_grade_lut_size, details::color_grade_lut_size},
+		1,
+		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+	);
+	lut_dirty_ = true;
+	enabled_ = true;
+}
+
+void post_processor::settings(const post_settings& settings) {
+	validate(settings);
+	settings_ = settings;
+	lut_dirty_ = true;
+}
+
+VkRenderPass post_processor::create_render_pass(VkFormat output_format, VkImageLayout output_final_layout, VkAttachmentLoadOp scene_load_op) const {
+	const auto& vk = engine_->device_manager()->dispatch();
+	VkAttachmentDescription attachments[2]{};
+	// the post subpass covers every pixel, whatever was there before is never read.
+	attachments[0].format = output_format;
+	attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[0].finalLayout = output_final_layout;
+	// consumed inside the pass, so it is never stored.
+	attachments[1].format = scene_format_;
+	attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachments[1].loadOp = scene_load_op;
+	attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachments[1].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	const VkAttachmentReference scene_color_ref{1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	const VkAttachmentReference scene_input_ref{1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+	const VkAttachmentReference output_ref{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription subpasses[2]{};
+	subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpasses[0].colorAttachmentCount = 1;
+	subpasses[0].pColorAttachments = &scene_color_ref;
+	subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpasses[1].inputAttachmentCount = 1;
+	subpasses[1].pInputAttachments = &scene_input_ref;
+	subpasses[1].colorAttachmentCount = 1;
+	subpasses[1].pColorAttachments = &output_ref;
+
+	// the same dependencies for every output, passes stay compatible when only layouts and
+	// load ops differ. the last frame's use of both attachments ends before they are written,
+	// sampled outputs wait for the post subpass, and the hand over between the subpasses is
+	// per pixel, which is what lets a tiler keep the scene in tile memory.
+	VkSubpassDependency dependencies[4]{};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].dstSubpass = 1;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].srcAccessMask = 0;
+	dependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[2].srcSubpass = 0;
+	dependencies[2].dstSubpass = 1;
+	dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[2].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[2].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+	dependencies[2].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+	dependencies[3].srcSubpass = 1;
+	dependencies[3].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[3].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[3].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[3].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[3].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	VkRenderPassCreateInfo renderpass_info{};
+	renderpass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderpass_info.attachmentCount = 2;
+	renderpass_info.pAttachments = attachments;
+	renderpass_info.subpassCount = 2;
+	renderpass_info.pSubpasses = subpasses;
+	renderpass_info.dependencyCount = 4;
+	renderpass_info.pDependencies = dependencies;
+	VkRenderPass render_pass;
+	if (vk.create_render_pass(engine_->device_manager()->logical_device(), &renderpass_info, nullptr, &render_pass) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create post processing render pass"};
+	}
+	return render_pass;
+}
+
+gpu_image post_processor::create_scene_attachment(VkExtent2D extent) const {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const auto& memory_properties = engine_->device_manager()->memory_properties();
+	gpu_image result{};
+
+	VkImageCreateInfo image_info{};
+	image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image_info.imageType = VK_IMAGE_TYPE_2D;
+	image_info.format = scene_format_;
+	image_info.extent = {extent.width, extent.height, 1};
+	image_info.mipLevels = 1;
+	image_info.arrayLayers = 1;
+	image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+	image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+	image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	if (vk.create_image(vk.device, &image_info, nullptr, &result.image) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create image"};
+	}
+
+	VkMemoryRequirements requirements;
+	vk.get_image_memory_requirements(vk.device, result.image, &requirements);
+	// lazily allocated memory is only ever committed if the attachment spills out of tile memory.
+	const bool lazy = details::find_memory_type(memory_properties, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT).has_value();
+	result.memory = details::allocate_memory(vk, memory_properties, requirements, lazy ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	result.size = requirements.size;
+	if (vk.bind_image_memory(vk.device, result.image, result.memory, 0) != VK_SUCCESS) {
+		vk.free_memory(vk.device, result.memory, nullptr);
+		vk.destroy_image(vk.device, result.image, nullptr);
+		throw std::runtime_error{"Failed to bind scene attachment memory"};
+	}
+
+	VkImageViewCreateInfo view_info{};
+	view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	view_info.image = result.image;
+	view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	view_info.format = scene_format_;
+	view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	view_info.subresourceRange.baseMipLevel = 0;
+	view_info.subresourceRange.levelCount = 1;
+	view_info.subresourceRange.baseArrayLayer = 0;
+	view_info.subresourceRange.layerCount = 1;
+	if (vk.create_image_view(vk.device, &view_info, nullptr, &result.view) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create image view"};
+	}
+	return result;
+}
+
+void post_processor::destroy_scene_attachment(gpu_image& attachment) {
+	engine_->descriptor_allocator()->invalidate_view(attachment.view);
+	resolve_sets_.erase(
+		std::remove_if(resolve_sets_.begin(), resolve_sets_.end(), [&attachment](const resolve_set& entry) { return entry.scene == attachment.view; }),
+		resolve_sets_.end()
+	);
+	details::destroy_image(engine_->device_manager()->dispatch(), attachment);
+	attachment = {};
+}
+
+void post_processor::create_targets() {
+	if (!enabled_) { return; }
+	if (pipeline_ == VK_NULL_HANDLE) {
+		create_pipeline();
+		passthrough_render_pass_ = create_render_pass(
+			engine_->surface_manager()->swap_chain_image_format(),
+			VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			VK_ATTACHMENT_LOAD_OP_DONT_CARE
+		);
+	}
+	auto surface_manager = engine_->surface_manager();
+	for (size_t surface = scene_targets_.size(); surface < surface_manager->surface_count(); ++surface) {
+		scene_targets_.push_back(create_scene_attachment(surface_manager->swap_chain_extent(surface)));
+	}
+	// the window's attachment and the resolution scaler's, so resolving never grows it mid frame.
+	resolve_sets_.reserve(scene_targets_.size() * 2);
+}
+
+void post_processor::recreate_target(size_t surface_index) {
+	if (!enabled_) { return; }
+	destroy_scene_attachment(scene_targets_[surface_index]);
+	scene_targets_[surface_index] = create_scene_attachment(engine_->surface_manager()->swap_chain_extent(surface_index));
+}
+
+void post_processor::update() {
+	if (!enabled_ || !lut_dirty_) { return; }
+	lut_dirty_ = false;
+	// ahead of the frame's render passes, the draw manager's fence keeps the last frame's
+	// lookups out of the way.
+	engine_->command_manager()->record_inline([this](VkCommandBuffer command_buffer) { bake_lut(command_buffer); });
+}
+
+void post_processor::resolve(VkCommandBuffer command_buffer, VkImageView scene, VkExtent2D extent) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+	VkViewport viewport{0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f};
+	vk.cmd_set_viewport(command_buffer, 0, 1, &viewport);
+	VkRect2D scissor{{0, 0}, extent};
+	vk.cmd_set_scissor(command_buffer, 0, 1, &scissor);
+
+	const details::post_push_constants constants{
+		std::exp2(settings_.exposure),
+		static_cast<float>(details::color_grade_lut_size)
+	};
+	vk.cmd_push_constants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+	// attachments and the lut keep their views, so each scene's set is only fetched the first
+	// time and kept until one of them changes.
+	auto resolve_set = std::find_if(resolve_sets_.begin(), resolve_sets_.end(), [scene](const auto& entry) { return entry.scene == scene; });
+	if (resolve_set == resolve_sets_.end()) {
+		resolve_set = resolve_sets_.insert(resolve_sets_.end(), {scene, VK_NULL_HANDLE, VK_NULL_HANDLE});
+	}
+	if (resolve_set->lut != lut_.view) {
+		resolve_set->set = engine_->descriptor_allocator()->cached(set_layout_, {
+			image_binding(0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, VK_NULL_HANDLE, scene, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL),
+			image_binding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampler_, lut_.view, VK_IMAGE_LAYOUT_GENERAL)
+		});
+		resolve_set->lut = lut_.view;
+	}
+	vk.cmd_bind_descriptor_sets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1, &resolve_set->set, 0, nullptr);
+	vk.cmd_draw(command_buffer, 3, 1, 0, 0);
+}
+
+void post_processor::validate(const post_settings& settings) const {
+	for (size_t channel = 0; channel < 3; ++channel) {
+		if (settings.gamma[channel] <= 0.0f || settings.gain[channel] < 0.0f) {
+			throw std::runtime_error{"Invalid post processing settings"};
+		}
+	}
+	if (settings.contrast <= 0.0f || settings.saturation < 0.0f) {
+		throw std::runtime_error{"Invalid post processing settings"};
+	}
+}
+
+void post_processor::bake_lut(VkCommandBuffer command_buffer) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	// the lut stays in the general layout, written here and sampled by the post subpass.
+	if (!lut_initialized_) {
+		details::transition_image_layout(
+			vk,
+			command_buffer,
+			lut_.image,
+			VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_GENERAL,
+			0,
+			VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+		);
+		lut_initialized_ = true;
+	}
+	details::color_grade_push_constants constants{};
+	for (size_t channel = 0; channel < 3; ++channel) {
+		constants.lift[channel] = settings_.lift[channel];
+		constants.gamma[channel] = settings_.gamma[channel];
+		constants.gain[channel] = settings_.gain[channel];
+	}
+	constants.contrast = settings_.contrast;
+	constants.saturation = settings_.saturation;
+	constants.size = details::color_grade_lut_size;
+
+	const auto& compute = engine_->compute_pipeline_manager()->pipeline("shaders/color_grade_comp.spv");
+	const auto set = engine_->descriptor_allocator()->cached(compute.set_layouts.front(), {
+		image_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_NULL_HANDLE, lut_.view, VK_IMAGE_LAYOUT_GENERAL)
+	});
+	engine_->compute_pipeline_manager()->dispatch(
+		command_buffer,
+		compute,
+		details::color_grade_lut_size * details::color_grade_lut_size / details::color_grade_group_size,
+		details::color_grade_lut_size / details::color_grade_group_size,
+		1,
+		{set},
+		&constants
+	);
+}
+
+void post_processor::create_pipeline() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto graphics_pipeline_manager = engine_->graphics_pipeline_manager();
+	vertex_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/post_vert.spv"));
+	fragment_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/post_frag.spv"));
+
+	VkDescriptorSetLayoutBinding bindings[2]{};
+	bindings[0].binding = 0;
+	bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+	bindings[0].descriptorCount = 1;
+	bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	bindings[1].binding = 1;
+	bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	bindings[1].descriptorCount = 1;
+	bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	set_layout_ = engine_->layout_cache()->descriptor_set_layout({bindings[0], bindings[1]});
+	VkPushConstantRange push_constant_range{};
+	push_constant_range.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	push_constant_range.offset = 0;
+	push_constant_range.size = sizeof(details::post_push_constants);
+	pipeline_layout_ = engine_->layout_cache()->pipeline_layout({set_layout_}, {push_constant_range});
+
+	VkPipelineShaderStageCreateInfo shader_stages[2]{};
+	shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shader_stages[0].module = vertex_shader_module_;
+	shader_stages[0].pName = "main";
+	shader_stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shader_stages[1].module = fragment_shader_module_;
+	shader_stages[1].pName = "main";
+
+	VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+	input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	input_assembly.primitiveRestartEnable = VK_FALSE;
+
+	VkPipelineViewportStateCreateInfo viewport_state{};
+	viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewport_state.viewportCount = 1;
+	viewport_state.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+	depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil.depthTestEnable = VK_FALSE;
+	depth_stencil.depthWriteEnable = VK_FALSE;
+
+	VkPipelineColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	color_blend_attachment.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendStateCreateInfo color_blending{};
+	color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	color_blending.logicOpEnable = VK_FALSE;
+	color_blending.attachmentCount = 1;
+	color_blending.pAttachments = &color_blend_attachment;
+
+	const VkDynamicState dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic_state{};
+	dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamic_state.dynamicStateCount = 2;
+	dynamic_state.pDynamicStates = dynamic_states;
+
+	VkGraphicsPipelineCreateInfo pipeline_info{};
+	pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipeline_info.stageCount = 2;
+	pipeline_info.pStages = shader_stages;
+	pipeline_info.pVertexInputState = &vertex_input_info;
+	pipeline_info.pInputAssemblyState = &input_assembly;
+	pipeline_info.pViewportState = &viewport_state;
+	pipeline_info.pRasterizationState = &rasterizer;
+	pipeline_info.pMultisampleState = &multisampling;
+	pipeline_info.pDepthStencilState = &depth_stencil;
+	pipeline_info.pColorBlendState = &color_blending;
+	pipeline_info.pDynamicState = &dynamic_state;
+	pipeline_info.layout = pipeline_layout_;
+	pipeline_info.renderPass = graphics_pipeline_manager->render_pass();
+	pipeline_info.subpass = 1;
+	pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+	if (vk.create_graphics_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create post processing pipeline"};
+	}
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,152 @@
+#if !defined PG_GODS_VIEW_POST_PROCESSOR_HEADER_INCLUDED
+#define PG_GODS_VIEW_POST_PROCESSOR_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/memory.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+// grading works on the tonemapped colour, in [0, 1].
+struct post_settings {
+	// scales the scene's linear colour before tonemapping, in stops.
+	float exposure{0.0f};
+	// around middle grey, 1 leaves the image as it is.
+	float contrast{1.0f};
+	// 0 is greyscale.
+	float saturation{1.0f};
+	float lift[3]{0.0f, 0.0f, 0.0f};
+	float gamma[3]{1.0f, 1.0f, 1.0f};
+	float gain[3]{1.0f, 1.0f, 1.0f};
+};
+
+namespace details {
+
+// entries per axis of the grading lut, stored as `size` slices side by side in one 2d image.
+constexpr uint32_t color_grade_lut_size = 32;
+constexpr uint32_t color_grade_group_size = 8;
+
+struct post_push_constants {
+	float exposure_scale;
+	float lut_size;
+};
+
+struct color_grade_push_constants {
+	float lift[4];
+	float gamma[4];
+	float gain[4];
+	float contrast;
+	float saturation;
+	uint32_t size;
+};
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// tonemapping, colour grading and the overlay composite without a full screen pass of their
+// own. the window pass gets two subpasses: the scene renders into a transient hdr attachment
+// in the first, and the second reads it back as an input attachment, so on tiled gpus the hdr
+// colour never leaves tile memory and elsewhere it is written and read once. tonemapping and
+// the grading lut lookup are one fragment shader, the overlay draws on top in the same subpass.
+// grading itself is baked into the lut by a compute dispatch whenever the settings change.
+// with the resolution scaler on, its scene pass has the same two subpasses at render
+// resolution, and the window pass only upscales the graded image in its second subpass.
+class post_processor {
+private:
+	struct resolve_set {
+		VkImageView scene;
+		VkImageView lut;
+		VkDescriptorSet set;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	post_settings settings_;
+	bool enabled_;
+	bool lut_dirty_;
+	bool lut_initialized_;
+	VkFormat scene_format_;
+	// the windows' hdr attachments, by surface index.
+	std::vector<gpu_image> scene_targets_;
+	// one per scene attachment resolved so far, looked up again only when a view changed.
+	std::vector<resolve_set> resolve_sets_;
+	gpu_image lut_;
+	VkSampler sampler_;
+	VkRenderPass passthrough_render_pass_;
+	VkDescriptorSetLayout set_layout_;
+	VkPipelineLayout pipeline_layout_;
+	VkShaderModule vertex_shader_module_;
+	VkShaderModule fragment_shader_module_;
+	VkPipeline pipeline_;
+
+public:
+	post_processor(gods_view::vulkan_engine* init_engine);
+
+	~post_processor();
+
+	post_processor(const post_processor&) = delete;
+
+	post_processor& operator=(const post_processor&) = delete;
+
+	// call after the swap chain's image views and before the render pass is created, which
+	// then gets the scene and post subpasses.
+	void initialize(const post_settings& settings = {});
+
+	[[nodiscard]] bool enabled() const noexcept { return enabled_; }
+
+	[[nodiscard]] const post_settings& settings() const noexcept { return settings_; }
+
+	// the lut is baked again at the start of the next frame.
+	void settings(const post_settings& settings);
+
+	// b10g11r11 where the device can render and blend into it, half the bytes of rgba16.
+	[[nodiscard]] VkFormat scene_format() const noexcept { return scene_format_; }
+
+	// where the overlay and anything else drawn on the final colour goes.
+	[[nodiscard]] uint32_t composite_subpass() const noexcept { return enabled_ ? 1 : 0; }
+
+	// compatible with the window pass, for windows whose scene subpass stays empty because
+	// the resolution scaler drew the scene elsewhere; the hdr attachment is neither cleared nor stored.
+	[[nodiscard]] VkRenderPass passthrough_render_pass() const noexcept { return passthrough_render_pass_; }
+
+	[[nodiscard]] VkImageView scene_view(size_t surface_index) const noexcept { return scene_targets_[surface_index].view; }
+
+	// attachment 0 is the graded output, attachment 1 the hdr scene. passes made with any
+	// arguments are compatible with each other, so pipelines work in all of them.
+	[[nodiscard]] VkRenderPass create_render_pass(VkFormat output_format, VkImageLayout output_final_layout, VkAttachmentLoadOp scene_load_op) const;
+
+	// an hdr attachment for `create_render_pass`'s framebuffers, transient so it needs no
+	// memory on gpus that keep it in tiles.
+	[[nodiscard]] gpu_image create_scene_attachment(VkExtent2D extent) const;
+
+	// frees an attachment from `create_scene_attachment` and forgets the sets that resolved it.
+	void destroy_scene_attachment(gpu_image& attachment);
+
+	// hdr attachments for windows added since the last call, and the tonemap pipeline the first time.
+	void create_targets();
+
+	// the window's hdr attachment again at its swap chain's current extent, after a resize.
+	void recreate_target(size_t surface_index);
+
+	// bakes the lut when the settings changed, called by the draw manager before recording.
+	void update();
+
+	// tonemaps and grades `scene` into the output, inside the second subpass.
+	void resolve(VkCommandBuffer command_buffer, VkImageView scene, VkExtent2D extent);
+
+private:
+	void validate(const post_settings& settings) const;
+
+	void bake_lut(VkCommandBuffer command_buffer);
+
+	void create_pipeline();
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,197 @@
+#include "gods_view/profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace pg::gods_view {
+
+namespace details {
+
+static std::atomic<profiler*> active_profiler{nullptr};
+static std::atomic<uint64_t> profiler_instances{0};
+
+struct profiler_thread_cache {
+	uint64_t instance{0};
+	void* buffer{nullptr};
+	std::string name;
+};
+
+static thread_local profiler_thread_cache profiler_thread{};
+
+static void write_json_string(std::ofstream& file, std::string_view text) {
+	file << '"';
+	for (const char c : text) {
+		if (c == '"' || c == '\\') {
+			file << '\\' << c;
+		} else if (static_cast<unsigned char>(c) < 0x20) {
+			file << ' ';
+		} else {
+			file << c;
+		}
+	}
+	file << '"';
+}
+
+// chrome traces count in microseconds.
+static void write_trace_event(std::ofstream& file, bool& first, const char* name, uint32_t tid, int64_t begin, uint64_t duration) {
+	file << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"name\":";
+	first = false;
+	write_json_string(file, name);
+	file << ",\"ts\":" << static_cast<double>(begin) * 1e-3 << ",\"dur\":" << static_cast<double>(duration) * 1e-3 << '}';
+}
+
+static void write_thread_name(std::ofstream& file, bool& first, uint32_t tid, std::string_view name) {
+	file << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+	first = false;
+	write_json_string(file, name);
+	file << "}}";
+}
+
+} // end namespace pg::gods_view::details
+
+profiler::thread_buffer::thread_buffer(std::string init_name, uint32_t init_id, size_t init_capacity) :
+	name{std::move(init_name)},
+	id{init_id},
+	events{std::make_unique<profile_event[]>(init_capacity)},
+	capacity{init_capacity},
+	count{0},
+	dropped{0}
+{ }
+
+void profiler::thread_buffer::push(const char* event_name, uint64_t begin, uint64_t end) noexcept {
+	// only the owning thread pushes, the release store publishes the event to export.
+	const size_t index = count.load(std::memory_order_relaxed);
+	if (index == capacity) {
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	events[index] = {event_name, begin, end};
+	count.store(index + 1, std::memory_order_release);
+}
+
+profiler::profiler() :
+	instance_{details::profiler_instances.fetch_add(1) + 1},
+	epoch_{std::chrono::steady_clock::now()},
+	capturing_{false},
+	gpu_{"gpu", 0, details::gpu_profile_events},
+	gpu_offset_{std::numeric_limits<int64_t>::min()},
+	gpu_calibrated_{false}
+{
+	details::active_profiler.store(this);
+}
+
+profiler::~profiler() {
+	auto self = this;
+	details::active_profiler.compare_exchange_strong(self, nullptr);
+}
+
+profiler* profiler::active() noexcept {
+	return details::active_profiler.load(std::memory_order_acquire);
+}
+
+void profiler::name_thread(const std::string& name) {
+	details::profiler_thread.name = name;
+	auto active_profiler = active();
+	if (active_profiler == nullptr || details::profiler_thread.instance != active_profiler->instance_) { return; }
+	std::lock_guard lock{active_profiler->mutex_};
+	static_cast<thread_buffer*>(details::profiler_thread.buffer)->name = name;
+}
+
+profiler_stats profiler::stats() {
+	std::lock_guard lock{mutex_};
+	profiler_stats stats{0, 0, static_cast<uint32_t>(threads_.size())};
+	for (const auto& thread : threads_) {
+		stats.events += thread->count.load(std::memory_order_acquire);
+		stats.dropped += thread->dropped.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
+void profiler::start() {
+	{
+		std::lock_guard lock{mutex_};
+		for (auto& thread : threads_) {
+			thread->count.store(0, std::memory_order_relaxed);
+			thread->dropped.store(0, std::memory_order_relaxed);
+		}
+		gpu_.count.store(0, std::memory_order_relaxed);
+		gpu_.dropped.store(0, std::memory_order_relaxed);
+	}
+	capturing_.store(true);
+}
+
+void profiler::stop() noexcept {
+	capturing_.store(false);
+}
+
+void profiler::record(const char* name, uint64_t begin, uint64_t end) noexcept {
+	thread_buffer* buffer{nullptr};
+	try {
+		buffer = local_buffer();
+	} catch (...) {
+		// a thread that can't get a buffer goes unrecorded rather than failing the scope.
+		return;
+	}
+	buffer->push(name, begin, end);
+}
+
+void profiler::gpu_span(const char* name, uint64_t gpu_begin, uint64_t gpu_end, uint64_t cpu_before) noexcept {
+	if (!capturing()) { return; }
+	const auto offset = static_cast<int64_t>(cpu_before) - static_cast<int64_t>(gpu_begin);
+	auto current = gpu_offset_.load(std::memory_order_relaxed);
+	while (offset > current && !gpu_offset_.compare_exchange_weak(current, offset, std::memory_order_relaxed)) { }
+	gpu_calibrated_.store(true, std::memory_order_relaxed);
+	gpu_.push(name, gpu_begin, gpu_end);
+}
+
+void profiler::export_chrome_trace(const std::string& filename) {
+	std::ofstream file{filename, std::ios::trunc};
+	if (!file.is_open()) {
+		throw std::runtime_error{"Failed to open profile file"};
+	}
+	file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	std::lock_guard lock{mutex_};
+	for (const auto& thread : threads_) {
+		details::write_thread_name(file, first, thread->id, thread->name.empty() ? "thread " + std::to_string(thread->id) : thread->name);
+		const size_t count = thread->count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; ++i) {
+			const auto& event = thread->events[i];
+			details::write_trace_event(file, first, event.name, thread->id, static_cast<int64_t>(event.begin), event.end - event.begin);
+		}
+	}
+	if (gpu_calibrated_.load(std::memory_order_relaxed)) {
+		// a track of its own below the cpu threads, the id can't clash with theirs.
+		const auto gpu_tid = static_cast<uint32_t>(threads_.size() + 1);
+		const auto offset = gpu_offset_.load(std::memory_order_relaxed);
+		details::write_thread_name(file, first, gpu_tid, gpu_.name);
+		const size_t count = gpu_.count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; ++i) {
+			const auto& event = gpu_.events[i];
+			details::write_trace_event(file, first, event.name, gpu_tid, static_cast<int64_t>(event.begin) + offset, event.end - event.begin);
+		}
+	}
+	file << "\n]}\n";
+	if (!file) {
+		throw std::runtime_error{"Failed to write profile file"};
+	}
+}
+
+profiler::thread_buffer* profiler::local_buffer() {
+	auto& cache = details::profiler_thread;
+	if (cache.instance == instance_) {
+		return static_cast<thread_buffer*>(cache.buffer);
+	}
+	std::lock_guard lock{mutex_};
+	const auto id = static_cast<uint32_t>(threads_.size() + 1);
+	threads_.push_back(std::make_unique<thread_buffer>(cache.name, id, details::profile_events_per_thread));
+	cache.instance = instance_;
+	cache.buffer = threads_.back().get();
+	return threads_.back().get();
+}
+
+} // end namespace pg::gods_view
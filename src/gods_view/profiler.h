@@ -0,0 +1,167 @@
+#if !defined PG_GODS_VIEW_PROFILER_HEADER_INCLUDED
+#define PG_GODS_VIEW_PROFILER_HEADER_INCLUDED
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// scope markers are compiled into debug builds, release builds opt in by defining PG_GODS_VIEW_PROFILE.
+#if !defined PG_GODS_VIEW_PROFILE && !defined NDEBUG
+#define PG_GODS_VIEW_PROFILE
+#endif
+
+#define PG_GODS_VIEW_PROFILE_CONCAT_INNER(a, b) a##b
+#define PG_GODS_VIEW_PROFILE_CONCAT(a, b) PG_GODS_VIEW_PROFILE_CONCAT_INNER(a, b)
+
+#if defined PG_GODS_VIEW_PROFILE
+// times the rest of the enclosing block. `name` has to outlive the capture, a string literal.
+#define PG_GODS_VIEW_PROFILE_SCOPE(name) \
+	::pg::gods_view::profile_scope PG_GODS_VIEW_PROFILE_CONCAT(pg_gods_view_profile_scope_, __LINE__){name}
+// labels the calling thread's track in exported traces.
+#define PG_GODS_VIEW_PROFILE_THREAD(name) ::pg::gods_view::profiler::name_thread(name)
+#else
+#define PG_GODS_VIEW_PROFILE_SCOPE(name) ((void)0)
+#define PG_GODS_VIEW_PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace pg::gods_view {
+
+struct profile_event {
+	const char* name;
+	// nanoseconds since the profiler was created.
+	uint64_t begin;
+	uint64_t end;
+};
+
+struct profiler_stats {
+	uint64_t events;
+	// scopes closed while their thread's buffer was full.
+	uint64_t dropped;
+	uint32_t threads;
+};
+
+namespace details {
+
+constexpr size_t profile_events_per_thread = 1 << 15;
+constexpr size_t gpu_profile_events = 1 << 12;
+
+} // end namespace pg::gods_view::details
+
+// collects cpu scopes from every thread that runs engine code, and gpu spans around each
+// frame when the resolution scaler measures them. every thread writes to a buffer of its
+// own with a single release store per scope, so recording takes no lock; the mutex only
+// guards a thread's first scope, which registers its buffer, and export. buffers don't
+// wrap, a capture keeps its first `profile_events_per_thread` scopes per thread. the trace
+// is exported as chrome trace json, which chrome://tracing and perfetto both open.
+class profiler {
+private:
+	struct thread_buffer {
+		std::string name;
+		uint32_t id;
+		std::unique_ptr<profile_event[]> events;
+		size_t capacity;
+		std::atomic<size_t> count;
+		std::atomic<uint64_t> dropped;
+
+		thread_buffer(std::string init_name, uint32_t init_id, size_t init_capacity);
+
+		void push(const char* name, uint64_t begin, uint64_t end) noexcept;
+	};
+
+	// tells thread local buffer caches of a profiler apart from those of one created at the same address.
+	uint64_t instance_;
+	std::chrono::steady_clock::time_point epoch_;
+	std::atomic<bool> capturing_;
+	std::mutex mutex_;
+	std::vector<std::unique_ptr<thread_buffer>> threads_;
+	// gpu spans in the gpu's own clock, moved onto the cpu's at export.
+	thread_buffer gpu_;
+	// latest cpu time known to be before a gpu span began, minus that span's begin.
+	std::atomic<int64_t> gpu_offset_;
+	std::atomic<bool> gpu_calibrated_;
+
+public:
+	profiler();
+
+	~profiler();
+
+	profiler(const profiler&) = delete;
+
+	profiler& operator=(const profiler&) = delete;
+
+	// the profiler scopes record into, the most recently created engine's.
+	[[nodiscard]] static profiler* active() noexcept;
+
+	// names the calling thread's track, before or after it records its first scope.
+	static void name_thread(const std::string& name);
+
+	[[nodiscard]] bool capturing() const noexcept { return capturing_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] uint64_t now() const noexcept {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count());
+	}
+
+	[[nodiscard]] profiler_stats stats();
+
+	// drops what an earlier capture recorded. call between frames, a scope still open from
+	// before may land in either capture.
+	void start();
+
+	void stop() noexcept;
+
+	void record(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+	// a gpu span in nanoseconds of the gpu clock. `cpu_before` is a cpu time known to precede
+	// the span, such as when its command buffer finished recording; the latest of those
+	// bounds lines the gpu clock up with the cpu's, since an idle queue starts work right
+	// after submission.
+	void gpu_span(const char* name, uint64_t gpu_begin, uint64_t gpu_end, uint64_t cpu_before) noexcept;
+
+	// writes everything captured so far. safe while capturing, scopes still being closed are left out.
+	void export_chrome_trace(const std::string& filename);
+
+private:
+	thread_buffer* local_buffer();
+};
+
+// see PG_GODS_VIEW_PROFILE_SCOPE.
+class profile_scope {
+private:
+	profiler* profiler_;
+	const char* name_;
+	uint64_t begin_;
+
+public:
+	explicit profile_scope(const char* name) noexcept :
+		profiler_{profiler::active()},
+		name_{name},
+		begin_{0}
+	{
+		if (profiler_ != nullptr && !profiler_->capturing()) {
+			profiler_ = nullptr;
+		}
+		if (profiler_ != nullptr) {
+			begin_ = profiler_->now();
+		}
+	}
+
+	~profile_scope() {
+		if (profiler_ != nullptr) {
+			profiler_->record(name_, begin_, profiler_->now());
+		}
+	}
+
+	profile_scope(const profile_scope&) = delete;
+
+	profile_scope& operator=(const profile_scope&) = delete;
+};
+
+} // end namespace pg::gods_view
+
+#endif
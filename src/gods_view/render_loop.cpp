@@ -0,0 +1,176 @@
+#include "gods_view/render_loop.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace pg::gods_view {
+
+namespace details {
+
+// frames drawn only to pick up streamed data don't need to run faster than this.
+constexpr double render_loop_streaming_interval = 1.0 / 30.0;
+// how long the loop keeps pumping events before retrying a submit the render thread turned away.
+constexpr double render_loop_backpressure_timeout = 0.001;
+
+struct window_refresh_hook {
+	GLFWwindow* window;
+	// whatever the application had installed, still called first.
+	GLFWwindowrefreshfun previous;
+	std::atomic<bool> requested;
+};
+
+// windows a loop listens on. glfw callbacks only carry the window, and they run on the thread
+// pumping events, which is the loop's own.
+static std::vector<std::unique_ptr<window_refresh_hook>> window_refresh_hooks;
+
+static window_refresh_hook* find_refresh_hook(GLFWwindow* window) noexcept {
+	for (auto& hook : window_refresh_hooks) {
+		if (hook->window == window) { return hook.get(); }
+	}
+	return nullptr;
+}
+
+static void on_window_refresh(GLFWwindow* window) {
+	auto hook = find_refresh_hook(window);
+	if (hook == nullptr) { return; }
+	if (hook->previous != nullptr) {
+		hook->previous(window);
+	}
+	hook->requested.store(true);
+}
+
+static window_refresh_hook* hook_window_refresh(GLFWwindow* window) {
+	// a loop left through an exception keeps its hooks, the next one picks them up again.
+	if (auto hook = find_refresh_hook(window)) { return hook; }
+	auto hook = std::make_unique<window_refresh_hook>();
+	hook->window = window;
+	hook->previous = nullptr;
+	hook->requested.store(false);
+	auto result = hook.get();
+	window_refresh_hooks.push_back(std::move(hook));
+	result->previous = glfwSetWindowRefreshCallback(window, on_window_refresh);
+	return result;
+}
+
+static void unhook_window_refresh(GLFWwindow* window) {
+	auto it = std::find_if(window_refresh_hooks.begin(), window_refresh_hooks.end(), [window](const auto& hook) {
+		return hook->window == window;
+	});
+	if (it == window_refresh_hooks.end()) { return; }
+	glfwSetWindowRefreshCallback(window, (*it)->previous);
+	window_refresh_hooks.erase(it);
+}
+
+} // end namespace pg::gods_view::details
+
+render_loop::render_loop(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	dirty_{true},
+	continuous_{false},
+	target_frame_rate_{0.0},
+	idle_timeout_{details::render_loop_idle_timeout},
+	frames_rendered_{0},
+	idle_wakeups_{0}
+{ }
+
+void render_loop::mark_dirty() noexcept {
+	if (!dirty_.exchange(true)) {
+		glfwPostEmptyEvent();
+	}
+}
+
+void render_loop::run(const std::function<bool()>& should_close) {
+	using clock = std::chrono::steady_clock;
+	auto surface_manager = engine_->surface_manager();
+
+	// content lost while a window was covered comes back through its refresh callback, one the
+	// application set is chained rather than replaced.
+	std::vector<bool> presentable(surface_manager->surface_count(), false);
+	std::vector<details::window_refresh_hook*> refresh_hooks(surface_manager->surface_count());
+	for (size_t surface = 0; surface < surface_manager->surface_count(); ++surface) {
+		refresh_hooks[surface] = details::hook_window_refresh(surface_manager->window(surface));
+	}
+
+	PG_GODS_VIEW_PROFILE_THREAD("events");
+	dirty_.store(true);
+	auto next_frame = clock::now();
+	while (!should_close()) {
+		{
+			PG_GODS_VIEW_PROFILE_SCOPE("poll events");
+			glfwPollEvents();
+		}
+		for (auto hook : refresh_hooks) {
+			if (hook->requested.exchange(false)) {
+				dirty_.store(true);
+			}
+		}
+		// a window coming back from minimized or hidden shows whatever it last presented.
+		for (size_t surface = 0; surface < presentable.size(); ++surface) {
+			const bool now_presentable = surface_manager->presentable(surface);
+			if (now_presentable && !presentable[surface]) {
+				dirty_.store(true);
+			}
+			presentable[surface] = now_presentable;
+		}
+
+		if (!needs_frame()) {
+			PG_GODS_VIEW_PROFILE_SCOPE("idle");
+			++idle_wakeups_;
+			glfwWaitEventsTimeout(idle_timeout_);
+			continue;
+		}
+
+		{
+			PG_GODS_VIEW_PROFILE_SCOPE("frame limiter");
+			wait_until(next_frame);
+		}
+		const bool requested = dirty_.exchange(false) || continuous_;
+		if (engine_->render_thread()->running()) {
+			// the render thread is still a full queue behind, the frame goes out with the next packet.
+			if (!engine_->render_thread()->submit()) {
+				if (requested) { dirty_.store(true); }
+				glfwWaitEventsTimeout(details::render_loop_backpressure_timeout);
+				continue;
+			}
+		} else {
+			engine_->draw_manager()->draw_frame();
+		}
+		++frames_rendered_;
+
+		double interval = target_frame_rate_ > 0.0 ? 1.0 / target_frame_rate_ : 0.0;
+		if (!requested) {
+			interval = std::max(interval, details::render_loop_streaming_interval);
+		}
+		next_frame = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>{interval});
+	}
+	for (auto hook : refresh_hooks) {
+		details::unhook_window_refresh(hook->window);
+	}
+}
+
+bool render_loop::any_window_presentable() const {
+	auto surface_manager = engine_->surface_manager();
+	for (size_t surface = 0; surface < surface_manager->surface_count(); ++surface) {
+		if (surface_manager->presentable(surface)) { return true; }
+	}
+	return false;
+}
+
+bool render_loop::needs_frame() const {
+	if (!any_window_presentable()) { return false; }
+	if (dirty_.load() || continuous_) { return true; }
+	// the managers belong to the render thread while it runs, it reports their state after each frame.
+	if (engine_->render_thread()->running()) { return engine_->render_thread()->streaming(); }
+	return engine_->texture_manager()->busy() || engine_->mesh_manager()->busy() || engine_->capture_manager()->busy();
+}
+
+void render_loop::wait_until(std::chrono::steady_clock::time_point deadline) const {
+	// keeps handling input while the frame limiter holds the next frame back.
+	for (auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now()) {
+		glfwWaitEventsTimeout(std::chrono::duration<double>{deadline - now}.count());
+	}
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,78 @@
+#if !defined PG_GODS_VIEW_RENDER_LOOP_HEADER_INCLUDED
+#define PG_GODS_VIEW_RENDER_LOOP_HEADER_INCLUDED
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace pg::gods_view {
+
+struct render_loop_stats {
+	uint64_t frames_rendered;
+	// wake ups that found nothing to draw.
+	uint64_t idle_wakeups;
+};
+
+namespace details {
+
+constexpr double render_loop_idle_timeout = 0.5;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// drives draw_frame only when there is something to show. while the scene is clean, every
+// window is minimized or hidden, or nothing is streaming in, the loop blocks in
+// glfwWaitEventsTimeout; otherwise frames are paced to the target frame rate. while the
+// engine's render thread runs, frames are handed to it as packets instead of drawn here.
+class render_loop {
+private:
+	gods_view::vulkan_engine* engine_;
+	std::atomic<bool> dirty_;
+	bool continuous_;
+	double target_frame_rate_;
+	double idle_timeout_;
+	uint64_t frames_rendered_;
+	uint64_t idle_wakeups_;
+
+public:
+	render_loop(gods_view::vulkan_engine* init_engine);
+
+	[[nodiscard]] bool continuous() const noexcept { return continuous_; }
+
+	// a continuously animated scene renders every frame without being marked dirty.
+	void continuous(bool enabled) noexcept { continuous_ = enabled; }
+
+	[[nodiscard]] double target_frame_rate() const noexcept { return target_frame_rate_; }
+
+	// frames per second to cap rendering at, 0 leaves pacing to presentation.
+	void target_frame_rate(double frame_rate) noexcept { target_frame_rate_ = frame_rate; }
+
+	[[nodiscard]] double idle_timeout() const noexcept { return idle_timeout_; }
+
+	// longest the loop sleeps without events, bounds how late `should_close` is seen.
+	void idle_timeout(double seconds) noexcept { idle_timeout_ = seconds; }
+
+	[[nodiscard]] render_loop_stats stats() const noexcept { return {frames_rendered_, idle_wakeups_}; }
+
+	// requests a redraw. safe from any thread, wakes the loop if it is waiting.
+	void mark_dirty() noexcept;
+
+	void run(const std::function<bool()>& should_close);
+
+private:
+	[[nodiscard]] bool any_window_presentable() const;
+
+	[[nodiscard]] bool needs_frame() const;
+
+	void wait_until(std::chrono::steady_clock::time_point deadline) const;
+};
+
+} // end namespace pg::gods_view
+
+#endif
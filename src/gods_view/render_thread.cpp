@@ -0,0 +1,135 @@
+#include "gods_view/render_thread.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <utility>
+
+namespace pg::gods_view {
+
+render_thread::render_thread(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	running_{false},
+	stopping_{false},
+	streaming_{false},
+	queued_{0},
+	frames_drawn_{0},
+	packets_rejected_{0}
+{ }
+
+render_thread::~render_thread() {
+	if (!thread_.joinable()) { return; }
+	stopping_.store(true);
+	{
+		std::lock_guard lock{wake_mutex_};
+	}
+	wake_.notify_one();
+	thread_.join();
+}
+
+void render_thread::start() {
+	if (running()) { return; }
+	stopping_.store(false);
+	running_.store(true, std::memory_order_relaxed);
+	thread_ = std::thread{[this]() { run(); }};
+}
+
+void render_thread::stop() {
+	if (!thread_.joinable()) { return; }
+	stopping_.store(true);
+	{
+		std::lock_guard lock{wake_mutex_};
+	}
+	wake_.notify_one();
+	thread_.join();
+	running_.store(false, std::memory_order_relaxed);
+	// calls enqueued after the last submit still apply, the engine is single threaded again.
+	for (auto& command : building_.commands) {
+		command();
+	}
+	building_.commands.clear();
+	rethrow();
+}
+
+void render_thread::enqueue(std::function<void()> command) {
+	building_.commands.push_back(std::move(command));
+}
+
+bool render_thread::submit() {
+	PG_GODS_VIEW_PROFILE_SCOPE("submit packet");
+	rethrow();
+	auto surface_manager = engine_->surface_manager();
+	building_.presentable.resize(surface_manager->surface_count());
+	for (size_t surface = 0; surface < building_.presentable.size(); ++surface) {
+		building_.presentable[surface] = surface_manager->presentable(surface);
+	}
+	// swapped rather than moved, both sides keep their vectors' capacity from frame to frame.
+	const bool pushed = packets_.try_push([this](frame_packet& slot) noexcept {
+		std::swap(slot.commands, building_.commands);
+		std::swap(slot.presentable, building_.presentable);
+	});
+	if (!pushed) {
+		++packets_rejected_;
+		return false;
+	}
+	building_.commands.clear();
+	if (queued_.fetch_add(1) == 0) {
+		// the render thread may be parked, the lock orders the wake after its check.
+		std::lock_guard lock{wake_mutex_};
+		wake_.notify_one();
+	}
+	return true;
+}
+
+void render_thread::run() {
+	PG_GODS_VIEW_PROFILE_THREAD("render");
+	frame_packet packet{};
+	for (;;) {
+		const bool popped = packets_.try_pop([&packet](frame_packet& slot) {
+			std::swap(packet.commands, slot.commands);
+			std::swap(packet.presentable, slot.presentable);
+		});
+		if (popped) {
+			queued_.fetch_sub(1);
+			try {
+				draw(packet);
+			} catch (...) {
+				std::lock_guard lock{wake_mutex_};
+				error_ = std::current_exception();
+				return;
+			}
+			packet.commands.clear();
+			continue;
+		}
+		std::unique_lock lock{wake_mutex_};
+		if (stopping_.load()) { return; }
+		wake_.wait(lock, [this]() { return queued_.load() != 0 || stopping_.load(); });
+	}
+}
+
+void render_thread::draw(frame_packet& packet) {
+	{
+		PG_GODS_VIEW_PROFILE_SCOPE("packet commands");
+		for (auto& command : packet.commands) {
+			command();
+		}
+	}
+	engine_->draw_manager()->draw_frame(packet.presentable);
+	frames_drawn_.fetch_add(1, std::memory_order_relaxed);
+	streaming_.store(
+		engine_->texture_manager()->busy() || engine_->mesh_manager()->busy() || engine_->capture_manager()->busy(),
+		std::memory_order_relaxed
+	);
+}
+
+void render_thread::rethrow() {
+	std::exception_ptr error;
+	{
+		std::lock_guard lock{wake_mutex_};
+		std::swap(error, error_);
+	}
+	if (error) {
+		running_.store(false, std::memory_order_relaxed);
+		std::rethrow_exception(error);
+	}
+}
+
+} // end namespace pg::gods_view
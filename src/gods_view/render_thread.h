@@ -0,0 +1,105 @@
+#if !defined PG_GODS_VIEW_RENDER_THREAD_HEADER_INCLUDED
+#define PG_GODS_VIEW_RENDER_THREAD_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/lock_free_ring.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pg::gods_view {
+
+// everything the event thread hands over for one frame.
+struct frame_packet {
+	// engine calls made while the packet was built, run on the render thread before its frame.
+	std::vector<std::function<void()>> commands;
+	// each window's presentability as glfw reported it, glfw may only be asked from the event thread.
+	std::vector<bool> presentable;
+};
+
+struct render_thread_stats {
+	uint64_t frames_drawn;
+	// submits turned away because the render thread was a full queue behind.
+	uint64_t packets_rejected;
+};
+
+namespace details {
+
+// frames the event thread may build ahead of the one being drawn.
+constexpr size_t render_packet_capacity = 2;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// moves frame submission off the thread that pumps glfw events. the event thread collects
+// engine calls into a frame packet and hands it over through a bounded lock free ring; the
+// render thread applies the calls, then records, submits and presents the frame. fence
+// waits and presentation therefore never hold up input, and slow event handling never
+// holds up a frame already handed over. while it runs, every engine call from the event
+// thread has to go through `enqueue`.
+class render_thread {
+private:
+	gods_view::vulkan_engine* engine_;
+	mpsc_ring<frame_packet, details::render_packet_capacity> packets_;
+	frame_packet building_;
+	std::thread thread_;
+	std::atomic<bool> running_;
+	std::atomic<bool> stopping_;
+	// texture, mesh or capture work is outstanding as of the last frame drawn.
+	std::atomic<bool> streaming_;
+	std::atomic<uint32_t> queued_;
+	std::atomic<uint64_t> frames_drawn_;
+	uint64_t packets_rejected_;
+	// only parks the render thread while the ring is empty, packets never pass through it.
+	std::mutex wake_mutex_;
+	std::condition_variable wake_;
+	std::exception_ptr error_;
+
+public:
+	render_thread(gods_view::vulkan_engine* init_engine);
+
+	~render_thread();
+
+	render_thread(const render_thread&) = delete;
+
+	render_thread& operator=(const render_thread&) = delete;
+
+	[[nodiscard]] bool running() const noexcept { return running_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] bool streaming() const noexcept { return streaming_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] render_thread_stats stats() const noexcept { return {frames_drawn_.load(std::memory_order_relaxed), packets_rejected_}; }
+
+	// call from the event thread once the engine is fully initialized.
+	void start();
+
+	// draws what is still queued, then joins. rethrows an error the render thread hit.
+	void stop();
+
+	// event thread only. runs `command` on the render thread ahead of the packet's frame.
+	void enqueue(std::function<void()> command);
+
+	// event thread only. hands the packet built so far to the render thread; false when the
+	// ring is full, the packet then keeps collecting calls for a later submit. rethrows an
+	// error the render thread hit.
+	bool submit();
+
+private:
+	void run();
+
+	void draw(frame_packet& packet);
+
+	void rethrow();
+};
+
+} // end namespace pg::gods_view
+
+#endif
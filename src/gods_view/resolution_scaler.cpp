@@ -0,0 +1,455 @@
+#include "gods_view/resolution_scaler.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace pg::gods_view {
+
+resolution_scaler::resolution_scaler(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	settings_{},
+	scale_{1.0f},
+	gpu_ms_{0.0},
+	enabled_{false},
+	measured_{false},
+	pending_{false},
+	recorded_{0},
+	timestamp_period_{0.0},
+	timestamp_mask_{0},
+	query_pool_{VK_NULL_HANDLE},
+	render_pass_{VK_NULL_HANDLE},
+	sampler_{VK_NULL_HANDLE},
+	set_layout_{VK_NULL_HANDLE},
+	pipeline_layout_{VK_NULL_HANDLE},
+	vertex_shader_module_{VK_NULL_HANDLE},
+	fragment_shader_module_{VK_NULL_HANDLE},
+	pipeline_{VK_NULL_HANDLE}
+{ }
+
+resolution_scaler::~resolution_scaler() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto& target : targets_) {
+		vk.destroy_framebuffer(device, target.framebuffer, nullptr);
+		if (target.hdr.image != VK_NULL_HANDLE) {
+			details::destroy_image(vk, target.hdr);
+		}
+		details::destroy_image(vk, target.image);
+	}
+	// each handle on its own, `initialize` may have thrown half way.
+	if (pipeline_ != VK_NULL_HANDLE) {
+		vk.destroy_pipeline(device, pipeline_, nullptr);
+	}
+	if (fragment_shader_module_ != VK_NULL_HANDLE) {
+		vk.destroy_shader_module(device, fragment_shader_module_, nullptr);
+	}
+	if (vertex_shader_module_ != VK_NULL_HANDLE) {
+		vk.destroy_shader_module(device, vertex_shader_module_, nullptr);
+	}
+	if (sampler_ != VK_NULL_HANDLE) {
+		vk.destroy_sampler(device, sampler_, nullptr);
+	}
+	if (render_pass_ != VK_NULL_HANDLE) {
+		vk.destroy_render_pass(device, render_pass_, nullptr);
+	}
+	if (query_pool_ != VK_NULL_HANDLE) {
+		vk.destroy_query_pool(device, query_pool_, nullptr);
+	}
+}
+
+void resolution_scaler::initialize(const resolution_scale_settings& settings) {
+	validate(settings);
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	auto physical_device = engine_->device_manager()->physical_device();
+	settings_ = settings;
+	scale_ = settings_.max_scale;
+
+	uint32_t family_count{0};
+	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, nullptr);
+	std::vector<VkQueueFamilyProperties> families(family_count);
+	vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &family_count, families.data());
+	const auto valid_bits = families[engine_->device_manager()->queue_families().graphics_family.value()].timestampValidBits;
+	if (valid_bits != 0) {
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(physical_device, &properties);
+		timestamp_period_ = static_cast<double>(properties.limits.timestampPeriod);
+		timestamp_mask_ = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+
+		VkQueryPoolCreateInfo query_info{};
+		query_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		query_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		query_info.queryCount = details::resolution_timestamps;
+		if (vk.create_query_pool(device, &query_info, nullptr, &query_pool_) != VK_SUCCESS) {
+			throw std::runtime_error{"Failed to create timestamp query pool"};
+		}
+	}
+
+	VkSamplerCreateInfo sampler_info{};
+	sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	sampler_info.magFilter = VK_FILTER_LINEAR;
+	sampler_info.minFilter = VK_FILTER_LINEAR;
+	sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	if (vk.create_sampler(device, &sampler_info, nullptr, &sampler_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create upscale sampler"};
+	}
+
+	create_render_pass();
+	create_pipeline();
+	enabled_ = true;
+	create_targets();
+}
+
+void resolution_scaler::settings(const resolution_scale_settings& settings) {
+	validate(settings);
+	if (enabled_ && settings.max_scale > settings_.max_scale) {
+		throw std::runtime_error{"Resolution scale can't grow past the allocated targets"};
+	}
+	settings_ = settings;
+	scale_ = std::clamp(scale_, settings_.min_scale, settings_.max_scale);
+}
+
+VkExtent2D resolution_scaler::render_extent(size_t surface_index) const noexcept {
+	const auto window = engine_->surface_manager()->swap_chain_extent(surface_index);
+	const auto& target = targets_[surface_index];
+	const auto scaled = [this](uint32_t size, uint32_t limit) {
+		const auto pixels = static_cast<uint32_t>(std::lround(static_cast<double>(size) * scale_));
+		return std::clamp(pixels, 1u, limit);
+	};
+	return {scaled(window.width, target.extent.width), scaled(window.height, target.extent.height)};
+}
+
+void resolution_scaler::create_targets() {
+	if (!enabled_) { return; }
+	auto surface_manager = engine_->surface_manager();
+	for (size_t surface = targets_.size(); surface < surface_manager->surface_count(); ++surface) {
+		targets_.push_back(create_target(surface_manager->swap_chain_extent(surface)));
+	}
+}
+
+void resolution_scaler::recreate_target(size_t surface_index) {
+	if (!enabled_) { return; }
+	destroy_target(targets_[surface_index]);
+	targets_[surface_index] = create_target(engine_->surface_manager()->swap_chain_extent(surface_index));
+}
+
+resolution_scaler::scene_target resolution_scaler::create_target(VkExtent2D window) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto post_processor = engine_->post_processor();
+	scene_target target{};
+	target.extent = {
+		std::max(1u, static_cast<uint32_t>(std::ceil(static_cast<double>(window.width) * settings_.max_scale))),
+		std::max(1u, static_cast<uint32_t>(std::ceil(static_cast<double>(window.height) * settings_.max_scale)))
+	};
+	target.image = details::create_image(
+		vk,
+		engine_->device_manager()->memory_properties(),
+		engine_->surface_manager()->swap_chain_image_format(),
+		target.extent,
+		1,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+	);
+
+	if (post_processor->enabled()) {
+		target.hdr = post_processor->create_scene_attachment(target.extent);
+	}
+
+	const VkImageView attachments[] = {target.image.view, target.hdr.view};
+	VkFramebufferCreateInfo framebuffer_info{};
+	framebuffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebuffer_info.renderPass = render_pass_;
+	framebuffer_info.attachmentCount = post_processor->enabled() ? 2 : 1;
+	framebuffer_info.pAttachments = attachments;
+	framebuffer_info.width = target.extent.width;
+	framebuffer_info.height = target.extent.height;
+	framebuffer_info.layers = 1;
+	if (vk.create_framebuffer(engine_->device_manager()->logical_device(), &framebuffer_info, nullptr, &target.framebuffer) != VK_SUCCESS) {
+		if (target.hdr.image != VK_NULL_HANDLE) {
+			details::destroy_image(vk, target.hdr);
+		}
+		details::destroy_image(vk, target.image);
+		throw std::runtime_error{"Failed to create scene framebuffer"};
+	}
+	return target;
+}
+
+void resolution_scaler::destroy_target(scene_target& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.destroy_framebuffer(engine_->device_manager()->logical_device(), target.framebuffer, nullptr);
+	if (target.hdr.image != VK_NULL_HANDLE) {
+		engine_->post_processor()->destroy_scene_attachment(target.hdr);
+	}
+	// the upscale's set samples this view.
+	engine_->descriptor_allocator()->invalidate_view(target.image.view);
+	details::destroy_image(vk, target.image);
+	target = {};
+}
+
+void resolution_scaler::update() {
+	if (!pending_) { return; }
+	pending_ = false;
+	const auto& vk = engine_->device_manager()->dispatch();
+	uint64_t timestamps[details::resolution_timestamps]{};
+	if (vk.get_query_pool_results(
+		engine_->device_manager()->logical_device(),
+		query_pool_,
+		0,
+		details::resolution_timestamps,
+		sizeof(timestamps),
+		timestamps,
+		sizeof(uint64_t),
+		VK_QUERY_RESULT_64_BIT
+	) != VK_SUCCESS)
+	{
+		return;
+	}
+	const double frame_ms = static_cast<double>((timestamps[1] - timestamps[0]) & timestamp_mask_) * timestamp_period_ * 1e-6;
+#if defined PG_GODS_VIEW_PROFILE
+	const auto gpu_begin = static_cast<uint64_t>(static_cast<double>(timestamps[0] & timestamp_mask_) * timestamp_period_);
+	engine_->profiler()->gpu_span("gpu frame", gpu_begin, gpu_begin + static_cast<uint64_t>(frame_ms * 1e6), recorded_);
+#endif
+	gpu_ms_ = measured_ ? gpu_ms_ + details::resolution_smoothing * (frame_ms - gpu_ms_) : frame_ms;
+	measured_ = true;
+
+	const double low = settings_.target_gpu_ms * (1.0 - settings_.headroom);
+	if (gpu_ms_ <= 0.0 || (gpu_ms_ <= settings_.target_gpu_ms && gpu_ms_ >= low)) { return; }
+	// the cost of a frame grows with its pixel count, the square of the scale; this aims
+	// for the middle of the band so the scale doesn't bounce off either edge.
+	const double aim = (settings_.target_gpu_ms + low) * 0.5;
+	const auto wanted = static_cast<float>(scale_ * std::sqrt(aim / gpu_ms_));
+	scale_ = std::clamp(std::clamp(wanted, scale_ - settings_.max_step, scale_ + settings_.max_step), settings_.min_scale, settings_.max_scale);
+}
+
+void resolution_scaler::begin_frame(VkCommandBuffer command_buffer) {
+	if (!enabled_ || query_pool_ == VK_NULL_HANDLE) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_reset_query_pool(command_buffer, query_pool_, 0, details::resolution_timestamps);
+	vk.cmd_write_timestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool_, 0);
+}
+
+void resolution_scaler::end_frame(VkCommandBuffer command_buffer) {
+	if (!enabled_ || query_pool_ == VK_NULL_HANDLE) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.cmd_write_timestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool_, 1);
+	pending_ = true;
+	// the frame can't reach the gpu before it is recorded, profiling lines the clocks up with it.
+	recorded_ = engine_->profiler()->now();
+}
+
+VkExtent2D resolution_scaler::begin_scene(VkCommandBuffer command_buffer, size_t surface_index) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const auto extent = render_extent(surface_index);
+	VkRenderPassBeginInfo renderpass_info{};
+	renderpass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderpass_info.renderPass = render_pass_;
+	renderpass_info.framebuffer = targets_[surface_index].framebuffer;
+	renderpass_info.renderArea.offset = {0, 0};
+	renderpass_info.renderArea.extent = extent;
+	VkClearValue clear_colors[2] = {{{{0.0f, 0.0f, 0.0f, 1.0f}}}, {{{0.0f, 0.0f, 0.0f, 1.0f}}}};
+	renderpass_info.clearValueCount = engine_->post_processor()->enabled() ? 2 : 1;
+	renderpass_info.pClearValues = clear_colors;
+	vk.cmd_begin_render_pass(command_buffer, &renderpass_info, VK_SUBPASS_CONTENTS_INLINE);
+	return extent;
+}
+
+void resolution_scaler::upscale(VkCommandBuffer command_buffer, const frame_target& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	const auto window = engine_->surface_manager()->swap_chain_extent(target.surface_index);
+	auto& scene = targets_[target.surface_index];
+	const auto extent = render_extent(target.surface_index);
+
+	vk.cmd_bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+	VkViewport viewport{0.0f, 0.0f, static_cast<float>(window.width), static_cast<float>(window.height), 0.0f, 1.0f};
+	vk.cmd_set_viewport(command_buffer, 0, 1, &viewport);
+	VkRect2D scissor{{0, 0}, window};
+	vk.cmd_set_scissor(command_buffer, 0, 1, &scissor);
+
+	const float inverse_width = 1.0f / static_cast<float>(scene.extent.width);
+	const float inverse_height = 1.0f / static_cast<float>(scene.extent.height);
+	const details::upscale_push_constants constants{
+		{static_cast<float>(extent.width) * inverse_width, static_cast<float>(extent.height) * inverse_height},
+		{(static_cast<float>(extent.width) - 0.5f) * inverse_width, (static_cast<float>(extent.height) - 0.5f) * inverse_height}
+	};
+	vk.cmd_push_constants(command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+	// the target's view never changes, so its set is built once and kept.
+	if (scene.set == VK_NULL_HANDLE) {
+		scene.set = engine_->descriptor_allocator()->cached(set_layout_, {image_binding(
+			0,
+			VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+			sampler_,
+			scene.image.view,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+		)});
+	}
+	vk.cmd_bind_descriptor_sets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1, &scene.set, 0, nullptr);
+	vk.cmd_draw(command_buffer, 3, 1, 0, 0);
+}
+
+void resolution_scaler::validate(const resolution_scale_settings& settings) const {
+	// a step of zero or less would turn the bounds of the step clamp in `update` around.
+	if (settings.min_scale <= 0.0f || settings.min_scale > settings.max_scale || settings.max_step <= 0.0f ||
+		settings.target_gpu_ms <= 0.0 || settings.headroom < 0.0 || settings.headroom >= 1.0)
+	{
+		throw std::runtime_error{"Invalid resolution scale settings"};
+	}
+}
+
+void resolution_scaler::create_render_pass() {
+	// the post processor's scene and post subpasses, with the graded result kept for the upscale.
+	if (const auto post_processor = engine_->post_processor(); post_processor->enabled()) {
+		render_pass_ = post_processor->create_render_pass(
+			engine_->surface_manager()->swap_chain_image_format(),
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_ATTACHMENT_LOAD_OP_CLEAR
+		);
+		return;
+	}
+	const auto& vk = engine_->device_manager()->dispatch();
+	// same format and sample count as the window pass, so scene pipelines work in either.
+	VkAttachmentDescription color_attachment{};
+	color_attachment.format = engine_->surface_manager()->swap_chain_image_format();
+	color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	color_attachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentReference color_attachment_ref{};
+	color_attachment_ref.attachment = 0;
+	color_attachment_ref.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpass{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &color_attachment_ref;
+
+	// the previous frame's upscale has to be done reading before the scene is redrawn, and
+	// the scene written before this frame's upscale samples it.
+	VkSubpassDependency dependencies[2]{};
+	dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass = 0;
+	dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].srcAccessMask = 0;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].srcSubpass = 0;
+	dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	VkRenderPassCreateInfo renderpass_info{};
+	renderpass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderpass_info.attachmentCount = 1;
+	renderpass_info.pAttachments = &color_attachment;
+	renderpass_info.subpassCount = 1;
+	renderpass_info.pSubpasses = &subpass;
+	renderpass_info.dependencyCount = 2;
+	renderpass_info.pDependencies = dependencies;
+	if (vk.create_render_pass(engine_->device_manager()->logical_device(), &renderpass_info, nullptr, &render_pass_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create scene render pass"};
+	}
+}
+
+void resolution_scaler::create_pipeline() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto graphics_pipeline_manager = engine_->graphics_pipeline_manager();
+	vertex_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/upscale_vert.spv"));
+	fragment_shader_module_ = graphics_pipeline_manager->shader_module(graphics_pipeline_manager->read_shader("shaders/upscale_frag.spv"));
+
+	VkDescriptorSetLayoutBinding scene_binding{};
+	scene_binding.binding = 0;
+	scene_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	scene_binding.descriptorCount = 1;
+	scene_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	set_layout_ = engine_->layout_cache()->descriptor_set_layout({scene_binding});
+	VkPushConstantRange push_constant_range{};
+	push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	push_constant_range.offset = 0;
+	push_constant_range.size = sizeof(details::upscale_push_constants);
+	pipeline_layout_ = engine_->layout_cache()->pipeline_layout({set_layout_}, {push_constant_range});
+
+	VkPipelineShaderStageCreateInfo shader_stages[2]{};
+	shader_stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	shader_stages[0].module = vertex_shader_module_;
+	shader_stages[0].pName = "main";
+	shader_stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	shader_stages[1].module = fragment_shader_module_;
+	shader_stages[1].pName = "main";
+
+	VkPipelineVertexInputStateCreateInfo vertex_input_info{};
+	vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+	input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	input_assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	input_assembly.primitiveRestartEnable = VK_FALSE;
+
+	VkPipelineViewportStateCreateInfo viewport_state{};
+	viewport_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewport_state.viewportCount = 1;
+	viewport_state.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = VK_CULL_MODE_NONE;
+	rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+	depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depth_stencil.depthTestEnable = VK_FALSE;
+	depth_stencil.depthWriteEnable = VK_FALSE;
+
+	VkPipelineColorBlendAttachmentState color_blend_attachment{};
+	color_blend_attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+	color_blend_attachment.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendStateCreateInfo color_blending{};
+	color_blending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	color_blending.logicOpEnable = VK_FALSE;
+	color_blending.attachmentCount = 1;
+	color_blending.pAttachments = &color_blend_attachment;
+
+	const VkDynamicState dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic_state{};
+	dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamic_state.dynamicStateCount = 2;
+	dynamic_state.pDynamicStates = dynamic_states;
+
+	VkGraphicsPipelineCreateInfo pipeline_info{};
+	pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipeline_info.stageCount = 2;
+	pipeline_info.pStages = shader_stages;
+	pipeline_info.pVertexInputState = &vertex_input_info;
+	pipeline_info.pInputAssemblyState = &input_assembly;
+	pipeline_info.pViewportState = &viewport_state;
+	pipeline_info.pRasterizationState = &rasterizer;
+	pipeline_info.pMultisampleState = &multisampling;
+	pipeline_info.pDepthStencilState = &depth_stencil;
+	pipeline_info.pColorBlendState = &color_blending;
+	pipeline_info.pDynamicState = &dynamic_state;
+	pipeline_info.layout = pipeline_layout_;
+	pipeline_info.renderPass = graphics_pipeline_manager->render_pass();
+	pipeline_info.subpass = engine_->post_processor()->composite_subpass();
+	pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+	if (vk.create_graphics_pipelines(engine_->device_manager()->logical_device(), VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create upscale pipeline"};
+	}
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,152 @@
+#if !defined PG_GODS_VIEW_RESOLUTION_SCALER_HEADER_INCLUDED
+#define PG_GODS_VIEW_RESOLUTION_SCALER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/memory.h"
+#include "gods_view/surface_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+struct resolution_scale_settings {
+	// bounds of the scene's resolution as a fraction of the window's, per axis.
+	float min_scale{0.5f};
+	float max_scale{1.0f};
+	// gpu time per frame the scale is steered towards, in milliseconds.
+	double target_gpu_ms{1000.0 / 60.0};
+	// the scale holds still while frames take between `target * (1 - headroom)` and `target`.
+	double headroom{0.15};
+	// largest change of the scale between two frames.
+	float max_step{0.05f};
+};
+
+struct resolution_scale_stats {
+	float scale;
+	// smoothed gpu time of the recent frames, 0 until the first is measured.
+	double gpu_ms;
+	// false when the graphics queue has no timestamps, the scale then stays at `max_scale`.
+	bool measured;
+};
+
+namespace details {
+
+// weight of the newest frame in the smoothed gpu time.
+constexpr double resolution_smoothing = 0.2;
+constexpr uint32_t resolution_timestamps = 2;
+
+struct upscale_push_constants {
+	float uv_scale[2];
+	float uv_max[2];
+};
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// renders the scene into an internal target per window at a fraction of the window's size
+// and stretches it over the swap chain image at the start of the window's own render pass,
+// so the overlay still lands at full resolution. the fraction follows the gpu time measured
+// with timestamps around each frame's command buffer. targets are allocated once at
+// `max_scale`; a lower scale only renders into a smaller corner of them. with post processing
+// the scene pass tonemaps and grades at render resolution, before the upscale.
+class resolution_scaler {
+private:
+	struct scene_target {
+		gpu_image image;
+		// the scene before tonemapping, only with post processing.
+		gpu_image hdr;
+		VkFramebuffer framebuffer;
+		VkExtent2D extent;
+		// the upscale's set, fetched on the first upscale and kept since the view never changes.
+		VkDescriptorSet set;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	resolution_scale_settings settings_;
+	float scale_;
+	double gpu_ms_;
+	bool enabled_;
+	bool measured_;
+	// timestamps were written by the frame in flight and are read once its fence signals.
+	bool pending_;
+	// profiler time when the frame in flight finished recording.
+	uint64_t recorded_;
+	double timestamp_period_;
+	uint64_t timestamp_mask_;
+	VkQueryPool query_pool_;
+	VkRenderPass render_pass_;
+	VkSampler sampler_;
+	VkDescriptorSetLayout set_layout_;
+	VkPipelineLayout pipeline_layout_;
+	VkShaderModule vertex_shader_module_;
+	VkShaderModule fragment_shader_module_;
+	VkPipeline pipeline_;
+	std::vector<scene_target> targets_;
+
+public:
+	resolution_scaler(gods_view::vulkan_engine* init_engine);
+
+	~resolution_scaler();
+
+	resolution_scaler(const resolution_scaler&) = delete;
+
+	resolution_scaler& operator=(const resolution_scaler&) = delete;
+
+	// call once the render pass and every window's swap chain exist. until then the scene
+	// is drawn straight into the swap chain.
+	void initialize(const resolution_scale_settings& settings = {});
+
+	[[nodiscard]] bool enabled() const noexcept { return enabled_; }
+
+	[[nodiscard]] const resolution_scale_settings& settings() const noexcept { return settings_; }
+
+	// takes effect on the next frame, `max_scale` can't grow past the one targets were allocated with.
+	void settings(const resolution_scale_settings& settings);
+
+	[[nodiscard]] resolution_scale_stats stats() const noexcept { return {scale_, gpu_ms_, measured_}; }
+
+	// the part of the window's scene target drawn this frame.
+	[[nodiscard]] VkExtent2D render_extent(size_t surface_index) const noexcept;
+
+	// allocates targets for windows added since, see `vulkan_engine::add_window`.
+	void create_targets();
+
+	// the window's targets again for its swap chain's current extent, after a resize.
+	void recreate_target(size_t surface_index);
+
+	// called by the draw manager after the frame fence, steers the scale with the last frame's time.
+	void update();
+
+	// brackets a frame's command buffer with the timestamps.
+	void begin_frame(VkCommandBuffer command_buffer);
+
+	void end_frame(VkCommandBuffer command_buffer);
+
+	// begins the scene pass on the window's internal target, returns the extent to draw at.
+	VkExtent2D begin_scene(VkCommandBuffer command_buffer, size_t surface_index);
+
+	// the window's hdr attachment for the post processor's resolve.
+	[[nodiscard]] VkImageView scene_view(size_t surface_index) const noexcept { return targets_[surface_index].hdr.view; }
+
+	// draws the scene target over the whole swap chain image, inside the window's render pass.
+	void upscale(VkCommandBuffer command_buffer, const frame_target& target);
+
+private:
+	void validate(const resolution_scale_settings& settings) const;
+
+	void create_render_pass();
+
+	void create_pipeline();
+
+	[[nodiscard]] scene_target create_target(VkExtent2D window);
+
+	void destroy_target(scene_target& target);
+};
+
+} // end namespace pg::gods_view
+
+#endif
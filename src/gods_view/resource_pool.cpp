@@ -0,0 +1,69 @@
+#include "gods_view/resource_pool.h"
+#include "gods_view/vulkan_engine.h"
+
+namespace pg::gods_view {
+
+resource_pool::resource_pool(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine}
+{ }
+
+resource_pool::~resource_pool() {
+	buffers_.for_each([this](buffer_handle id) { destroy(id); });
+	images_.for_each([this](image_handle id) { destroy(id); });
+}
+
+buffer_handle resource_pool::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	return adopt(details::create_buffer(vk, engine_->device_manager()->memory_properties(), size, usage, properties));
+}
+
+image_handle resource_pool::create_image(
+	VkFormat format,
+	VkExtent2D extent,
+	uint32_t mip_levels,
+	VkImageUsageFlags usage,
+	VkImageAspectFlags aspect
+)
+{
+	const auto& vk = engine_->device_manager()->dispatch();
+	return adopt(details::create_image(vk, engine_->device_manager()->memory_properties(), format, extent, mip_levels, usage, aspect));
+}
+
+buffer_handle resource_pool::adopt(const gpu_buffer& buffer) {
+	return buffers_.create(buffer.buffer, buffer.memory, buffer.size, buffer.mapped);
+}
+
+image_handle resource_pool::adopt(const gpu_image& image) {
+	return images_.create(image.image, image.memory, image.view, image.size);
+}
+
+void resource_pool::destroy(buffer_handle id) {
+	if (!buffers_.valid(id)) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	gpu_buffer buffer{
+		buffers_.get<buffer_column>(id),
+		buffers_.get<buffer_memory_column>(id),
+		buffers_.get<buffer_size_column>(id),
+		buffers_.get<buffer_mapped_column>(id)
+	};
+	// the driver may hand the same handle to the next buffer, no cached set may point at it.
+	engine_->descriptor_allocator()->invalidate_buffer(buffer.buffer);
+	details::destroy_buffer(vk, buffer);
+	buffers_.destroy(id);
+}
+
+void resource_pool::destroy(image_handle id) {
+	if (!images_.valid(id)) { return; }
+	const auto& vk = engine_->device_manager()->dispatch();
+	gpu_image image{
+		images_.get<image_column>(id),
+		images_.get<image_memory_column>(id),
+		images_.get<image_view_column>(id),
+		images_.get<image_size_column>(id)
+	};
+	engine_->descriptor_allocator()->invalidate_view(image.view);
+	details::destroy_image(vk, image);
+	images_.destroy(id);
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,88 @@
+#if !defined PG_GODS_VIEW_RESOURCE_POOL_HEADER_INCLUDED
+#define PG_GODS_VIEW_RESOURCE_POOL_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/handle_pool.h"
+#include "gods_view/memory.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pg::gods_view {
+
+class vulkan_engine;
+
+// owns buffers and images handed out as 32 bit generational handles. lookups are an array
+// index and a generation compare; a handle outliving its resource is caught by `valid`
+// instead of reaching the device. whatever is left when the engine goes away is freed here.
+class resource_pool {
+private:
+	static constexpr std::size_t buffer_column = 0;
+	static constexpr std::size_t buffer_memory_column = 1;
+	static constexpr std::size_t buffer_size_column = 2;
+	static constexpr std::size_t buffer_mapped_column = 3;
+	static constexpr std::size_t image_column = 0;
+	static constexpr std::size_t image_memory_column = 1;
+	static constexpr std::size_t image_view_column = 2;
+	static constexpr std::size_t image_size_column = 3;
+
+	gods_view::vulkan_engine* engine_;
+	handle_pool<buffer_handle, VkBuffer, VkDeviceMemory, VkDeviceSize, void*> buffers_;
+	handle_pool<image_handle, VkImage, VkDeviceMemory, VkImageView, VkDeviceSize> images_;
+
+public:
+	resource_pool(gods_view::vulkan_engine* init_engine);
+
+	~resource_pool();
+
+	resource_pool(const resource_pool&) = delete;
+
+	resource_pool& operator=(const resource_pool&) = delete;
+
+	[[nodiscard]] uint32_t buffer_count() const noexcept { return buffers_.size(); }
+
+	[[nodiscard]] uint32_t image_count() const noexcept { return images_.size(); }
+
+	// host visible buffers come back persistently mapped.
+	buffer_handle create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+
+	image_handle create_image(
+		VkFormat format,
+		VkExtent2D extent,
+		uint32_t mip_levels,
+		VkImageUsageFlags usage,
+		VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT
+	);
+
+	// takes ownership of a resource made by the `details` helpers.
+	buffer_handle adopt(const gpu_buffer& buffer);
+
+	image_handle adopt(const gpu_image& image);
+
+	// the resource must be out of use on the gpu. stale handles are ignored.
+	void destroy(buffer_handle id);
+
+	void destroy(image_handle id);
+
+	[[nodiscard]] bool valid(buffer_handle id) const noexcept { return buffers_.valid(id); }
+
+	[[nodiscard]] bool valid(image_handle id) const noexcept { return images_.valid(id); }
+
+	[[nodiscard]] VkBuffer buffer(buffer_handle id) const noexcept { return buffers_.get<buffer_column>(id); }
+
+	[[nodiscard]] VkDeviceSize size(buffer_handle id) const noexcept { return buffers_.get<buffer_size_column>(id); }
+
+	[[nodiscard]] void* mapped(buffer_handle id) const noexcept { return buffers_.get<buffer_mapped_column>(id); }
+
+	[[nodiscard]] VkImage image(image_handle id) const noexcept { return images_.get<image_column>(id); }
+
+	[[nodiscard]] VkImageView view(image_handle id) const noexcept { return images_.get<image_view_column>(id); }
+
+	[[nodiscard]] VkDeviceSize size(image_handle id) const noexcept { return images_.get<image_size_column>(id); }
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,380 @@
+#include "gods_view/shader_reflection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <system_error>
+#include <unordered_map>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr uint32_t spirv_magic = 0x07230203;
+constexpr size_t spirv_header_words = 5;
+
+// the handful of SPIR-V enumerants reflection looks at.
+enum spirv_op : uint32_t {
+	spirv_op_entry_point = 15,
+	spirv_op_type_int = 21,
+	spirv_op_type_float = 22,
+	spirv_op_type_vector = 23,
+	spirv_op_type_matrix = 24,
+	spirv_op_type_image = 25,
+	spirv_op_type_sampler = 26,
+	spirv_op_type_sampled_image = 27,
+	spirv_op_type_array = 28,
+	spirv_op_type_runtime_array = 29,
+	spirv_op_type_struct = 30,
+	spirv_op_type_pointer = 32,
+	spirv_op_constant = 43,
+	spirv_op_variable = 59,
+	spirv_op_decorate = 71,
+	spirv_op_member_decorate = 72
+};
+
+enum spirv_decoration : uint32_t {
+	spirv_decoration_buffer_block = 3,
+	spirv_decoration_array_stride = 6,
+	spirv_decoration_matrix_stride = 7,
+	spirv_decoration_built_in = 11,
+	spirv_decoration_location = 30,
+	spirv_decoration_binding = 33,
+	spirv_decoration_descriptor_set = 34,
+	spirv_decoration_offset = 35
+};
+
+enum spirv_storage_class : uint32_t {
+	spirv_storage_uniform_constant = 0,
+	spirv_storage_input = 1,
+	spirv_storage_uniform = 2,
+	spirv_storage_push_constant = 9,
+	spirv_storage_storage_buffer = 12
+};
+
+constexpr uint32_t spirv_dim_buffer = 5;
+constexpr uint32_t spirv_dim_subpass_data = 6;
+
+struct spirv_type {
+	uint32_t opcode;
+	// operands following the result id.
+	std::vector<uint32_t> operands;
+};
+
+struct spirv_decorations {
+	std::optional<uint32_t> location;
+	std::optional<uint32_t> binding;
+	std::optional<uint32_t> set;
+	std::optional<uint32_t> array_stride;
+	bool built_in{false};
+	bool buffer_block{false};
+};
+
+struct spirv_member_decorations {
+	uint32_t offset{0};
+	std::optional<uint32_t> matrix_stride;
+};
+
+struct spirv_variable {
+	uint32_t id;
+	uint32_t pointer_type;
+	uint32_t storage_class;
+};
+
+struct spirv_module {
+	std::optional<uint32_t> execution_model;
+	std::unordered_map<uint32_t, spirv_type> types;
+	std::unordered_map<uint32_t, uint32_t> constants;
+	std::unordered_map<uint32_t, spirv_decorations> decorations;
+	std::unordered_map<uint64_t, spirv_member_decorations> member_decorations;
+	std::vector<spirv_variable> variables;
+
+	const spirv_type& type(uint32_t id) const {
+		auto it = types.find(id);
+		if (it == types.end()) {
+			throw std::runtime_error{"SPIR-V references an unknown type"};
+		}
+		return it->second;
+	}
+
+	const spirv_decorations* decorations_of(uint32_t id) const {
+		auto it = decorations.find(id);
+		return it != decorations.end() ? &it->second : nullptr;
+	}
+
+	spirv_member_decorations member_decorations_of(uint32_t id, uint32_t member) const {
+		auto it = member_decorations.find((static_cast<uint64_t>(id) << 32) | member);
+		return it != member_decorations.end() ? it->second : spirv_member_decorations{};
+	}
+
+	uint32_t array_length(const spirv_type& array) const {
+		auto it = constants.find(array.operands[1]);
+		return it != constants.end() ? it->second : 1;
+	}
+};
+
+static spirv_module parse_spirv(const std::vector<char>& shader_bytecode) {
+	if (shader_bytecode.size() % sizeof(uint32_t) != 0 || shader_bytecode.size() < spirv_header_words * sizeof(uint32_t)) {
+		throw std::runtime_error{"Invalid SPIR-V module"};
+	}
+	std::vector<uint32_t> words(shader_bytecode.size() / sizeof(uint32_t));
+	std::memcpy(words.data(), shader_bytecode.data(), shader_bytecode.size());
+	if (words[0] != spirv_magic) {
+		throw std::runtime_error{"Invalid SPIR-V module"};
+	}
+
+	spirv_module module{};
+	for (size_t i = spirv_header_words; i < words.size();) {
+		const uint32_t opcode = words[i] & 0xffffu;
+		const uint32_t word_count = words[i] >> 16;
+		if (word_count == 0 || i + word_count > words.size()) {
+			throw std::runtime_error{"Invalid SPIR-V module"};
+		}
+		const uint32_t* operands = &words[i + 1];
+		const uint32_t operand_count = word_count - 1;
+
+		switch (opcode) {
+		case spirv_op_entry_point:
+			if (!module.execution_model.has_value()) {
+				module.execution_model = operands[0];
+			}
+			break;
+		case spirv_op_type_int:
+		case spirv_op_type_float:
+		case spirv_op_type_vector:
+		case spirv_op_type_matrix:
+		case spirv_op_type_image:
+		case spirv_op_type_sampler:
+		case spirv_op_type_sampled_image:
+		case spirv_op_type_array:
+		case spirv_op_type_runtime_array:
+		case spirv_op_type_struct:
+		case spirv_op_type_pointer:
+			module.types[operands[0]] = {opcode, {operands + 1, operands + operand_count}};
+			break;
+		case spirv_op_constant:
+			module.constants[operands[1]] = operands[2];
+			break;
+		case spirv_op_variable:
+			module.variables.push_back({operands[1], operands[0], operands[2]});
+			break;
+		case spirv_op_decorate: {
+			auto& decoration = module.decorations[operands[0]];
+			switch (operands[1]) {
+			case spirv_decoration_location: decoration.location = operands[2]; break;
+			case spirv_decoration_binding: decoration.binding = operands[2]; break;
+			case spirv_decoration_descriptor_set: decoration.set = operands[2]; break;
+			case spirv_decoration_array_stride: decoration.array_stride = operands[2]; break;
+			case spirv_decoration_built_in: decoration.built_in = true; break;
+			case spirv_decoration_buffer_block: decoration.buffer_block = true; break;
+			default: break;
+			}
+			break;
+		}
+		case spirv_op_member_decorate: {
+			auto& decoration = module.member_decorations[(static_cast<uint64_t>(operands[0]) << 32) | operands[1]];
+			if (operands[2] == spirv_decoration_offset) {
+				decoration.offset = operands[3];
+			} else if (operands[2] == spirv_decoration_matrix_stride) {
+				decoration.matrix_stride = operands[3];
+			}
+			break;
+		}
+		default:
+			break;
+		}
+		i += word_count;
+	}
+	if (!module.execution_model.has_value()) {
+		throw std::runtime_error{"SPIR-V module has no entry point"};
+	}
+	return module;
+}
+
+static VkShaderStageFlagBits stage_of(uint32_t execution_model) {
+	switch (execution_model) {
+	case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+	case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+	case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+	case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+	case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+	case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+	default: throw std::runtime_error{"Unsupported SPIR-V execution model"};
+	}
+}
+
+static uint32_t size_of(const spirv_module& module, uint32_t type_id, std::optional<uint32_t> matrix_stride = std::nullopt) {
+	const auto& type = module.type(type_id);
+	switch (type.opcode) {
+	case spirv_op_type_int:
+	case spirv_op_type_float:
+		return type.operands[0] / 8;
+	case spirv_op_type_vector:
+		return type.operands[1] * size_of(module, type.operands[0]);
+	case spirv_op_type_matrix:
+		return type.operands[1] * matrix_stride.value_or(size_of(module, type.operands[0]));
+	case spirv_op_type_array: {
+		const auto* decoration = module.decorations_of(type_id);
+		const uint32_t stride = decoration != nullptr && decoration->array_stride.has_value()
+			? decoration->array_stride.value()
+			: size_of(module, type.operands[0], matrix_stride);
+		return module.array_length(type) * stride;
+	}
+	case spirv_op_type_struct: {
+		uint32_t size{0};
+		for (uint32_t member = 0; member < type.operands.size(); ++member) {
+			const auto decoration = module.member_decorations_of(type_id, member);
+			size = std::max(size, decoration.offset + size_of(module, type.operands[member], decoration.matrix_stride));
+		}
+		return size;
+	}
+	default:
+		// runtime arrays and opaque types take no space in a block.
+		return 0;
+	}
+}
+
+static VkFormat format_of(const spirv_module& module, uint32_t type_id) {
+	const auto& type = module.type(type_id);
+	const uint32_t components = type.opcode == spirv_op_type_vector ? type.operands[1] : 1;
+	const auto& scalar = type.opcode == spirv_op_type_vector ? module.type(type.operands[0]) : type;
+	if (scalar.operands[0] != 32 || components == 0 || components > 4) {
+		throw std::runtime_error{"Unsupported vertex input type"};
+	}
+	constexpr VkFormat float_formats[] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+	constexpr VkFormat sint_formats[] = {VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+	constexpr VkFormat uint_formats[] = {VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+	if (scalar.opcode == spirv_op_type_float) {
+		return float_formats[components - 1];
+	}
+	return scalar.operands[1] != 0 ? sint_formats[components - 1] : uint_formats[components - 1];
+}
+
+static std::optional<VkDescriptorType> descriptor_type_of(const spirv_module& module, uint32_t type_id, uint32_t storage_class) {
+	const auto& type = module.type(type_id);
+	if (storage_class == spirv_storage_storage_buffer) {
+		return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	}
+	if (storage_class == spirv_storage_uniform) {
+		const auto* decoration = module.decorations_of(type_id);
+		return decoration != nullptr && decoration->buffer_block ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	}
+	switch (type.opcode) {
+	case spirv_op_type_sampler:
+		return VK_DESCRIPTOR_TYPE_SAMPLER;
+	case spirv_op_type_sampled_image:
+		return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	case spirv_op_type_image: {
+		const uint32_t dim = type.operands[1];
+		const bool storage = type.operands[5] == 2;
+		if (dim == spirv_dim_buffer) {
+			return storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+		}
+		if (dim == spirv_dim_subpass_data) {
+			return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+		}
+		return storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+	}
+	default:
+		return std::nullopt;
+	}
+}
+
+static uint32_t format_size(VkFormat format) {
+	switch (format) {
+	case VK_FORMAT_R32_SFLOAT: case VK_FORMAT_R32_SINT: case VK_FORMAT_R32_UINT: return 4;
+	case VK_FORMAT_R32G32_SFLOAT: case VK_FORMAT_R32G32_SINT: case VK_FORMAT_R32G32_UINT: return 8;
+	case VK_FORMAT_R32G32B32_SFLOAT: case VK_FORMAT_R32G32B32_SINT: case VK_FORMAT_R32G32B32_UINT: return 12;
+	default: return 16;
+	}
+}
+
+} // end namespace pg::gods_view::details
+
+shader_reflection reflect_shader(const std::vector<char>& shader_bytecode) {
+	const auto module = details::parse_spirv(shader_bytecode);
+
+	shader_reflection reflection{};
+	reflection.stage = details::stage_of(module.execution_model.value());
+	reflection.push_constant_size = 0;
+
+	for (const auto& variable : module.variables) {
+		const auto& pointer = module.type(variable.pointer_type);
+		uint32_t type_id = pointer.operands[1];
+		const auto* decoration = module.decorations_of(variable.id);
+
+		switch (variable.storage_class) {
+		case details::spirv_storage_input: {
+			// builtins and the gl_PerVertex block have no location and are not vertex attributes.
+			if (decoration == nullptr || decoration->built_in || !decoration->location.has_value()) { break; }
+			const auto& type = module.type(type_id);
+			uint32_t columns{1};
+			if (type.opcode == details::spirv_op_type_matrix) {
+				columns = type.operands[1];
+				type_id = type.operands[0];
+			}
+			const auto format = details::format_of(module, type_id);
+			for (uint32_t column = 0; column < columns; ++column) {
+				reflection.inputs.push_back({decoration->location.value() + column, format, details::format_size(format)});
+			}
+			break;
+		}
+		case details::spirv_storage_push_constant:
+			reflection.push_constant_size = std::max(reflection.push_constant_size, details::size_of(module, type_id));
+			break;
+		case details::spirv_storage_uniform_constant:
+		case details::spirv_storage_uniform:
+		case details::spirv_storage_storage_buffer: {
+			if (decoration == nullptr || !decoration->binding.has_value()) { break; }
+			uint32_t count{1};
+			for (;;) {
+				const auto& type = module.type(type_id);
+				if (type.opcode == details::spirv_op_type_array) {
+					count *= module.array_length(type);
+				} else if (type.opcode != details::spirv_op_type_runtime_array) {
+					break;
+				}
+				type_id = type.operands[0];
+			}
+			auto type = details::descriptor_type_of(module, type_id, variable.storage_class);
+			if (!type.has_value()) { break; }
+			reflection.bindings.push_back({decoration->set.value_or(0), decoration->binding.value(), type.value(), count});
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	std::sort(reflection.inputs.begin(), reflection.inputs.end(), [](const shader_input& a, const shader_input& b) {
+		return a.location < b.location;
+	});
+	std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const shader_binding& a, const shader_binding& b) {
+		return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+	});
+	return reflection;
+}
+
+vertex_input_layout reflect_vertex_input(const shader_reflection& vertex_stage) {
+	vertex_input_layout layout{};
+	if (vertex_stage.inputs.empty()) { return layout; }
+
+	uint32_t offset{0};
+	for (const auto& input : vertex_stage.inputs) {
+		VkVertexInputAttributeDescription attribute{};
+		attribute.location = input.location;
+		attribute.binding = 0;
+		attribute.format = input.format;
+		attribute.offset = offset;
+		layout.attributes.push_back(attribute);
+		offset += input.size;
+	}
+	VkVertexInputBindingDescription binding{};
+	binding.binding = 0;
+	binding.stride = offset;
+	binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	layout.bindings.push_back(binding);
+	return layout;
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,46 @@
+#if !defined PG_GODS_VIEW_SHADER_REFLECTION_HEADER_INCLUDED
+#define PG_GODS_VIEW_SHADER_REFLECTION_HEADER_INCLUDED
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+struct shader_input {
+	uint32_t location;
+	VkFormat format;
+	uint32_t size;
+};
+
+struct shader_binding {
+	uint32_t set;
+	uint32_t binding;
+	VkDescriptorType type;
+	uint32_t count;
+};
+
+// the interface a single SPIR-V module exposes to the pipeline.
+struct shader_reflection {
+	VkShaderStageFlagBits stage;
+	std::vector<shader_input> inputs;
+	std::vector<shader_binding> bindings;
+	uint32_t push_constant_size;
+};
+
+// vertex input state for a vertex shader, every input interleaved in binding 0 in location order.
+struct vertex_input_layout {
+	std::vector<VkVertexInputBindingDescription> bindings;
+	std::vector<VkVertexInputAttributeDescription> attributes;
+};
+
+// walks the module once, only the decorations and types reachable from interface variables are kept.
+shader_reflection reflect_shader(const std::vector<char>& shader_bytecode);
+
+vertex_input_layout reflect_vertex_input(const shader_reflection& vertex_stage);
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,208 @@
+#if !defined PG_GODS_VIEW_SHADER_VARIANT_HEADER_INCLUDED
+#define PG_GODS_VIEW_SHADER_VARIANT_HEADER_INCLUDED
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace pg::gods_view {
+
+// a variant as handed to pipeline creation, `key` tells pipelines of different variants apart.
+// the default one specializes nothing.
+struct specialization_info {
+	uint64_t key{0};
+	VkSpecializationInfo info{};
+};
+
+// a copy of the constants a pipeline was specialized with. pipelines are found by
+// `specialization_info::key`, a hash, so caches keep this next to each pipeline and compare
+// it on lookup; two variants whose keys collide then still get pipelines of their own.
+struct specialization_constants {
+	std::vector<VkSpecializationMapEntry> entries;
+	std::vector<std::byte> data;
+
+	specialization_constants() = default;
+
+	explicit specialization_constants(const specialization_info& variant) :
+		entries(variant.info.pMapEntries, variant.info.pMapEntries + variant.info.mapEntryCount),
+		data(static_cast<const std::byte*>(variant.info.pData), static_cast<const std::byte*>(variant.info.pData) + variant.info.dataSize)
+	{ }
+
+	// compares in place, lookups don't allocate.
+	[[nodiscard]] bool matches(const specialization_info& variant) const noexcept {
+		if (entries.size() != variant.info.mapEntryCount || data.size() != variant.info.dataSize) { return false; }
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const auto& entry = variant.info.pMapEntries[i];
+			if (entries[i].constantID != entry.constantID || entries[i].offset != entry.offset || entries[i].size != entry.size) {
+				return false;
+			}
+		}
+		return data.empty() || std::memcmp(data.data(), variant.info.pData, data.size()) == 0;
+	}
+};
+
+namespace details {
+
+constexpr uint64_t variant_hash_offset = 14695981039346656037ull;
+constexpr uint64_t variant_hash_prime = 1099511628211ull;
+
+[[nodiscard]] constexpr uint64_t variant_hash(uint64_t hash, uint32_t value) noexcept {
+	for (int byte = 0; byte < 4; ++byte) {
+		hash = (hash ^ ((value >> (byte * 8)) & 0xffu)) * variant_hash_prime;
+	}
+	return hash;
+}
+
+// how a constant type is stored in specialization data, every supported type takes four bytes
+// so values hash and compare as plain words at compile time.
+template <typename T>
+struct spec_constant_traits;
+
+template <>
+struct spec_constant_traits<bool> {
+	static constexpr uint32_t tag = 1;
+	[[nodiscard]] static constexpr uint32_t encode(bool value) noexcept { return value ? VK_TRUE : VK_FALSE; }
+	[[nodiscard]] static constexpr bool decode(uint32_t word) noexcept { return word != VK_FALSE; }
+};
+
+template <>
+struct spec_constant_traits<int32_t> {
+	static constexpr uint32_t tag = 2;
+	[[nodiscard]] static constexpr uint32_t encode(int32_t value) noexcept { return static_cast<uint32_t>(value); }
+	[[nodiscard]] static constexpr int32_t decode(uint32_t word) noexcept { return static_cast<int32_t>(word); }
+};
+
+template <>
+struct spec_constant_traits<uint32_t> {
+	static constexpr uint32_t tag = 3;
+	[[nodiscard]] static constexpr uint32_t encode(uint32_t value) noexcept { return value; }
+	[[nodiscard]] static constexpr uint32_t decode(uint32_t word) noexcept { return word; }
+};
+
+template <size_t Count>
+[[nodiscard]] constexpr bool unique_constant_ids(const std::array<uint32_t, Count>& ids) noexcept {
+	for (size_t i = 0; i < Count; ++i) {
+		for (size_t j = i + 1; j < Count; ++j) {
+			if (ids[i] == ids[j]) { return false; }
+		}
+	}
+	return true;
+}
+
+// constants are packed as consecutive words in declaration order.
+template <size_t Count>
+[[nodiscard]] constexpr std::array<VkSpecializationMapEntry, Count> specialization_map_entries(const std::array<uint32_t, Count>& ids) noexcept {
+	std::array<VkSpecializationMapEntry, Count> entries{};
+	for (size_t i = 0; i < Count; ++i) {
+		entries[i] = {ids[i], static_cast<uint32_t>(i * sizeof(uint32_t)), sizeof(uint32_t)};
+	}
+	return entries;
+}
+
+} // end namespace pg::gods_view::details
+
+// one `layout(constant_id = Id) const T name = Default;` of a shader.
+template <uint32_t Id, typename T, T Default = T{}>
+struct spec_constant {
+	using value_type = T;
+	static constexpr uint32_t id = Id;
+	static constexpr T default_value = Default;
+};
+
+// a typed set of specialization constants describing one feature permutation, e.g.
+//
+//     using lit_variant = shader_variant<spec_constant<0, bool>, spec_constant<1, uint32_t, 4>>;
+//     constexpr auto shadowed = lit_variant{}.with<0>(true).with<1>(8u);
+//     static_assert(shadowed.key() != lit_variant{}.key());
+//
+// the key is computed at compile time when the values are constants, and pipelines are
+// cached per key by the graphics pipeline manager. the constants apply to every stage, a
+// stage that does not declare one ignores it.
+template <typename... Constants>
+class shader_variant {
+	static_assert(sizeof...(Constants) > 0, "shader_variant needs at least one constant");
+
+public:
+	static constexpr size_t constant_count = sizeof...(Constants);
+
+	static constexpr std::array<uint32_t, constant_count> constant_ids{Constants::id...};
+
+private:
+	std::array<uint32_t, constant_count> words_;
+
+	template <uint32_t Id>
+	[[nodiscard]] static constexpr size_t index_of() noexcept {
+		for (size_t i = 0; i < constant_count; ++i) {
+			if (constant_ids[i] == Id) { return i; }
+		}
+		return constant_count;
+	}
+
+	static_assert(details::unique_constant_ids(constant_ids), "shader_variant constant ids must be unique");
+
+	template <uint32_t Id>
+	using constant_at = std::tuple_element_t<index_of<Id>(), std::tuple<Constants...>>;
+
+public:
+	// folds in ids and types, so sets with the same values but different constants differ.
+	static constexpr uint64_t layout_hash = [] {
+		uint64_t hash = details::variant_hash_offset;
+		((hash = details::variant_hash(details::variant_hash(hash, Constants::id), details::spec_constant_traits<typename Constants::value_type>::tag)), ...);
+		return hash;
+	}();
+
+	static constexpr std::array<VkSpecializationMapEntry, constant_count> map_entries = details::specialization_map_entries(constant_ids);
+
+	constexpr shader_variant() noexcept :
+		words_{details::spec_constant_traits<typename Constants::value_type>::encode(Constants::default_value)...}
+	{ }
+
+	template <uint32_t Id>
+	constexpr shader_variant& set(typename constant_at<Id>::value_type value) noexcept {
+		words_[index_of<Id>()] = details::spec_constant_traits<typename constant_at<Id>::value_type>::encode(value);
+		return *this;
+	}
+
+	template <uint32_t Id>
+	[[nodiscard]] constexpr shader_variant with(typename constant_at<Id>::value_type value) const noexcept {
+		auto copy = *this;
+		copy.template set<Id>(value);
+		return copy;
+	}
+
+	template <uint32_t Id>
+	[[nodiscard]] constexpr typename constant_at<Id>::value_type get() const noexcept {
+		return details::spec_constant_traits<typename constant_at<Id>::value_type>::decode(words_[index_of<Id>()]);
+	}
+
+	[[nodiscard]] constexpr uint64_t key() const noexcept {
+		uint64_t hash = layout_hash;
+		for (auto word : words_) {
+			hash = details::variant_hash(hash, word);
+		}
+		// 0 is kept for the unspecialized pipeline.
+		return hash == 0 ? 1 : hash;
+	}
+
+	// points into this variant, which has to outlive the call it is passed to.
+	[[nodiscard]] specialization_info specialization() const noexcept {
+		specialization_info result{};
+		result.key = key();
+		result.info.mapEntryCount = static_cast<uint32_t>(constant_count);
+		result.info.pMapEntries = map_entries.data();
+		result.info.dataSize = sizeof(words_);
+		result.info.pData = words_.data();
+		return result;
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec3 fragNormal;
+layout(location = 1) in vec4 fragTangent;
+layout(location = 2) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // the bitangent for normal mapping is cross(normal, tangent.xyz) * tangent.w.
+    vec3 normal = normalize(fragNormal);
+    float light = max(dot(normal, normalize(vec3(0.3, 0.8, 0.5))), 0.0) * 0.8 + 0.2;
+    outColor = vec4(vec3(light), 1.0);
+}
@@ -0,0 +1,35 @@
+#version 450
+
+// decodes `packed_vertex`: positions are unorm over the mesh bounds, normals and tangents
+// octahedral snorm, uvs half floats the input assembler already widened.
+layout(push_constant) uniform mesh_constants {
+    mat4 model_view_projection;
+    // bounds_min and bounds_max - bounds_min of the mesh, w unused.
+    vec4 position_min;
+    vec4 position_extent;
+} constants;
+
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec2 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec2 inTangent;
+
+layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out vec4 fragTangent;
+layout(location = 2) out vec2 fragTexCoord;
+
+vec3 octahedral_decode(vec2 encoded) {
+    vec3 direction = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (direction.z < 0.0) {
+        direction.xy = (1.0 - abs(direction.yx)) * vec2(direction.x >= 0.0 ? 1.0 : -1.0, direction.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(direction);
+}
+
+void main() {
+    vec3 position = constants.position_min.xyz + inPosition.xyz * constants.position_extent.xyz;
+    gl_Position = constants.model_view_projection * vec4(position, 1.0);
+    fragNormal = octahedral_decode(inNormal);
+    fragTangent = vec4(octahedral_decode(inTangent), inPosition.w * 2.0 - 1.0);
+    fragTexCoord = inTexCoord;
+}
@@ -0,0 +1,18 @@
+#version 450
+
+layout(push_constant) uniform overlay_constants {
+    vec2 inverse_extent;
+    uint coverage_atlas;
+} constants;
+
+layout(set = 0, binding = 0) uniform sampler2D atlas;
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) in vec4 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec4 texel = texture(atlas, fragTexCoord);
+    outColor = constants.coverage_atlas != 0 ? vec4(fragColor.rgb, fragColor.a * texel.r) : fragColor * texel;
+}
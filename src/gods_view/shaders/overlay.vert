@@ -0,0 +1,19 @@
+#version 450
+
+layout(push_constant) uniform overlay_constants {
+    vec2 inverse_extent;
+    uint coverage_atlas;
+} constants;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec4 inColor;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) out vec4 fragColor;
+
+void main() {
+    gl_Position = vec4(inPosition * constants.inverse_extent * 2.0 - 1.0, 0.0, 1.0);
+    fragTexCoord = inTexCoord;
+    fragColor = inColor;
+}
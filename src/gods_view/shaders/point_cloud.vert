@@ -0,0 +1,18 @@
+#version 450
+
+layout(push_constant) uniform point_cloud_constants {
+    mat4 view_projection;
+    float point_size;
+} constants;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec4 inColor;
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+    gl_Position = constants.view_projection * vec4(inPosition, 1.0);
+    // only read for the point list pipeline.
+    gl_PointSize = constants.point_size;
+    fragColor = inColor;
+}
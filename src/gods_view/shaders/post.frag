@@ -0,0 +1,35 @@
+#version 450
+
+layout(push_constant) uniform post_constants {
+    float exposure_scale;
+    float lut_size;
+} constants;
+
+layout(input_attachment_index = 0, set = 0, binding = 0) uniform subpassInput scene;
+layout(set = 0, binding = 1) uniform sampler2D grade;
+
+layout(location = 0) out vec4 outColor;
+
+// narkowicz's fit of the aces reference tonemap.
+vec3 tonemap(vec3 color) {
+    return clamp((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0);
+}
+
+// the lut is `size` slices of red by green laid side by side along x, blue picks the slice.
+// it is indexed by the square root of the colour so the dark end gets more of the entries.
+vec3 grade_color(vec3 color) {
+    float size = constants.lut_size;
+    vec3 coordinate = sqrt(color) * (size - 1.0);
+    float slice = floor(coordinate.b);
+    float blend = coordinate.b - slice;
+    vec2 uv = (coordinate.rg + 0.5) / vec2(size * size, size);
+    vec2 next_slice = vec2(1.0 / size, 0.0);
+    vec2 lower = uv + next_slice * slice;
+    vec2 upper = uv + next_slice * min(slice + 1.0, size - 1.0);
+    return mix(texture(grade, lower).rgb, texture(grade, upper).rgb, blend);
+}
+
+void main() {
+    vec3 color = subpassLoad(scene).rgb * constants.exposure_scale;
+    outColor = vec4(grade_color(tonemap(color)), 1.0);
+}
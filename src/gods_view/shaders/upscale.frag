@@ -0,0 +1,17 @@
+#version 450
+
+layout(push_constant) uniform upscale_constants {
+    vec2 uv_scale;
+    vec2 uv_max;
+} constants;
+
+layout(set = 0, binding = 0) uniform sampler2D scene;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // the scene only covers part of its target, filtering must not reach past its edge.
+    outColor = texture(scene, min(fragTexCoord, constants.uv_max));
+}
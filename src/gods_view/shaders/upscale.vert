@@ -0,0 +1,15 @@
+#version 450
+
+layout(push_constant) uniform upscale_constants {
+    vec2 uv_scale;
+    vec2 uv_max;
+} constants;
+
+layout(location = 0) out vec2 fragTexCoord;
+
+void main() {
+    // one triangle covering the whole target, uv runs 0..1 across the visible part.
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+    fragTexCoord = uv * constants.uv_scale;
+}
@@ -0,0 +1,339 @@
+#include "gods_view/spatial_index.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <cmath>
+#include <system_error>
+
+namespace pg::gods_view {
+
+frustum frustum::from_view_projection(const float* matrix) noexcept {
+	// rows of the column major matrix.
+	float row[4][4];
+	for (int r = 0; r < 4; ++r) {
+		for (int c = 0; c < 4; ++c) {
+			row[r][c] = matrix[c * 4 + r];
+		}
+	}
+	frustum result{};
+	for (int c = 0; c < 4; ++c) {
+		result.planes[0][c] = row[3][c] + row[0][c];
+		result.planes[1][c] = row[3][c] - row[0][c];
+		result.planes[2][c] = row[3][c] + row[1][c];
+		result.planes[3][c] = row[3][c] - row[1][c];
+		result.planes[4][c] = row[2][c];
+		result.planes[5][c] = row[3][c] - row[2][c];
+	}
+	for (auto& plane : result.planes) {
+		const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		if (length > 0.0f) {
+			for (auto& value : plane) {
+				value /= length;
+			}
+		}
+	}
+	return result;
+}
+
+spatial_index::spatial_index(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	root_{invalid_spatial_proxy},
+	free_list_{invalid_spatial_proxy},
+	proxy_count_{0},
+	margin_{0.0f}
+{ }
+
+spatial_proxy spatial_index::insert(const aabb& box, uint32_t user_data) {
+	const auto proxy = allocate_node();
+	auto& leaf = nodes_[proxy];
+	leaf.tight = box;
+	leaf.box = fatten(box);
+	leaf.user_data = user_data;
+	leaf.height = 0;
+	insert_leaf(proxy);
+	++proxy_count_;
+	return proxy;
+}
+
+void spatial_index::remove(spatial_proxy proxy) {
+	if (proxy >= nodes_.size() || nodes_[proxy].height != 0) {
+		throw std::runtime_error{"Invalid spatial proxy"};
+	}
+	remove_leaf(proxy);
+	free_node(proxy);
+	--proxy_count_;
+}
+
+bool spatial_index::move(spatial_proxy proxy, const aabb& box) {
+	if (proxy >= nodes_.size() || nodes_[proxy].height != 0) {
+		throw std::runtime_error{"Invalid spatial proxy"};
+	}
+	auto& leaf = nodes_[proxy];
+	leaf.tight = box;
+	if (details::contains(leaf.box, box)) {
+		return false;
+	}
+	remove_leaf(proxy);
+	nodes_[proxy].box = fatten(box);
+	insert_leaf(proxy);
+	return true;
+}
+
+void spatial_index::clear() noexcept {
+	nodes_.clear();
+	root_ = invalid_spatial_proxy;
+	free_list_ = invalid_spatial_proxy;
+	proxy_count_ = 0;
+}
+
+void spatial_index::query(const aabb& box, std::vector<uint32_t>& results) const {
+	query(box, [&results](uint32_t user_data) { results.push_back(user_data); });
+}
+
+void spatial_index::query(const frustum& view, std::vector<uint32_t>& results) const {
+	query(view, [&results](uint32_t user_data) { results.push_back(user_data); });
+}
+
+std::optional<spatial_hit> spatial_index::pick(const ray& line) const {
+	if (root_ == invalid_spatial_proxy) { return std::nullopt; }
+	float inverse_direction[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		inverse_direction[axis] = 1.0f / line.direction[axis];
+	}
+	std::optional<spatial_hit> nearest;
+	float max_distance = line.max_distance;
+	std::array<uint32_t, details::spatial_stack_capacity> stack;
+	size_t count{0};
+	stack[count++] = root_;
+	while (count != 0) {
+		const auto& current = nodes_[stack[--count]];
+		if (current.leaf()) {
+			if (auto distance = details::intersect(current.tight, line.origin, inverse_direction, max_distance)) {
+				nearest = spatial_hit{current.user_data, *distance};
+				max_distance = *distance;
+			}
+			continue;
+		}
+		// nearer child is visited first so the shrinking range culls more of the farther one.
+		const auto near1 = details::intersect(nodes_[current.child1].box, line.origin, inverse_direction, max_distance);
+		const auto near2 = details::intersect(nodes_[current.child2].box, line.origin, inverse_direction, max_distance);
+		if (near1 && near2) {
+			const bool first_is_nearer = *near1 <= *near2;
+			stack[count++] = first_is_nearer ? current.child2 : current.child1;
+			stack[count++] = first_is_nearer ? current.child1 : current.child2;
+		} else if (near1) {
+			stack[count++] = current.child1;
+		} else if (near2) {
+			stack[count++] = current.child2;
+		}
+	}
+	return nearest;
+}
+
+void spatial_index::query(const std::vector<aabb>& boxes, std::vector<std::vector<uint32_t>>& results) const {
+	results.resize(boxes.size());
+	engine_->job_system()->parallel_for(0, boxes.size(), details::spatial_batch_grain, [this, &boxes, &results](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			results[i].clear();
+			query(boxes[i], results[i]);
+		}
+	});
+}
+
+void spatial_index::query(const std::vector<frustum>& views, std::vector<std::vector<uint32_t>>& results) const {
+	results.resize(views.size());
+	engine_->job_system()->parallel_for(0, views.size(), 1, [this, &views, &results](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			results[i].clear();
+			query(views[i], results[i]);
+		}
+	});
+}
+
+void spatial_index::pick(const std::vector<ray>& lines, std::vector<std::optional<spatial_hit>>& hits) const {
+	hits.resize(lines.size());
+	engine_->job_system()->parallel_for(0, lines.size(), details::spatial_batch_grain, [this, &lines, &hits](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			hits[i] = pick(lines[i]);
+		}
+	});
+}
+
+uint32_t spatial_index::allocate_node() {
+	uint32_t index;
+	if (free_list_ != invalid_spatial_proxy) {
+		index = free_list_;
+		free_list_ = nodes_[index].parent;
+	} else {
+		index = static_cast<uint32_t>(nodes_.size());
+		nodes_.emplace_back();
+	}
+	auto& result = nodes_[index];
+	result.parent = invalid_spatial_proxy;
+	result.child1 = invalid_spatial_proxy;
+	result.child2 = invalid_spatial_proxy;
+	result.height = 0;
+	result.user_data = 0;
+	return index;
+}
+
+void spatial_index::free_node(uint32_t index) noexcept {
+	nodes_[index].parent = free_list_;
+	nodes_[index].height = -1;
+	free_list_ = index;
+}
+
+aabb spatial_index::fatten(const aabb& box) const noexcept {
+	aabb result;
+	for (int axis = 0; axis < 3; ++axis) {
+		const float slack = margin_ + (box.max[axis] - box.min[axis]) * details::spatial_margin_ratio;
+		result.min[axis] = box.min[axis] - slack;
+		result.max[axis] = box.max[axis] + slack;
+	}
+	return result;
+}
+
+void spatial_index::insert_leaf(uint32_t leaf) {
+	if (root_ == invalid_spatial_proxy) {
+		root_ = leaf;
+		nodes_[leaf].parent = invalid_spatial_proxy;
+		return;
+	}
+
+	// descend towards the sibling that grows the tree's total area the least.
+	const aabb leaf_box = nodes_[leaf].box;
+	uint32_t index = root_;
+	while (!nodes_[index].leaf()) {
+		const auto& current = nodes_[index];
+		const float area = details::half_area(current.box);
+		const float combined_area = details::half_area(details::merge(current.box, leaf_box));
+		// pairing with this node directly.
+		const float cost = 2.0f * combined_area;
+		// what every deeper choice adds to this node's area.
+		const float inheritance = 2.0f * (combined_area - area);
+		auto descend_cost = [this, &leaf_box, inheritance](uint32_t child) {
+			const auto& candidate = nodes_[child];
+			const float merged = details::half_area(details::merge(candidate.box, leaf_box));
+			return (candidate.leaf() ? merged : merged - details::half_area(candidate.box)) + inheritance;
+		};
+		const float cost1 = descend_cost(current.child1);
+		const float cost2 = descend_cost(current.child2);
+		if (cost < cost1 && cost < cost2) { break; }
+		index = cost1 < cost2 ? current.child1 : current.child2;
+	}
+
+	const uint32_t sibling = index;
+	const uint32_t new_parent = allocate_node();
+	const uint32_t old_parent = nodes_[sibling].parent;
+	auto& parent = nodes_[new_parent];
+	parent.parent = old_parent;
+	parent.box = details::merge(leaf_box, nodes_[sibling].box);
+	parent.height = nodes_[sibling].height + 1;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+	if (old_parent == invalid_spatial_proxy) {
+		root_ = new_parent;
+	} else if (nodes_[old_parent].child1 == sibling) {
+		nodes_[old_parent].child1 = new_parent;
+	} else {
+		nodes_[old_parent].child2 = new_parent;
+	}
+	nodes_[sibling].parent = new_parent;
+	nodes_[leaf].parent = new_parent;
+	refit(old_parent);
+}
+
+void spatial_index::remove_leaf(uint32_t leaf) {
+	if (leaf == root_) {
+		root_ = invalid_spatial_proxy;
+		return;
+	}
+	const uint32_t parent = nodes_[leaf].parent;
+	const uint32_t grand_parent = nodes_[parent].parent;
+	const uint32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+	if (grand_parent == invalid_spatial_proxy) {
+		root_ = sibling;
+		nodes_[sibling].parent = invalid_spatial_proxy;
+		free_node(parent);
+		return;
+	}
+	if (nodes_[grand_parent].child1 == parent) {
+		nodes_[grand_parent].child1 = sibling;
+	} else {
+		nodes_[grand_parent].child2 = sibling;
+	}
+	nodes_[sibling].parent = grand_parent;
+	free_node(parent);
+	refit(grand_parent);
+}
+
+void spatial_index::refit(uint32_t index) {
+	while (index != invalid_spatial_proxy) {
+		index = balance(index);
+		auto& current = nodes_[index];
+		const auto& child1 = nodes_[current.child1];
+		const auto& child2 = nodes_[current.child2];
+		current.height = 1 + std::max(child1.height, child2.height);
+		current.box = details::merge(child1.box, child2.box);
+		index = current.parent;
+	}
+}
+
+uint32_t spatial_index::balance(uint32_t a) {
+	auto& node_a = nodes_[a];
+	if (node_a.leaf() || node_a.height < 2) {
+		return a;
+	}
+	const uint32_t b = node_a.child1;
+	const uint32_t c = node_a.child2;
+	auto& node_b = nodes_[b];
+	auto& node_c = nodes_[c];
+	const int32_t skew = node_c.height - node_b.height;
+
+	// lifts the taller child into a's place and hands its shorter grandchild to a.
+	auto rotate = [this, a, &node_a](uint32_t up, node& node_up, node& node_other, bool up_is_child2) {
+		const uint32_t f = node_up.child1;
+		const uint32_t g = node_up.child2;
+		auto& node_f = nodes_[f];
+		auto& node_g = nodes_[g];
+
+		node_up.child1 = a;
+		node_up.parent = node_a.parent;
+		node_a.parent = up;
+		if (node_up.parent == invalid_spatial_proxy) {
+			root_ = up;
+		} else if (nodes_[node_up.parent].child1 == a) {
+			nodes_[node_up.parent].child1 = up;
+		} else {
+			nodes_[node_up.parent].child2 = up;
+		}
+
+		const bool keep_f = node_f.height > node_g.height;
+		const uint32_t kept = keep_f ? f : g;
+		const uint32_t given = keep_f ? g : f;
+		auto& node_kept = keep_f ? node_f : node_g;
+		auto& node_given = keep_f ? node_g : node_f;
+		node_up.child2 = kept;
+		if (up_is_child2) {
+			node_a.child2 = given;
+		} else {
+			node_a.child1 = given;
+		}
+		node_given.parent = a;
+		node_a.box = details::merge(node_other.box, node_given.box);
+		node_a.height = 1 + std::max(node_other.height, node_given.height);
+		node_up.box = details::merge(node_a.box, node_kept.box);
+		node_up.height = 1 + std::max(node_a.height, node_kept.height);
+	};
+
+	if (skew > 1) {
+		rotate(c, node_c, node_b, true);
+		return c;
+	}
+	if (skew < -1) {
+		rotate(b, node_b, node_c, false);
+		return b;
+	}
+	return a;
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,304 @@
+#if !defined PG_GODS_VIEW_SPATIAL_INDEX_HEADER_INCLUDED
+#define PG_GODS_VIEW_SPATIAL_INDEX_HEADER_INCLUDED
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace pg::gods_view {
+
+using spatial_proxy = uint32_t;
+
+constexpr spatial_proxy invalid_spatial_proxy = std::numeric_limits<spatial_proxy>::max();
+
+struct aabb {
+	float min[3];
+	float max[3];
+};
+
+struct ray {
+	float origin[3];
+	float direction[3];
+	float max_distance;
+};
+
+// planes point inwards, a point is inside when dot(plane.xyz, p) + plane.w >= 0 for all six.
+struct frustum {
+	float planes[6][4];
+
+	// column major view projection with vulkan's [0, 1] clip depth.
+	static frustum from_view_projection(const float* matrix) noexcept;
+};
+
+struct spatial_hit {
+	uint32_t user_data;
+	float distance;
+};
+
+namespace details {
+
+// an avl balanced tree over 32 bit proxies stays far below this height.
+constexpr size_t spatial_stack_capacity = 128;
+constexpr float spatial_margin_ratio = 0.1f;
+constexpr size_t spatial_batch_grain = 16;
+
+[[nodiscard]] inline aabb merge(const aabb& a, const aabb& b) noexcept {
+	return {
+		{std::min(a.min[0], b.min[0]), std::min(a.min[1], b.min[1]), std::min(a.min[2], b.min[2])},
+		{std::max(a.max[0], b.max[0]), std::max(a.max[1], b.max[1]), std::max(a.max[2], b.max[2])}
+	};
+}
+
+[[nodiscard]] inline bool contains(const aabb& outer, const aabb& inner) noexcept {
+	return outer.min[0] <= inner.min[0] && outer.min[1] <= inner.min[1] && outer.min[2] <= inner.min[2] &&
+		inner.max[0] <= outer.max[0] && inner.max[1] <= outer.max[1] && inner.max[2] <= outer.max[2];
+}
+
+[[nodiscard]] inline bool overlaps(const aabb& a, const aabb& b) noexcept {
+	return a.min[0] <= b.max[0] && b.min[0] <= a.max[0] &&
+		a.min[1] <= b.max[1] && b.min[1] <= a.max[1] &&
+		a.min[2] <= b.max[2] && b.min[2] <= a.max[2];
+}
+
+// half the surface area, enough to compare insertion costs.
+[[nodiscard]] inline float half_area(const aabb& box) noexcept {
+	const float x = box.max[0] - box.min[0];
+	const float y = box.max[1] - box.min[1];
+	const float z = box.max[2] - box.min[2];
+	return x * y + y * z + z * x;
+}
+
+enum class frustum_overlap {
+	outside,
+	intersecting,
+	inside
+};
+
+// `plane_mask` holds the planes the box still has to be tested against, planes that fully
+// contain it are cleared.
+[[nodiscard]] inline frustum_overlap classify(const frustum& view, const aabb& box, uint32_t& plane_mask) noexcept {
+	for (uint32_t plane = 0; plane < 6; ++plane) {
+		if ((plane_mask & (1u << plane)) == 0) { continue; }
+		const float* p = view.planes[plane];
+		const float far_x = p[0] >= 0.0f ? box.max[0] : box.min[0];
+		const float far_y = p[1] >= 0.0f ? box.max[1] : box.min[1];
+		const float far_z = p[2] >= 0.0f ? box.max[2] : box.min[2];
+		if (p[0] * far_x + p[1] * far_y + p[2] * far_z + p[3] < 0.0f) {
+			return frustum_overlap::outside;
+		}
+		const float near_x = p[0] >= 0.0f ? box.min[0] : box.max[0];
+		const float near_y = p[1] >= 0.0f ? box.min[1] : box.max[1];
+		const float near_z = p[2] >= 0.0f ? box.min[2] : box.max[2];
+		if (p[0] * near_x + p[1] * near_y + p[2] * near_z + p[3] >= 0.0f) {
+			plane_mask &= ~(1u << plane);
+		}
+	}
+	return plane_mask == 0 ? frustum_overlap::inside : frustum_overlap::intersecting;
+}
+
+// distance along the ray where it enters the box, nothing when it misses within range.
+[[nodiscard]] inline std::optional<float> intersect(const aabb& box, const float* origin, const float* inverse_direction, float max_distance) noexcept {
+	float enter = 0.0f;
+	float exit = max_distance;
+	for (int axis = 0; axis < 3; ++axis) {
+		float t0 = (box.min[axis] - origin[axis]) * inverse_direction[axis];
+		float t1 = (box.max[axis] - origin[axis]) * inverse_direction[axis];
+		if (t0 > t1) { std::swap(t0, t1); }
+		// written so a nan from a ray lying in the slab plane leaves the range alone.
+		enter = t0 > enter ? t0 : enter;
+		exit = t1 < exit ? t1 : exit;
+		if (enter > exit) { return std::nullopt; }
+	}
+	return enter;
+}
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// dynamic bounding volume hierarchy for visibility and picking queries. leaves keep a fattened
+// copy of their box so an object moving inside its margin costs nothing; one that leaves it is
+// reinserted with a surface area heuristic and the tree is kept avl balanced by rotations, so
+// moving objects never force a rebuild. queries skip whole subtrees, frustum queries stop
+// testing planes once a node lies fully on their inside, and the batch overloads spread many
+// queries over the job system.
+class spatial_index {
+private:
+	struct node {
+		aabb box;
+		// exact bounds, leaves only.
+		aabb tight;
+		// next free node while on the free list.
+		uint32_t parent;
+		uint32_t child1;
+		uint32_t child2;
+		// leaves are 0, free nodes -1.
+		int32_t height;
+		uint32_t user_data;
+
+		[[nodiscard]] bool leaf() const noexcept { return child1 == invalid_spatial_proxy; }
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::vector<node> nodes_;
+	uint32_t root_;
+	uint32_t free_list_;
+	uint32_t proxy_count_;
+	float margin_;
+
+public:
+	spatial_index(gods_view::vulkan_engine* init_engine);
+
+	spatial_index(const spatial_index&) = delete;
+
+	spatial_index& operator=(const spatial_index&) = delete;
+
+	// world space slack added around every box on top of a tenth of its extent.
+	void margin(float value) noexcept { margin_ = value; }
+
+	[[nodiscard]] uint32_t size() const noexcept { return proxy_count_; }
+
+	[[nodiscard]] int32_t height() const noexcept { return root_ == invalid_spatial_proxy ? 0 : nodes_[root_].height; }
+
+	[[nodiscard]] uint32_t user_data(spatial_proxy proxy) const noexcept { return nodes_[proxy].user_data; }
+
+	[[nodiscard]] const aabb& bounds(spatial_proxy proxy) const noexcept { return nodes_[proxy].tight; }
+
+	spatial_proxy insert(const aabb& box, uint32_t user_data);
+
+	void remove(spatial_proxy proxy);
+
+	// true when the box left its margin and the proxy was reinserted.
+	bool move(spatial_proxy proxy, const aabb& box);
+
+	void clear() noexcept;
+
+	// calls `function(user_data)` for every box overlapping `box`.
+	template <typename Function>
+	void query(const aabb& box, Function&& function) const {
+		if (root_ == invalid_spatial_proxy) { return; }
+		std::array<uint32_t, details::spatial_stack_capacity> stack;
+		size_t count{0};
+		stack[count++] = root_;
+		while (count != 0) {
+			const auto& current = nodes_[stack[--count]];
+			if (!details::overlaps(current.box, box)) { continue; }
+			if (current.leaf()) {
+				if (details::overlaps(current.tight, box)) {
+					function(current.user_data);
+				}
+				continue;
+			}
+			stack[count++] = current.child1;
+			stack[count++] = current.child2;
+		}
+	}
+
+	// calls `function(user_data)` for every box at least partly inside `view`.
+	template <typename Function>
+	void query(const frustum& view, Function&& function) const {
+		if (root_ == invalid_spatial_proxy) { return; }
+		std::array<uint32_t, details::spatial_stack_capacity> stack;
+		std::array<uint32_t, details::spatial_stack_capacity> masks;
+		size_t count{0};
+		stack[count] = root_;
+		masks[count++] = 0x3f;
+		while (count != 0) {
+			--count;
+			const auto& current = nodes_[stack[count]];
+			uint32_t mask = masks[count];
+			const auto overlap = details::classify(view, current.leaf() ? current.tight : current.box, mask);
+			if (overlap == details::frustum_overlap::outside) { continue; }
+			if (current.leaf()) {
+				function(current.user_data);
+			} else if (overlap == details::frustum_overlap::inside) {
+				for_each_leaf(stack[count], function);
+			} else {
+				stack[count] = current.child1;
+				masks[count++] = mask;
+				stack[count] = current.child2;
+				masks[count++] = mask;
+			}
+		}
+	}
+
+	// calls `function(user_data, distance)` for every box the ray passes through, in no order.
+	template <typename Function>
+	void query(const ray& line, Function&& function) const {
+		if (root_ == invalid_spatial_proxy) { return; }
+		float inverse_direction[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			inverse_direction[axis] = 1.0f / line.direction[axis];
+		}
+		std::array<uint32_t, details::spatial_stack_capacity> stack;
+		size_t count{0};
+		stack[count++] = root_;
+		while (count != 0) {
+			const auto& current = nodes_[stack[--count]];
+			if (!details::intersect(current.box, line.origin, inverse_direction, line.max_distance)) { continue; }
+			if (current.leaf()) {
+				if (auto distance = details::intersect(current.tight, line.origin, inverse_direction, line.max_distance)) {
+					function(current.user_data, *distance);
+				}
+				continue;
+			}
+			stack[count++] = current.child1;
+			stack[count++] = current.child2;
+		}
+	}
+
+	void query(const aabb& box, std::vector<uint32_t>& results) const;
+
+	void query(const frustum& view, std::vector<uint32_t>& results) const;
+
+	// nearest box along the ray.
+	[[nodiscard]] std::optional<spatial_hit> pick(const ray& line) const;
+
+	// one result list per query, run in parallel.
+	void query(const std::vector<aabb>& boxes, std::vector<std::vector<uint32_t>>& results) const;
+
+	void query(const std::vector<frustum>& views, std::vector<std::vector<uint32_t>>& results) const;
+
+	void pick(const std::vector<ray>& lines, std::vector<std::optional<spatial_hit>>& hits) const;
+
+private:
+	template <typename Function>
+	void for_each_leaf(uint32_t subtree, Function& function) const {
+		std::array<uint32_t, details::spatial_stack_capacity> stack;
+		size_t count{0};
+		stack[count++] = subtree;
+		while (count != 0) {
+			const auto& current = nodes_[stack[--count]];
+			if (current.leaf()) {
+				function(current.user_data);
+				continue;
+			}
+			stack[count++] = current.child1;
+			stack[count++] = current.child2;
+		}
+	}
+
+	uint32_t allocate_node();
+
+	void free_node(uint32_t index) noexcept;
+
+	aabb fatten(const aabb& box) const noexcept;
+
+	void insert_leaf(uint32_t leaf);
+
+	void remove_leaf(uint32_t leaf);
+
+	// walks from `index` to the root, rebalancing and refitting on the way.
+	void refit(uint32_t index);
+
+	uint32_t balance(uint32_t index);
+};
+
+} // end namespace pg::gods_view
+
+#endif
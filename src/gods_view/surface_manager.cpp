@@ -7,28 +7,85 @@
 namespace pg::gods_view {
 
 surface_manager::surface_manager(vulkan_engine* init_engine) :
-	engine_{init_engine},
-	surface_{nullptr}
+	engine_{init_engine}
 { }
 
 surface_manager::~surface_manager() {
-	destroy_image_views();
-	destroy_swap_chain();
-	destroy_surface();
+	for (auto& target : surfaces_) {
+		destroy_image_views(target);
+		destroy_swap_chain(target);
+		destroy_surface(target);
+	}
 }
 
-void surface_manager::create_vulkan_surface(GLFWwindow* window) {
-	if (glfwCreateWindowSurface(engine_->vulkan_instance()->vk_instance(), window, nullptr, &surface_) != VK_SUCCESS) {
+size_t surface_manager::create_vulkan_surface(GLFWwindow* window) {
+	window_surface target{};
+	target.window = window;
+	if (glfwCreateWindowSurface(engine_->vulkan_instance()->vk_instance(), window, nullptr, &target.surface) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create window surface"};
 	}
+	surfaces_.push_back(target);
+	return surfaces_.size() - 1;
+}
+
+bool surface_manager::presentable(size_t surface_index) const {
+	auto window = surfaces_[surface_index].window;
+	if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) == GLFW_TRUE || glfwGetWindowAttrib(window, GLFW_VISIBLE) == GLFW_FALSE) {
+		return false;
+	}
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	return width > 0 && height > 0;
 }
 
 void surface_manager::create_swap_chain() {
-	swap_chain_support_details swap_chain_support = details::query_swap_chain_support(engine_->device_manager()->physical_device(), surface_);
+	for (auto& target : surfaces_) {
+		if (target.swap_chain == VK_NULL_HANDLE) {
+			create_swap_chain(target);
+		}
+	}
+}
+
+void surface_manager::create_image_views() {
+	for (auto& target : surfaces_) {
+		if (target.image_views.empty()) {
+			create_image_views(target);
+		}
+	}
+}
+
+void surface_manager::recreate_swap_chain(size_t surface_index) {
+	auto& target = surfaces_[surface_index];
+	destroy_image_views(target);
+	target.image_views.clear();
+	// the old one is still alive while the new one is created, the driver may hand its resources
+	// over, and the format stays the one the render pass was built for.
+	const VkSwapchainKHR old_swap_chain = target.swap_chain;
+	try {
+		create_swap_chain(target, old_swap_chain);
+	} catch (...) {
+		target.swap_chain = old_swap_chain;
+		throw;
+	}
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.destroy_swapchain_khr(engine_->device_manager()->logical_device(), old_swap_chain, nullptr);
+	create_image_views(target);
+}
+
+void surface_manager::create_swap_chain(window_surface& target, VkSwapchainKHR old_swap_chain) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto physical_device = engine_->device_manager()->physical_device();
+	const auto& indices = engine_->device_manager()->queue_families();
+	VkBool32 present_support = VK_FALSE;
+	vkGetPhysicalDeviceSurfaceSupportKHR(physical_device, indices.present_family.value(), target.surface, &present_support);
+	if (present_support != VK_TRUE) {
+		throw std::runtime_error{"Window surface cannot be presented from the device's present queue"};
+	}
+	swap_chain_support_details swap_chain_support = details::query_swap_chain_support(physical_device, target.surface);
 
 	VkSurfaceFormatKHR surface_format = choose_swap_surface_format(swap_chain_support.formats);
 	VkPresentModeKHR present_mode = choose_swap_present_mode(swap_chain_support.present_modes);
-	VkExtent2D extent = choose_swap_extent(swap_chain_support.capabilities);
+	VkExtent2D extent = choose_swap_extent(target, swap_chain_support.capabilities);
 
 	uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
 	if (swap_chain_support.capabilities.maxImageCount > 0 && image_count > swap_chain_support.capabilities.maxImageCount) {
@@ -37,15 +94,19 @@ void surface_manager::create_swap_chain() {
 
 	VkSwapchainCreateInfoKHR create_info{};
 	create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-	create_info.surface = surface_;
+	create_info.surface = target.surface;
 	create_info.minImageCount = image_count;
 	create_info.imageFormat = surface_format.format;
 	create_info.imageColorSpace = surface_format.colorSpace;
 	create_info.imageExtent = extent;
 	create_info.imageArrayLayers = 1;
 	create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	// lets frames be read back without an extra blit, where the surface allows it.
+	target.capturable = (swap_chain_support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) != 0;
+	if (target.capturable) {
+		create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	}
 
-	queue_family_indices indices = details::find_queue_families(engine_->device_manager()->physical_device(), surface_);
 	uint32_t queue_family_indices_val[] = {indices.graphics_family.value(), indices.present_family.value()};
 	if (indices.graphics_family != indices.present_family) {
 		create_info.imageSharingMode = VK_SHARING_MODE_CONCURRENT;
@@ -58,27 +119,28 @@ void surface_manager::create_swap_chain() {
 	create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 	create_info.presentMode = present_mode;
 	create_info.clipped= VK_TRUE;
-	create_info.oldSwapchain = VK_NULL_HANDLE;
+	create_info.oldSwapchain = old_swap_chain;
 
-	if (vkCreateSwapchainKHR(engine_->device_manager()->logical_device(), &create_info, nullptr, &swap_chain_) != VK_SUCCESS) {
+	if (vk.create_swapchain_khr(engine_->device_manager()->logical_device(), &create_info, nullptr, &target.swap_chain) != VK_SUCCESS) {
 		throw std::runtime_error{"Failed to create swap chain"};
 	}
-	vkGetSwapchainImagesKHR(engine_->device_manager()->logical_device(), swap_chain_, &image_count, nullptr);
-	swap_chain_images_.resize(image_count);
-	vkGetSwapchainImagesKHR(engine_->device_manager()->logical_device(), swap_chain_, &image_count, swap_chain_images_.data());
-	swap_chain_image_format_ = surface_format.format;
-	swap_chain_extent_ = extent;
+	vk.get_swapchain_images_khr(engine_->device_manager()->logical_device(), target.swap_chain, &image_count, nullptr);
+	target.images.resize(image_count);
+	vk.get_swapchain_images_khr(engine_->device_manager()->logical_device(), target.swap_chain, &image_count, target.images.data());
+	target.image_format = surface_format.format;
+	target.extent = extent;
 }
 
-void surface_manager::create_image_views() {
-	swap_chain_image_views_.resize(swap_chain_images_.size());
+void surface_manager::create_image_views(window_surface& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	target.image_views.resize(target.images.size());
 
-	for (size_t i = 0; i < swap_chain_images_.size(); ++i) {
+	for (size_t i = 0; i < target.images.size(); ++i) {
 		VkImageViewCreateInfo create_info{};
 		create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		create_info.image = swap_chain_images_[i];
+		create_info.image = target.images[i];
 		create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		create_info.format = swap_chain_image_format_;
+		create_info.format = target.image_format;
 		create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
 		create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
 		create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -88,18 +150,18 @@ void surface_manager::create_image_views() {
 		create_info.subresourceRange.levelCount = 1;
 		create_info.subresourceRange.baseArrayLayer = 0;
 		create_info.subresourceRange.layerCount = 1;
-		if (vkCreateImageView(engine_->device_manager()->logical_device(), &create_info, nullptr, &swap_chain_image_views_[i]) != VK_SUCCESS) {
+		if (vk.create_image_view(engine_->device_manager()->logical_device(), &create_info, nullptr, &target.image_views[i]) != VK_SUCCESS) {
 			throw std::runtime_error{"Failed to create image views"};
 		}
 	}
 }
 
-VkExtent2D surface_manager::choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities) {
+VkExtent2D surface_manager::choose_swap_extent(const window_surface& target, const VkSurfaceCapabilitiesKHR& capabilities) {
 	if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
 		return capabilities.currentExtent;
 	} else {
 		int width, height;
-		glfwGetFramebufferSize(engine_->current_window(), &width, &height);
+		glfwGetFramebufferSize(target.window, &width, &height);
 		VkExtent2D actual_extent = {
 			static_cast<uint32_t>(width),
 			static_cast<uint32_t>(height)
@@ -118,17 +180,19 @@ VkExtent2D surface_manager::choose_swap_extent(const VkSurfaceCapabilitiesKHR& c
 	}
 }
 
-void surface_manager::destroy_surface() {
-	vkDestroySurfaceKHR(engine_->vulkan_instance()->vk_instance(), surface_, nullptr);
+void surface_manager::destroy_surface(window_surface& target) {
+	vkDestroySurfaceKHR(engine_->vulkan_instance()->vk_instance(), target.surface, nullptr);
 }
 
-void surface_manager::destroy_swap_chain() {
-	vkDestroySwapchainKHR(engine_->device_manager()->logical_device(), swap_chain_, nullptr);
+void surface_manager::destroy_swap_chain(window_surface& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	vk.destroy_swapchain_khr(engine_->device_manager()->logical_device(), target.swap_chain, nullptr);
 }
 
-void surface_manager::destroy_image_views() {
-	for (auto image_view : swap_chain_image_views_) {
-		vkDestroyImageView(engine_->device_manager()->logical_device(), image_view, nullptr);
+void surface_manager::destroy_image_views(window_surface& target) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	for (auto image_view : target.image_views) {
+		vk.destroy_image_view(engine_->device_manager()->logical_device(), image_view, nullptr);
 	}
 }
 
@@ -5,6 +5,8 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include <cstddef>
+#include <system_error>
 #include <vector>
 
 namespace pg::gods_view {
@@ -37,41 +39,82 @@ static swap_chain_support_details query_swap_chain_support(VkPhysicalDevice devi
 
 } // end namespace pg::gods_view::details
 
+// one window's surface, swap chain and image views. every swap chain shares the render pass
+// format chosen for the first surface.
+struct window_surface {
+	GLFWwindow* window;
+	VkSurfaceKHR surface;
+	VkSwapchainKHR swap_chain;
+	std::vector<VkImage> images;
+	VkFormat image_format;
+	VkExtent2D extent;
+	std::vector<VkImageView> image_views;
+	// the images can be copied from, see `capture_manager`.
+	bool capturable;
+};
+
+// a swap chain image acquired for the current frame.
+struct frame_target {
+	size_t surface_index;
+	uint32_t image_index;
+};
+
 class vulkan_engine;
 
 class surface_manager {
 private:
 	gods_view::vulkan_engine* engine_;
-	VkSurfaceKHR surface_;
-	VkSwapchainKHR swap_chain_;
-	std::vector<VkImage> swap_chain_images_;
-	VkFormat swap_chain_image_format_;
-	VkExtent2D swap_chain_extent_;
-	std::vector<VkImageView> swap_chain_image_views_;
+	std::vector<window_surface> surfaces_;
 	
 public:
 	surface_manager(gods_view::vulkan_engine* init_engine);
 
 	~surface_manager();
 
-	[[nodiscard]] VkSurfaceKHR surface() const noexcept { return surface_; }
+	[[nodiscard]] size_t surface_count() const noexcept { return surfaces_.size(); }
+
+	// the first surface picks the physical device and present queue, later ones must be presentable from it.
+	[[nodiscard]] VkSurfaceKHR surface(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].surface; }
+
+	[[nodiscard]] GLFWwindow* window(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].window; }
+
+	[[nodiscard]] VkFormat swap_chain_image_format() const noexcept { return surfaces_.front().image_format; }
 
-	[[nodiscard]] VkFormat swap_chain_image_format() const noexcept { return swap_chain_image_format_; }
+	[[nodiscard]] const std::vector<VkImageView>& swap_chain_image_views(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].image_views; }
 
-	[[nodiscard]] const std::vector<VkImageView>& swap_chain_image_views() const noexcept { return swap_chain_image_views_; }
+	[[nodiscard]] const std::vector<VkImage>& swap_chain_images(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].images; }
 
-	[[nodiscard]] const VkExtent2D swap_chain_extent() const noexcept { return swap_chain_extent_; }
+	[[nodiscard]] bool capturable(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].capturable; }
 
-	[[nodiscard]] const VkSwapchainKHR swapchain() const noexcept { return swap_chain_; }
+	[[nodiscard]] const VkExtent2D swap_chain_extent(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].extent; }
 
-	void create_vulkan_surface(GLFWwindow* window);
+	[[nodiscard]] const VkSwapchainKHR swapchain(size_t surface_index = 0) const noexcept { return surfaces_[surface_index].swap_chain; }
 
+	// false while the window is minimized, hidden or has no area, there is nothing to present to.
+	[[nodiscard]] bool presentable(size_t surface_index) const;
+
+	size_t create_vulkan_surface(GLFWwindow* window);
+
+	// creates swap chains for every surface that does not have one yet.
 	void create_swap_chain();
 
 	void create_image_views();
 
+	// replaces the surface's swap chain and image views once it went out of date or suboptimal,
+	// e.g. after a resize. the gpu must be done with the old images.
+	void recreate_swap_chain(size_t surface_index);
+
 private:
 	VkSurfaceFormatKHR choose_swap_surface_format(const std::vector<VkSurfaceFormatKHR>& available_formats) {
+		if (!surfaces_.empty() && surfaces_.front().swap_chain != VK_NULL_HANDLE) {
+			// the render pass is already built for the first swap chain's format.
+			for (const auto& available_format : available_formats) {
+				if (available_format.format == surfaces_.front().image_format) {
+					return available_format;
+				}
+			}
+			throw std::runtime_error{"Window surface does not support the swap chain format"};
+		}
 		for (const auto& available_format : available_formats) {
 			if (available_format.format == VK_FORMAT_B8G8R8A8_SRGB && available_format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
 				return available_format;
@@ -89,13 +132,17 @@ private:
 		return VK_PRESENT_MODE_FIFO_KHR;
 	}
 
-	VkExtent2D choose_swap_extent(const VkSurfaceCapabilitiesKHR& capabilities);
+	VkExtent2D choose_swap_extent(const window_surface& target, const VkSurfaceCapabilitiesKHR& capabilities);
+
+	void create_swap_chain(window_surface& target, VkSwapchainKHR old_swap_chain = VK_NULL_HANDLE);
+
+	void create_image_views(window_surface& target);
 
-	void destroy_surface();
+	void destroy_surface(window_surface& target);
 
-	void destroy_swap_chain();
+	void destroy_swap_chain(window_surface& target);
 
-	void destroy_image_views();
+	void destroy_image_views(window_surface& target);
 };
 
 } // end namespace pg::gods_view
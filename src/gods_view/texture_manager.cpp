@@ -0,0 +1,609 @@
+#include "gods_view/texture_manager.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr float texture_default_budget_fraction = 0.9f;
+// share of the heap assumed available when VK_EXT_memory_budget is missing.
+constexpr float texture_fallback_heap_fraction = 0.8f;
+constexpr VkDeviceSize texture_staging_alignment = 16;
+constexpr uint64_t texture_blocked_frames = 30;
+constexpr uint32_t texture_max_evictions_per_frame = 64;
+
+static VkExtent3D mip_extent(const texture_desc& desc, uint32_t mip) {
+	return {std::max(1u, desc.width >> mip), std::max(1u, desc.height >> mip), 1};
+}
+
+} // end namespace pg::gods_view::details
+
+texture_manager::texture_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	command_pool_{VK_NULL_HANDLE},
+	sampler_{VK_NULL_HANDLE},
+	heap_index_{0},
+	resident_bytes_{0},
+	heap_budget_{0},
+	heap_usage_{0},
+	resident_bytes_at_query_{0},
+	budget_fraction_{details::texture_default_budget_fraction},
+	frame_{0},
+	evicted_mips_{0},
+	initialized_{false},
+	max_decoders_{1},
+	active_decoders_{0},
+	stopping_{false},
+	decode_jobs_{0}
+{ }
+
+texture_manager::~texture_manager() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	{
+		std::lock_guard<std::mutex> lock{queue_mutex_};
+		stopping_ = true;
+	}
+	// decodes already running finish, queued ones see `stopping_` and return straight away.
+	engine_->job_system()->wait_background(decode_jobs_);
+	if (!initialized_) { return; }
+
+	auto device = engine_->device_manager()->logical_device();
+	for (auto& batch : batches_) {
+		if (batch.in_flight) {
+			vk.wait_for_fences(device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+		}
+		destroy_batch(batch);
+	}
+	for (auto& texture : textures_) {
+		engine_->resource_pool()->destroy(texture.image);
+	}
+	details::destroy_image(vk, fallback_image_);
+	vk.destroy_sampler(device, sampler_, nullptr);
+	vk.destroy_command_pool(device, command_pool_, nullptr);
+}
+
+texture_stream_stats texture_manager::stats() const {
+	texture_stream_stats result{};
+	result.resident_bytes = resident_bytes_;
+	result.heap_budget = heap_budget_;
+	result.heap_usage = heap_usage_;
+	result.evicted_mips = evicted_mips_;
+	for (const auto& batch : batches_) {
+		if (batch.in_flight) { ++result.uploads_in_flight; }
+	}
+	std::lock_guard<std::mutex> lock{queue_mutex_};
+	result.pending_decodes = static_cast<uint32_t>(decode_queue_.size());
+	return result;
+}
+
+void texture_manager::initialize(uint32_t max_decoders) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	const auto& memory_properties = engine_->device_manager()->memory_properties();
+
+	VkCommandPoolCreateInfo pool_info{};
+	pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	pool_info.queueFamilyIndex = engine_->device_manager()->queue_families().graphics_family.value();
+	if (vk.create_command_pool(device, &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create texture upload command pool"};
+	}
+
+	batches_.resize(details::texture_upload_batches);
+	std::vector<VkCommandBuffer> command_buffers(batches_.size());
+	VkCommandBufferAllocateInfo allocate_info{};
+	allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocate_info.commandPool = command_pool_;
+	allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocate_info.commandBufferCount = static_cast<uint32_t>(command_buffers.size());
+	if (vk.allocate_command_buffers(device, &allocate_info, command_buffers.data()) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to allocate texture upload command buffers"};
+	}
+
+	VkFenceCreateInfo fence_info{};
+	fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	for (size_t i = 0; i < batches_.size(); ++i) {
+		auto& batch = batches_[i];
+		batch.command_buffer = command_buffers[i];
+		batch.staging_used = 0;
+		batch.in_flight = false;
+		if (vk.create_fence(device, &fence_info, nullptr, &batch.fence) != VK_SUCCESS) {
+			throw std::runtime_error{"Failed to create texture upload fence"};
+		}
+		batch.staging = details::create_buffer(
+			vk,
+			memory_properties,
+			details::texture_staging_size,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		);
+	}
+
+	VkSamplerCreateInfo sampler_info{};
+	sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	sampler_info.magFilter = VK_FILTER_LINEAR;
+	sampler_info.minFilter = VK_FILTER_LINEAR;
+	sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+	if (vk.create_sampler(device, &sampler_info, nullptr, &sampler_) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to create texture sampler"};
+	}
+
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+		if (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+			heap_index_ = memory_properties.memoryTypes[i].heapIndex;
+			break;
+		}
+	}
+
+	create_fallback_image();
+	initialized_ = true;
+	query_budget();
+	max_decoders_ = std::max(max_decoders, 1u);
+}
+
+texture_id texture_manager::create_texture(texture_desc desc) {
+	if (desc.mip_levels == 0 || desc.width == 0 || desc.height == 0 || !desc.decode) {
+		throw std::runtime_error{"Invalid texture description"};
+	}
+	const auto id = static_cast<texture_id>(textures_.size());
+	engine_->trace_recorder()->texture_create(id, desc);
+	texture_entry entry{};
+	entry.resident_mip = desc.mip_levels;
+	entry.wanted_mip = desc.mip_levels - 1;
+	entry.pending_mip = desc.mip_levels;
+	entry.desc = std::move(desc);
+	textures_.push_back(std::move(entry));
+	return id;
+}
+
+texture_id texture_manager::load_texture_file(const std::string& filename) {
+	std::ifstream file{filename, std::ios::binary};
+	if (!file.is_open()) {
+		throw std::runtime_error{"Failed to open file"};
+	}
+	texture_file_header header{};
+	file.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!file || std::memcmp(header.magic, "GVTX", 4) != 0 || header.version != details::texture_file_version) {
+		throw std::runtime_error{"Invalid texture file"};
+	}
+	auto mips = std::make_shared<std::vector<texture_file_mip>>(header.mip_levels);
+	file.read(reinterpret_cast<char*>(mips->data()), sizeof(texture_file_mip) * header.mip_levels);
+	if (!file) {
+		throw std::runtime_error{"Invalid texture file"};
+	}
+
+	texture_desc desc{};
+	desc.width = header.width;
+	desc.height = header.height;
+	desc.mip_levels = header.mip_levels;
+	desc.format = static_cast<VkFormat>(header.format);
+	desc.decode = [filename, mips](uint32_t mip_level) {
+		const auto& mip = (*mips)[mip_level];
+		std::ifstream source{filename, std::ios::binary};
+		std::vector<std::byte> texels(static_cast<size_t>(mip.size));
+		source.seekg(static_cast<std::streamoff>(mip.offset));
+		source.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(mip.size));
+		if (!source) {
+			texels.clear();
+		}
+		return texels;
+	};
+	return create_texture(std::move(desc));
+}
+
+void texture_manager::request(texture_id id, float screen_extent) {
+	engine_->trace_recorder()->texture_request(id, screen_extent);
+	auto& texture = textures_[id];
+	const uint32_t coarsest = texture.desc.mip_levels - 1;
+	uint32_t mip = coarsest;
+	if (screen_extent >= 1.0f) {
+		const float longest = static_cast<float>(std::max(texture.desc.width, texture.desc.height));
+		const float level = std::floor(std::log2(longest / screen_extent));
+		mip = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(coarsest)));
+	}
+	if (texture.requested_frame != frame_) {
+		texture.requested_frame = frame_;
+		texture.wanted_mip = mip;
+		texture.priority = screen_extent;
+	} else {
+		texture.wanted_mip = std::min(texture.wanted_mip, mip);
+		texture.priority = std::max(texture.priority, screen_extent);
+	}
+}
+
+VkImageView texture_manager::image_view(texture_id id) const noexcept {
+	const auto& texture = textures_[id];
+	return texture.image ? engine_->resource_pool()->view(texture.image) : fallback_image_.view;
+}
+
+bool texture_manager::busy() const {
+	if (!initialized_) { return false; }
+	if (!ready_.empty()) { return true; }
+	for (const auto& batch : batches_) {
+		if (batch.in_flight) { return true; }
+	}
+	for (const auto& texture : textures_) {
+		if (texture.pending_mip != texture.desc.mip_levels) { return true; }
+	}
+	return false;
+}
+
+void texture_manager::update() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	if (!initialized_) { return; }
+	retire_batches();
+	{
+		std::lock_guard<std::mutex> lock{queue_mutex_};
+		std::move(decoded_.begin(), decoded_.end(), std::back_inserter(ready_));
+		decoded_.clear();
+	}
+
+	if (!ready_.empty() || (frame_ % 16) == 0) {
+		query_budget();
+	}
+	if (!ready_.empty() || !fits_budget(0)) {
+		auto batch = std::find_if(batches_.begin(), batches_.end(), [](const upload_batch& b) { return !b.in_flight; });
+		if (batch != batches_.end()) {
+			VkCommandBufferBeginInfo begin_info{};
+			begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			if (vk.begin_command_buffer(batch->command_buffer, &begin_info) != VK_SUCCESS) {
+				throw std::runtime_error{"Failed to begin texture upload command buffer"};
+			}
+			batch->staging_used = 0;
+
+			// something outside the streamer grew into the budget, shed the least wanted mips.
+			uint32_t evictions{0};
+			while (!fits_budget(0) && evictions < details::texture_max_evictions_per_frame &&
+				   evict_below(std::numeric_limits<float>::max(), *batch))
+			{
+				++evictions;
+			}
+			upload_ready(*batch);
+
+			if (vk.end_command_buffer(batch->command_buffer) != VK_SUCCESS) {
+				throw std::runtime_error{"Failed to record texture upload command buffer"};
+			}
+			if (!batch->retired_images.empty() || batch->staging_used != 0 || !batch->retired_buffers.empty()) {
+				VkSubmitInfo submit_info{};
+				submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+				submit_info.commandBufferCount = 1;
+				submit_info.pCommandBuffers = &batch->command_buffer;
+				if (vk.queue_submit(engine_->device_manager()->graphics_queue(), 1, &submit_info, batch->fence) != VK_SUCCESS) {
+					throw std::runtime_error{"Failed to submit texture uploads"};
+				}
+				batch->in_flight = true;
+			}
+		}
+	}
+
+	queue_decodes();
+	++frame_;
+}
+
+void texture_manager::decode_next() {
+	decode_request request;
+	{
+		std::lock_guard<std::mutex> lock{queue_mutex_};
+		if (stopping_ || decode_queue_.empty()) {
+			--active_decoders_;
+			return;
+		}
+		request = decode_queue_.top();
+		decode_queue_.pop();
+	}
+	decoded_mip result{request.id, request.mip, request.priority, {}};
+	try {
+		PG_GODS_VIEW_PROFILE_SCOPE("decode texture mip");
+		result.texels = request.decode(request.mip);
+	} catch (...) {
+		result.texels.clear();
+	}
+	std::lock_guard<std::mutex> lock{queue_mutex_};
+	decoded_.push_back(std::move(result));
+	// the decoder slot passes straight on to the next most wanted mip.
+	engine_->job_system()->submit_background(decode_jobs_, [this]() { decode_next(); });
+}
+
+void texture_manager::create_fallback_image() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	fallback_image_ = details::create_image(
+		vk,
+		engine_->device_manager()->memory_properties(),
+		VK_FORMAT_R8G8B8A8_UNORM,
+		{1, 1},
+		1,
+		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	);
+
+	auto& batch = batches_.front();
+	VkCommandBufferBeginInfo begin_info{};
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vk.begin_command_buffer(batch.command_buffer, &begin_info);
+	details::transition_image_layout(
+		vk,
+		batch.command_buffer, fallback_image_.image,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		0, VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+	);
+	VkClearColorValue white = {{1.0f, 1.0f, 1.0f, 1.0f}};
+	VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+	vk.cmd_clear_color_image(batch.command_buffer, fallback_image_.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &white, 1, &range);
+	details::transition_image_layout(
+		vk,
+		batch.command_buffer, fallback_image_.image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+	);
+	vk.end_command_buffer(batch.command_buffer);
+
+	VkSubmitInfo submit_info{};
+	submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers = &batch.command_buffer;
+	if (vk.queue_submit(engine_->device_manager()->graphics_queue(), 1, &submit_info, batch.fence) != VK_SUCCESS) {
+		throw std::runtime_error{"Failed to submit fallback texture"};
+	}
+	batch.in_flight = true;
+}
+
+void texture_manager::retire_batches() {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto& batch : batches_) {
+		if (!batch.in_flight || vk.get_fence_status(device, batch.fence) != VK_SUCCESS) { continue; }
+		vk.reset_fences(device, 1, &batch.fence);
+		// the pool drops cached sets that point at the image.
+		for (auto image : batch.retired_images) {
+			engine_->resource_pool()->destroy(image);
+		}
+		for (auto& buffer : batch.retired_buffers) {
+			engine_->descriptor_allocator()->invalidate_buffer(buffer.buffer);
+			details::destroy_buffer(vk, buffer);
+		}
+		batch.retired_images.clear();
+		batch.retired_buffers.clear();
+		batch.in_flight = false;
+	}
+}
+
+void texture_manager::query_budget() {
+	auto device_manager = engine_->device_manager();
+	if (device_manager->extension_enabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budget{};
+		budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+		VkPhysicalDeviceMemoryProperties2 properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		properties.pNext = &budget;
+		vkGetPhysicalDeviceMemoryProperties2(device_manager->physical_device(), &properties);
+		heap_budget_ = budget.heapBudget[heap_index_];
+		heap_usage_ = budget.heapUsage[heap_index_];
+	} else {
+		const auto heap_size = device_manager->memory_properties().memoryHeaps[heap_index_].size;
+		heap_budget_ = static_cast<VkDeviceSize>(static_cast<double>(heap_size) * details::texture_fallback_heap_fraction);
+		heap_usage_ = resident_bytes_;
+	}
+	resident_bytes_at_query_ = resident_bytes_;
+}
+
+bool texture_manager::fits_budget(VkDeviceSize additional_bytes) const noexcept {
+	// the reported usage lags behind rebuilds recorded since the last query.
+	const auto projected = static_cast<double>(heap_usage_) +
+						   static_cast<double>(resident_bytes_) - static_cast<double>(resident_bytes_at_query_) +
+						   static_cast<double>(additional_bytes);
+	return projected <= static_cast<double>(heap_budget_) * budget_fraction_;
+}
+
+float texture_manager::effective_priority(const texture_entry& texture) const noexcept {
+	return texture.requested_frame == frame_ ? texture.priority : 0.0f;
+}
+
+bool texture_manager::evict_below(float priority, upload_batch& batch) {
+	texture_entry* victim{nullptr};
+	float lowest{priority};
+	for (auto& texture : textures_) {
+		if (!texture.image || texture.resident_mip + 1 >= texture.desc.mip_levels ||
+			texture.rebuilt_frame == frame_)
+		{
+			continue;
+		}
+		// mips finer than anything currently wanted go first.
+		const float score = texture.resident_mip < texture.wanted_mip ? -1.0f : effective_priority(texture);
+		if (score < lowest) {
+			lowest = score;
+			victim = &texture;
+		}
+	}
+	if (victim == nullptr) { return false; }
+	rebuild_texture(*victim, victim->resident_mip + 1, batch, VK_NULL_HANDLE, 0);
+	++evicted_mips_;
+	return true;
+}
+
+void texture_manager::upload_ready(upload_batch& batch) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	std::sort(ready_.begin(), ready_.end(), [](const decoded_mip& a, const decoded_mip& b) { return a.priority > b.priority; });
+
+	std::vector<decoded_mip> deferred;
+	for (auto& mip : ready_) {
+		auto& texture = textures_[mip.id];
+		texture.pending_mip = texture.desc.mip_levels;
+		// stale when the texture was evicted meanwhile or is no longer wanted this fine.
+		if (mip.mip + 1 != texture.resident_mip || mip.mip < texture.wanted_mip) { continue; }
+		if (mip.texels.empty()) {
+			texture.blocked_until_frame = frame_ + details::texture_blocked_frames;
+			continue;
+		}
+		if (texture.rebuilt_frame == frame_ && texture.image) {
+			texture.pending_mip = mip.mip;
+			deferred.push_back(std::move(mip));
+			continue;
+		}
+
+		const auto size = static_cast<VkDeviceSize>(mip.texels.size());
+		const VkDeviceSize offset = (batch.staging_used + details::texture_staging_alignment - 1) & ~(details::texture_staging_alignment - 1);
+		const bool dedicated = size > batch.staging.size;
+		if (!dedicated && offset + size > batch.staging.size) {
+			texture.pending_mip = mip.mip;
+			deferred.push_back(std::move(mip));
+			continue;
+		}
+
+		const float priority = mip.mip + 1 == texture.desc.mip_levels ? std::numeric_limits<float>::max() : effective_priority(texture);
+		bool fits = fits_budget(size);
+		while (!fits && evict_below(priority, batch)) {
+			fits = fits_budget(size);
+		}
+		if (!fits) {
+			texture.blocked_until_frame = frame_ + details::texture_blocked_frames;
+			continue;
+		}
+
+		VkBuffer staging_buffer = batch.staging.buffer;
+		VkDeviceSize staging_offset = offset;
+		if (dedicated) {
+			auto buffer = details::create_buffer(
+				vk,
+				engine_->device_manager()->memory_properties(),
+				size,
+				VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			);
+			std::memcpy(buffer.mapped, mip.texels.data(), mip.texels.size());
+			staging_buffer = buffer.buffer;
+			staging_offset = 0;
+			batch.retired_buffers.push_back(buffer);
+		} else {
+			std::memcpy(static_cast<std::byte*>(batch.staging.mapped) + offset, mip.texels.data(), mip.texels.size());
+			batch.staging_used = offset + size;
+		}
+		rebuild_texture(texture, mip.mip, batch, staging_buffer, staging_offset);
+	}
+	ready_ = std::move(deferred);
+}
+
+void texture_manager::queue_decodes() {
+	std::lock_guard<std::mutex> lock{queue_mutex_};
+	for (texture_id id = 0; id < static_cast<texture_id>(textures_.size()); ++id) {
+		auto& texture = textures_[id];
+		if (texture.pending_mip != texture.desc.mip_levels || frame_ < texture.blocked_until_frame) { continue; }
+		const bool first = texture.resident_mip == texture.desc.mip_levels;
+		if (!first && (texture.requested_frame != frame_ || texture.wanted_mip >= texture.resident_mip)) { continue; }
+		texture.pending_mip = texture.resident_mip - 1;
+		decode_queue_.push({
+			id,
+			texture.pending_mip,
+			first ? std::numeric_limits<float>::max() : texture.priority,
+			texture.desc.decode
+		});
+	}
+	while (active_decoders_ < max_decoders_ && active_decoders_ < decode_queue_.size()) {
+		++active_decoders_;
+		engine_->job_system()->submit_background(decode_jobs_, [this]() { decode_next(); });
+	}
+}
+
+void texture_manager::rebuild_texture(
+	texture_entry& texture,
+	uint32_t new_base_mip,
+	upload_batch& batch,
+	VkBuffer staging,
+	VkDeviceSize staging_offset
+)
+{
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto command_buffer = batch.command_buffer;
+	const auto& desc = texture.desc;
+	const auto base_extent = details::mip_extent(desc, new_base_mip);
+
+	auto resources = engine_->resource_pool();
+	const auto image = resources->create_image(
+		desc.format,
+		{base_extent.width, base_extent.height},
+		desc.mip_levels - new_base_mip,
+		VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT
+	);
+	details::transition_image_layout(
+		vk,
+		command_buffer, resources->image(image),
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		0, VK_ACCESS_TRANSFER_WRITE_BIT,
+		VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+	);
+
+	if (texture.image) {
+		details::transition_image_layout(
+			vk,
+			command_buffer, resources->image(texture.image),
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			0, VK_ACCESS_TRANSFER_READ_BIT,
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+		);
+		std::vector<VkImageCopy> regions;
+		for (uint32_t level = std::max(new_base_mip, texture.resident_mip); level < desc.mip_levels; ++level) {
+			VkImageCopy region{};
+			region.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - texture.resident_mip, 0, 1};
+			region.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - new_base_mip, 0, 1};
+			region.extent = details::mip_extent(desc, level);
+			regions.push_back(region);
+		}
+		vk.cmd_copy_image(
+			command_buffer,
+			resources->image(texture.image), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			resources->image(image), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(regions.size()), regions.data()
+		);
+		resident_bytes_ -= resources->size(texture.image);
+		batch.retired_images.push_back(texture.image);
+	}
+
+	if (staging != VK_NULL_HANDLE) {
+		VkBufferImageCopy region{};
+		region.bufferOffset = staging_offset;
+		region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		region.imageExtent = base_extent;
+		vk.cmd_copy_buffer_to_image(command_buffer, staging, resources->image(image), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+	}
+
+	details::transition_image_layout(
+		vk,
+		command_buffer, resources->image(image),
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+		VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+	);
+
+	resident_bytes_ += resources->size(image);
+	texture.image = image;
+	texture.resident_mip = new_base_mip;
+	texture.rebuilt_frame = frame_;
+}
+
+void texture_manager::destroy_batch(upload_batch& batch) {
+	const auto& vk = engine_->device_manager()->dispatch();
+	auto device = engine_->device_manager()->logical_device();
+	for (auto image : batch.retired_images) {
+		engine_->resource_pool()->destroy(image);
+	}
+	for (auto& buffer : batch.retired_buffers) {
+		details::destroy_buffer(vk, buffer);
+	}
+	details::destroy_buffer(vk, batch.staging);
+	vk.destroy_fence(device, batch.fence, nullptr);
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,202 @@
+#if !defined PG_GODS_VIEW_TEXTURE_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_TEXTURE_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/handle_pool.h"
+#include "gods_view/job_system.h"
+#include "gods_view/memory.h"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace pg::gods_view {
+
+using texture_id = uint32_t;
+
+// decodes a single mip level into tightly packed texel data. runs on a background worker,
+// never on a thread waiting for frame jobs.
+using texture_decoder = std::function<std::vector<std::byte>(uint32_t mip_level)>;
+
+struct texture_desc {
+	uint32_t width;
+	uint32_t height;
+	uint32_t mip_levels;
+	VkFormat format;
+	texture_decoder decode;
+};
+
+// on disk layout read by `load_texture_file`, a header followed by one
+// `texture_file_mip` per level, finest level first.
+struct texture_file_header {
+	char magic[4];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t mip_levels;
+	uint32_t format;
+};
+
+struct texture_file_mip {
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct texture_stream_stats {
+	VkDeviceSize resident_bytes;
+	VkDeviceSize heap_budget;
+	VkDeviceSize heap_usage;
+	uint32_t pending_decodes;
+	uint32_t uploads_in_flight;
+	uint64_t evicted_mips;
+};
+
+namespace details {
+
+constexpr uint32_t texture_file_version = 1;
+constexpr VkDeviceSize texture_staging_size = 16ull * 1024ull * 1024ull;
+constexpr uint32_t texture_upload_batches = 3;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// streams texture mips in coarse to fine order on the engine's job system. each texture owns one
+// image holding its resident mip tail, growing or shrinking it is a gpu side copy into a
+// new image. residency follows the on screen demand reported through `request` and is
+// kept under the device local heap budget by evicting the least wanted fine mips.
+class texture_manager {
+private:
+	struct texture_entry {
+		texture_desc desc;
+		// owned by the engine's resource pool, empty until the first mip lands.
+		image_handle image;
+		uint32_t resident_mip;
+		uint32_t wanted_mip;
+		uint32_t pending_mip;
+		float priority;
+		uint64_t requested_frame;
+		uint64_t rebuilt_frame;
+		uint64_t blocked_until_frame;
+	};
+
+	struct decode_request {
+		texture_id id;
+		uint32_t mip;
+		float priority;
+		texture_decoder decode;
+
+		bool operator<(const decode_request& other) const noexcept { return priority < other.priority; }
+	};
+
+	struct decoded_mip {
+		texture_id id;
+		uint32_t mip;
+		float priority;
+		std::vector<std::byte> texels;
+	};
+
+	struct upload_batch {
+		VkCommandBuffer command_buffer;
+		VkFence fence;
+		gpu_buffer staging;
+		VkDeviceSize staging_used;
+		std::vector<image_handle> retired_images;
+		std::vector<gpu_buffer> retired_buffers;
+		bool in_flight;
+	};
+
+	gods_view::vulkan_engine* engine_;
+	std::vector<texture_entry> textures_;
+	VkCommandPool command_pool_;
+	VkSampler sampler_;
+	gpu_image fallback_image_;
+	std::vector<upload_batch> batches_;
+	std::vector<decoded_mip> ready_;
+	uint32_t heap_index_;
+	VkDeviceSize resident_bytes_;
+	VkDeviceSize heap_budget_;
+	VkDeviceSize heap_usage_;
+	VkDeviceSize resident_bytes_at_query_;
+	float budget_fraction_;
+	uint64_t frame_;
+	uint64_t evicted_mips_;
+	bool initialized_;
+
+	mutable std::mutex queue_mutex_;
+	std::priority_queue<decode_request> decode_queue_;
+	std::vector<decoded_mip> decoded_;
+	uint32_t max_decoders_;
+	uint32_t active_decoders_;
+	bool stopping_;
+	job_counter decode_jobs_;
+
+public:
+	texture_manager(gods_view::vulkan_engine* init_engine);
+
+	~texture_manager();
+
+	[[nodiscard]] VkSampler sampler() const noexcept { return sampler_; }
+
+	[[nodiscard]] float budget_fraction() const noexcept { return budget_fraction_; }
+
+	// share of the device local heap budget textures may grow into before evicting.
+	void budget_fraction(float fraction) noexcept { budget_fraction_ = fraction; }
+
+	[[nodiscard]] texture_stream_stats stats() const;
+
+	// decodes run as background jobs, at most `max_decoders` of them at once.
+	void initialize(uint32_t max_decoders);
+
+	texture_id create_texture(texture_desc desc);
+
+	texture_id load_texture_file(const std::string& filename);
+
+	// reports that `id` covers roughly `screen_extent` pixels along its longest edge this frame.
+	void request(texture_id id, float screen_extent);
+
+	// view of the resident mips, or a 1x1 white image until the first mip lands.
+	[[nodiscard]] VkImageView image_view(texture_id id) const noexcept;
+
+	[[nodiscard]] uint32_t resident_mip(texture_id id) const noexcept { return textures_[id].resident_mip; }
+
+	// true while decodes or uploads are outstanding and `update` still has work to pick up.
+	[[nodiscard]] bool busy() const;
+
+	// called once per frame from the render thread; never waits on the gpu.
+	void update();
+
+private:
+	void decode_next();
+
+	void create_fallback_image();
+
+	void retire_batches();
+
+	void query_budget();
+
+	[[nodiscard]] bool fits_budget(VkDeviceSize additional_bytes) const noexcept;
+
+	[[nodiscard]] float effective_priority(const texture_entry& texture) const noexcept;
+
+	bool evict_below(float priority, upload_batch& batch);
+
+	void upload_ready(upload_batch& batch);
+
+	void queue_decodes();
+
+	void rebuild_texture(texture_entry& texture, uint32_t new_base_mip, upload_batch& batch, VkBuffer staging, VkDeviceSize staging_offset);
+
+	void destroy_batch(upload_batch& batch);
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,288 @@
+#include "gods_view/trace_player.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace pg::gods_view {
+
+namespace details {
+
+// reads the record header at `position`, false at the end of the trace.
+static bool next_trace_record(const mapped_file& file, size_t& position, trace_record_header& header) {
+	if (position == file.size()) { return false; }
+	if (file.size() - position < sizeof(header)) {
+		throw std::runtime_error{"Truncated trace record"};
+	}
+	std::memcpy(&header, file.data() + position, sizeof(header));
+	position += sizeof(header);
+	if (file.size() - position < header.size) {
+		throw std::runtime_error{"Truncated trace record"};
+	}
+	return true;
+}
+
+static uint64_t trace_mip_key(uint32_t texture, uint32_t mip_level) noexcept {
+	return (static_cast<uint64_t>(texture) << 32) | mip_level;
+}
+
+} // end namespace pg::gods_view::details
+
+trace_player::trace_player(gods_view::vulkan_engine* init_engine, const std::string& filename) :
+	engine_{init_engine},
+	file_{std::make_shared<mapped_file>(filename)},
+	position_{0},
+	records_begin_{sizeof(trace_file_header)},
+	frame_count_{0}
+{
+	trace_file_header header{};
+	if (file_->size() < sizeof(header)) {
+		throw std::runtime_error{"Invalid trace file"};
+	}
+	std::memcpy(&header, file_->data(), sizeof(header));
+	if (std::memcmp(header.magic, "GVTR", 4) != 0 || header.version != details::trace_file_version) {
+		throw std::runtime_error{"Invalid trace file"};
+	}
+
+	// the surfaces, frame count and where every texture mip's texels live.
+	size_t position = records_begin_;
+	trace_record_header record{};
+	while (details::next_trace_record(*file_, position, record)) {
+		details::trace_reader reader{file_->data() + position, record.size};
+		if (record.op == trace_op::frame) {
+			++frame_count_;
+		} else if (record.op == trace_op::surface) {
+			const auto index = reader.get<uint32_t>();
+			const auto width = reader.get<uint32_t>();
+			const auto height = reader.get<uint32_t>();
+			if (surfaces_.size() <= index) {
+				surfaces_.resize(index + 1);
+			}
+			surfaces_[index] = {width, height};
+		} else if (record.op == trace_op::texture_mip) {
+			const auto texture = reader.get<uint32_t>();
+			const auto mip_level = reader.get<uint32_t>();
+			const auto texels = reader.blob();
+			const auto offset = static_cast<size_t>(static_cast<const std::byte*>(texels.data) - file_->data());
+			mips_.emplace(details::trace_mip_key(texture, mip_level), std::make_pair(offset, texels.size));
+		}
+		position += record.size;
+	}
+	position_ = records_begin_;
+}
+
+bool trace_player::next_frame(double* delta) {
+	trace_record_header record{};
+	while (details::next_trace_record(*file_, position_, record)) {
+		details::trace_reader reader{file_->data() + position_, record.size};
+		position_ += record.size;
+		if (record.op == trace_op::frame) {
+			const auto duration = reader.get<double>();
+			if (delta != nullptr) { *delta = duration; }
+			return true;
+		}
+		apply(record.op, reader);
+	}
+	// records after the last frame marker still get applied, they just aren't drawn.
+	return false;
+}
+
+void trace_player::rewind() noexcept {
+	position_ = records_begin_;
+}
+
+void trace_player::apply(trace_op op, details::trace_reader& reader) {
+	switch (op) {
+	case trace_op::surface:
+	case trace_op::texture_mip:
+		// consumed while indexing.
+		break;
+	case trace_op::mesh_load: {
+		const auto id = reader.get<uint32_t>();
+		const auto filename = reader.text();
+		if (meshes_.count(id) == 0) {
+			meshes_.emplace(id, engine_->mesh_manager()->load_mesh(std::string{filename}));
+		}
+		break;
+	}
+	case trace_op::texture_create:
+		create_texture(reader);
+		break;
+	case trace_op::texture_request: {
+		const auto id = lookup(textures_, reader.get<uint32_t>(), "Trace requests an unknown texture");
+		engine_->texture_manager()->request(id, reader.get<float>());
+		break;
+	}
+	case trace_op::transform_create: {
+		const auto id = reader.get<uint32_t>();
+		const auto parent = reader.get<uint32_t>();
+		if (transforms_.count(id) != 0) { break; }
+		const auto replay_parent = parent == invalid_transform ? invalid_transform : lookup(transforms_, parent, "Trace parents a transform to an unknown one");
+		transforms_.emplace(id, engine_->transform_manager()->create(replay_parent));
+		break;
+	}
+	case trace_op::transform_destroy: {
+		auto transforms = engine_->transform_manager();
+		const auto destroyed = lookup(transforms_, reader.get<uint32_t>(), "Trace destroys an unknown transform");
+		transforms->destroy(destroyed);
+		// its descendants go with it, and the recording may hand their ids out again.
+		for (auto it = transforms_.begin(); it != transforms_.end();) {
+			auto ancestor = it->second;
+			while (ancestor != invalid_transform && ancestor != destroyed) {
+				ancestor = transforms->parent(ancestor);
+			}
+			it = ancestor == destroyed ? transforms_.erase(it) : std::next(it);
+		}
+		break;
+	}
+	case trace_op::transform_parent: {
+		const auto id = lookup(transforms_, reader.get<uint32_t>(), "Trace reparents an unknown transform");
+		const auto parent = reader.get<uint32_t>();
+		engine_->transform_manager()->set_parent(id, parent == invalid_transform ? invalid_transform : lookup(transforms_, parent, "Trace parents a transform to an unknown one"));
+		break;
+	}
+	case trace_op::transform_translation: {
+		const auto id = lookup(transforms_, reader.get<uint32_t>(), "Trace moves an unknown transform");
+		const auto x = reader.get<float>();
+		const auto y = reader.get<float>();
+		const auto z = reader.get<float>();
+		engine_->transform_manager()->set_translation(id, x, y, z);
+		break;
+	}
+	case trace_op::transform_rotation: {
+		const auto id = lookup(transforms_, reader.get<uint32_t>(), "Trace rotates an unknown transform");
+		const auto x = reader.get<float>();
+		const auto y = reader.get<float>();
+		const auto z = reader.get<float>();
+		const auto w = reader.get<float>();
+		engine_->transform_manager()->set_rotation(id, x, y, z, w);
+		break;
+	}
+	case trace_op::transform_scale: {
+		const auto id = lookup(transforms_, reader.get<uint32_t>(), "Trace scales an unknown transform");
+		const auto x = reader.get<float>();
+		const auto y = reader.get<float>();
+		const auto z = reader.get<float>();
+		engine_->transform_manager()->set_scale(id, x, y, z);
+		break;
+	}
+	case trace_op::pipeline: {
+		const auto state = reader.get<pipeline_state>();
+		specialization_info variant{};
+		variant.key = reader.get<uint64_t>();
+		const auto entries = reader.blob();
+		const auto data = reader.blob();
+		// the mapping gives no alignment guarantee, the entries are copied out first.
+		std::vector<VkSpecializationMapEntry> map_entries(entries.size / sizeof(VkSpecializationMapEntry));
+		if (!map_entries.empty()) {
+			std::memcpy(map_entries.data(), entries.data, map_entries.size() * sizeof(VkSpecializationMapEntry));
+		}
+		variant.info.mapEntryCount = static_cast<uint32_t>(map_entries.size());
+		variant.info.pMapEntries = map_entries.data();
+		variant.info.dataSize = data.size;
+		variant.info.pData = data.data;
+		engine_->graphics_pipeline_manager()->pipeline(state, variant);
+		break;
+	}
+	case trace_op::overlay_font:
+		create_font(reader);
+		break;
+	case trace_op::overlay_sprite_atlas: {
+		const auto id = reader.get<uint32_t>();
+		const auto texture = lookup(textures_, reader.get<uint32_t>(), "Trace builds a sprite atlas from an unknown texture");
+		const auto width = reader.get<uint32_t>();
+		const auto height = reader.get<uint32_t>();
+		VkOffset2D white{};
+		white.x = reader.get<int32_t>();
+		white.y = reader.get<int32_t>();
+		if (atlases_.count(id) == 0) {
+			atlases_.emplace(id, engine_->overlay_renderer()->add_sprite_atlas(texture, width, height, white));
+		}
+		break;
+	}
+	case trace_op::overlay_quad: {
+		const auto surface_index = static_cast<size_t>(reader.get<uint64_t>());
+		const auto atlas = lookup(atlases_, reader.get<uint32_t>(), "Trace draws from an unknown overlay atlas");
+		const auto rect = reader.get<overlay_rect>();
+		const auto texels = reader.get<overlay_rect>();
+		engine_->overlay_renderer()->quad(surface_index, atlas, rect, texels, reader.get<uint32_t>());
+		break;
+	}
+	case trace_op::overlay_rect: {
+		const auto surface_index = static_cast<size_t>(reader.get<uint64_t>());
+		const auto atlas = lookup(atlases_, reader.get<uint32_t>(), "Trace draws from an unknown overlay atlas");
+		const auto rect = reader.get<overlay_rect>();
+		engine_->overlay_renderer()->rect(surface_index, atlas, rect, reader.get<uint32_t>());
+		break;
+	}
+	case trace_op::overlay_text: {
+		const auto surface_index = static_cast<size_t>(reader.get<uint64_t>());
+		const auto font = lookup(atlases_, reader.get<uint32_t>(), "Trace draws text in an unknown font");
+		const auto x = reader.get<float>();
+		const auto y = reader.get<float>();
+		const auto text = reader.text();
+		const auto color = reader.get<uint32_t>();
+		engine_->overlay_renderer()->text(surface_index, font, x, y, text, color, reader.get<float>());
+		break;
+	}
+	default:
+		throw std::runtime_error{"Unknown trace record"};
+	}
+}
+
+void trace_player::create_texture(details::trace_reader& reader) {
+	const auto id = reader.get<uint32_t>();
+	texture_desc desc{};
+	desc.width = reader.get<uint32_t>();
+	desc.height = reader.get<uint32_t>();
+	desc.mip_levels = reader.get<uint32_t>();
+	desc.format = static_cast<VkFormat>(reader.get<uint32_t>());
+	if (textures_.count(id) != 0) { return; }
+
+	// mips the recording never decoded come back empty, the texture manager then gives up on them.
+	std::vector<std::pair<size_t, size_t>> mips(desc.mip_levels, {0, 0});
+	for (uint32_t mip = 0; mip < desc.mip_levels; ++mip) {
+		if (auto it = mips_.find(details::trace_mip_key(id, mip)); it != mips_.end()) {
+			mips[mip] = it->second;
+		}
+	}
+	desc.decode = [file = file_, mips = std::move(mips)](uint32_t mip_level) {
+		const auto [offset, size] = mips[mip_level];
+		const auto* texels = file->data() + offset;
+		return std::vector<std::byte>(texels, texels + size);
+	};
+	textures_.emplace(id, engine_->texture_manager()->create_texture(std::move(desc)));
+}
+
+void trace_player::create_font(details::trace_reader& reader) {
+	const auto id = reader.get<uint32_t>();
+	overlay_font_desc font{};
+	font.line_height = reader.get<float>();
+	font.ascent = reader.get<float>();
+	font.atlas_size = reader.get<uint32_t>();
+	font.glyphs.resize(reader.get<uint32_t>());
+	for (auto& glyph : font.glyphs) {
+		glyph.codepoint = reader.get<uint32_t>();
+		glyph.width = reader.get<uint32_t>();
+		glyph.height = reader.get<uint32_t>();
+		glyph.bearing_x = reader.get<int32_t>();
+		glyph.bearing_y = reader.get<int32_t>();
+		glyph.advance = reader.get<float>();
+		const auto coverage = reader.blob();
+		const auto* bytes = static_cast<const uint8_t*>(coverage.data);
+		glyph.coverage.assign(bytes, bytes + coverage.size);
+	}
+	if (atlases_.count(id) == 0) {
+		atlases_.emplace(id, engine_->overlay_renderer()->add_font(font));
+	}
+}
+
+uint32_t trace_player::lookup(const std::unordered_map<uint32_t, uint32_t>& ids, uint32_t id, const char* error) {
+	auto it = ids.find(id);
+	if (it == ids.end()) {
+		throw std::runtime_error{error};
+	}
+	return it->second;
+}
+
+} // end namespace pg::gods_view
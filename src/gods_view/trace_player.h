@@ -0,0 +1,71 @@
+#if !defined PG_GODS_VIEW_TRACE_PLAYER_HEADER_INCLUDED
+#define PG_GODS_VIEW_TRACE_PLAYER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/mapped_file.h"
+#include "gods_view/trace_recorder.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pg::gods_view {
+
+class vulkan_engine;
+
+// drives an engine from a trace written by `trace_recorder`. the trace is mapped once and
+// indexed up front, texture decoders hand out the recorded texels straight from the
+// mapping. ids are remapped, so the engine may already hold resources of its own.
+class trace_player {
+private:
+	gods_view::vulkan_engine* engine_;
+	std::shared_ptr<mapped_file> file_;
+	size_t position_;
+	size_t records_begin_;
+	uint64_t frame_count_;
+	std::vector<VkExtent2D> surfaces_;
+	// (trace texture, mip level) to the texels' offset and size in the mapping.
+	std::unordered_map<uint64_t, std::pair<size_t, size_t>> mips_;
+	std::unordered_map<uint32_t, mesh_id> meshes_;
+	std::unordered_map<uint32_t, uint32_t> textures_;
+	std::unordered_map<uint32_t, uint32_t> transforms_;
+	std::unordered_map<uint32_t, uint32_t> atlases_;
+
+public:
+	trace_player(gods_view::vulkan_engine* init_engine, const std::string& filename);
+
+	trace_player(const trace_player&) = delete;
+
+	trace_player& operator=(const trace_player&) = delete;
+
+	// extents of the windows the trace was recorded with, create as many before playing.
+	[[nodiscard]] const std::vector<VkExtent2D>& surfaces() const noexcept { return surfaces_; }
+
+	[[nodiscard]] uint64_t frame_count() const noexcept { return frame_count_; }
+
+	// applies the records of the next frame, the caller draws it afterwards. `delta` gets
+	// the frame's recorded duration. false once the trace is exhausted.
+	bool next_frame(double* delta = nullptr);
+
+	// plays from the first record again; resources created by the earlier pass are reused.
+	void rewind() noexcept;
+
+private:
+	void apply(trace_op op, details::trace_reader& reader);
+
+	void create_texture(details::trace_reader& reader);
+
+	void create_font(details::trace_reader& reader);
+
+	[[nodiscard]] static uint32_t lookup(const std::unordered_map<uint32_t, uint32_t>& ids, uint32_t id, const char* error);
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,179 @@
+#include "gods_view/trace_recorder.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <memory>
+#include <utility>
+
+namespace pg::gods_view {
+
+trace_recorder::trace_recorder(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	recording_{false},
+	suppressed_{0},
+	stats_{}
+{ }
+
+trace_recorder::~trace_recorder() {
+	stop();
+}
+
+trace_stats trace_recorder::stats() {
+	std::lock_guard lock{mutex_};
+	return stats_;
+}
+
+void trace_recorder::start(const std::string& filename) {
+	stop();
+	{
+		std::lock_guard lock{mutex_};
+		file_.open(filename, std::ios::binary | std::ios::trunc);
+		if (!file_.is_open()) {
+			throw std::runtime_error{"Failed to open trace file"};
+		}
+		trace_file_header header{{'G', 'V', 'T', 'R'}, details::trace_file_version};
+		file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stats_ = {};
+		stats_.bytes = sizeof(header);
+		last_frame_ = std::chrono::steady_clock::now();
+	}
+	auto surface_manager = engine_->surface_manager();
+	for (size_t surface = 0; surface < surface_manager->surface_count(); ++surface) {
+		const auto extent = surface_manager->swap_chain_extent(surface);
+		write(trace_op::surface, static_cast<uint32_t>(surface), extent.width, extent.height);
+	}
+	recording_.store(true, std::memory_order_relaxed);
+}
+
+void trace_recorder::stop() {
+	recording_.store(false, std::memory_order_relaxed);
+	std::lock_guard lock{mutex_};
+	if (file_.is_open()) {
+		file_.close();
+	}
+}
+
+void trace_recorder::frame() {
+	if (!recording()) { return; }
+	const auto now = std::chrono::steady_clock::now();
+	const double delta = std::chrono::duration<double>(now - last_frame_).count();
+	last_frame_ = now;
+	write(trace_op::frame, delta);
+	std::lock_guard lock{mutex_};
+	++stats_.frames;
+}
+
+void trace_recorder::mesh_load(mesh_id id, const std::string& filename) {
+	if (!recording()) { return; }
+	write(trace_op::mesh_load, id.value, std::string_view{filename});
+}
+
+void trace_recorder::texture_create(texture_id id, texture_desc& desc) {
+	if (!recording()) { return; }
+	write(trace_op::texture_create, id, desc.width, desc.height, desc.mip_levels, static_cast<uint32_t>(desc.format));
+	// decodes run on workers, possibly after the trace was stopped; `write` drops those.
+	desc.decode = [this, id, decode = std::move(desc.decode)](uint32_t mip_level) {
+		auto texels = decode(mip_level);
+		if (recording_.load(std::memory_order_relaxed)) {
+			write(trace_op::texture_mip, id, mip_level, details::trace_blob{texels.data(), texels.size()});
+		}
+		return texels;
+	};
+}
+
+void trace_recorder::texture_request(texture_id id, float screen_extent) {
+	if (!recording()) { return; }
+	write(trace_op::texture_request, id, screen_extent);
+}
+
+void trace_recorder::transform_create(transform_id id, transform_id parent) {
+	if (!recording()) { return; }
+	write(trace_op::transform_create, id, parent);
+}
+
+void trace_recorder::transform_destroy(transform_id id) {
+	if (!recording()) { return; }
+	write(trace_op::transform_destroy, id);
+}
+
+void trace_recorder::transform_parent(transform_id id, transform_id parent) {
+	if (!recording()) { return; }
+	write(trace_op::transform_parent, id, parent);
+}
+
+void trace_recorder::transform_translation(transform_id id, float x, float y, float z) {
+	if (!recording()) { return; }
+	write(trace_op::transform_translation, id, x, y, z);
+}
+
+void trace_recorder::transform_rotation(transform_id id, float x, float y, float z, float w) {
+	if (!recording()) { return; }
+	write(trace_op::transform_rotation, id, x, y, z, w);
+}
+
+void trace_recorder::transform_scale(transform_id id, float x, float y, float z) {
+	if (!recording()) { return; }
+	write(trace_op::transform_scale, id, x, y, z);
+}
+
+void trace_recorder::pipeline(const pipeline_state& state, const specialization_info& variant) {
+	if (!recording()) { return; }
+	write(
+		trace_op::pipeline,
+		state,
+		variant.key,
+		details::trace_blob{variant.info.pMapEntries, variant.info.mapEntryCount * sizeof(VkSpecializationMapEntry)},
+		details::trace_blob{variant.info.pData, variant.info.dataSize}
+	);
+}
+
+void trace_recorder::overlay_font(overlay_atlas_id id, const overlay_font_desc& font) {
+	if (!recording()) { return; }
+	std::lock_guard lock{mutex_};
+	if (!file_.is_open()) { return; }
+	record_.clear();
+	details::append_trace_field(record_, id);
+	details::append_trace_field(record_, font.line_height);
+	details::append_trace_field(record_, font.ascent);
+	details::append_trace_field(record_, font.atlas_size);
+	details::append_trace_field(record_, static_cast<uint32_t>(font.glyphs.size()));
+	for (const auto& glyph : font.glyphs) {
+		details::append_trace_field(record_, glyph.codepoint);
+		details::append_trace_field(record_, glyph.width);
+		details::append_trace_field(record_, glyph.height);
+		details::append_trace_field(record_, glyph.bearing_x);
+		details::append_trace_field(record_, glyph.bearing_y);
+		details::append_trace_field(record_, glyph.advance);
+		details::append_trace_field(record_, details::trace_blob{glyph.coverage.data(), glyph.coverage.size()});
+	}
+	write_record(trace_op::overlay_font);
+}
+
+void trace_recorder::overlay_sprite_atlas(overlay_atlas_id id, texture_id texture, uint32_t width, uint32_t height, VkOffset2D white) {
+	if (!recording()) { return; }
+	write(trace_op::overlay_sprite_atlas, id, texture, width, height, white.x, white.y);
+}
+
+void trace_recorder::overlay_quad(size_t surface_index, overlay_atlas_id atlas, const gods_view::overlay_rect& rect, const gods_view::overlay_rect& texels, uint32_t color) {
+	if (!recording()) { return; }
+	write(trace_op::overlay_quad, static_cast<uint64_t>(surface_index), atlas, rect, texels, color);
+}
+
+void trace_recorder::overlay_rect(size_t surface_index, overlay_atlas_id atlas, const gods_view::overlay_rect& rect, uint32_t color) {
+	if (!recording()) { return; }
+	write(trace_op::overlay_rect, static_cast<uint64_t>(surface_index), atlas, rect, color);
+}
+
+void trace_recorder::overlay_text(size_t surface_index, overlay_atlas_id font, float x, float y, std::string_view utf8, uint32_t color, float scale) {
+	if (!recording()) { return; }
+	write(trace_op::overlay_text, static_cast<uint64_t>(surface_index), font, x, y, utf8, color, scale);
+}
+
+void trace_recorder::write_record(trace_op op) {
+	trace_record_header header{op, 0, static_cast<uint32_t>(record_.size())};
+	file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file_.write(reinterpret_cast<const char*>(record_.data()), static_cast<std::streamsize>(record_.size()));
+	++stats_.records;
+	stats_.bytes += sizeof(header) + record_.size();
+}
+
+} // end namespace pg::gods_view
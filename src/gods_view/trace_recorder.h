@@ -0,0 +1,270 @@
+#if !defined PG_GODS_VIEW_TRACE_RECORDER_HEADER_INCLUDED
+#define PG_GODS_VIEW_TRACE_RECORDER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/mesh_manager.h"
+#include "gods_view/overlay_renderer.h"
+#include "gods_view/pipeline_state.h"
+#include "gods_view/shader_variant.h"
+#include "gods_view/texture_manager.h"
+#include "gods_view/transform_manager.h"
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace pg::gods_view {
+
+// a trace is a `trace_file_header` followed by records, each a `trace_record_header` and
+// `size` bytes of payload. payload fields are packed without padding in the order the
+// recorder writes them; strings and blobs are a uint32 byte count followed by the bytes.
+struct trace_file_header {
+	char magic[4];
+	uint32_t version;
+};
+
+enum class trace_op : uint16_t {
+	// ends a frame's records. f64 seconds since the previous frame.
+	frame = 1,
+	// u32 surface index, u32 width, u32 height.
+	surface,
+	// u32 mesh, string filename.
+	mesh_load,
+	// u32 texture, u32 width, u32 height, u32 mip levels, u32 format.
+	texture_create,
+	// u32 texture, u32 mip level, blob texels.
+	texture_mip,
+	// u32 texture, f32 screen extent.
+	texture_request,
+	// u32 transform, u32 parent.
+	transform_create,
+	// u32 transform.
+	transform_destroy,
+	// u32 transform, u32 parent.
+	transform_parent,
+	// u32 transform, f32 x, y, z.
+	transform_translation,
+	// u32 transform, f32 x, y, z, w.
+	transform_rotation,
+	// u32 transform, f32 x, y, z.
+	transform_scale,
+	// pipeline_state, u64 variant key, blob map entries, blob constant data.
+	pipeline,
+	// u32 atlas, f32 line height, f32 ascent, u32 atlas size, u32 glyph count, then per glyph
+	// u32 codepoint, u32 width, u32 height, i32 bearing x, i32 bearing y, f32 advance, blob coverage.
+	overlay_font,
+	// u32 atlas, u32 texture, u32 width, u32 height, i32 white x, i32 white y.
+	overlay_sprite_atlas,
+	// u64 surface index, u32 atlas, overlay_rect rect, overlay_rect texels, u32 color.
+	overlay_quad,
+	// u64 surface index, u32 atlas, overlay_rect rect, u32 color.
+	overlay_rect,
+	// u64 surface index, u32 font, f32 x, f32 y, string text, u32 color, f32 scale.
+	overlay_text
+};
+
+struct trace_record_header {
+	trace_op op;
+	uint16_t reserved;
+	uint32_t size;
+};
+
+struct trace_stats {
+	uint64_t frames;
+	uint64_t records;
+	uint64_t bytes;
+};
+
+namespace details {
+
+constexpr uint32_t trace_file_version = 1;
+
+// a length prefixed run of bytes in a record.
+struct trace_blob {
+	const void* data;
+	size_t size;
+};
+
+template <typename T>
+static void append_trace_field(std::vector<std::byte>& record, const T& value) {
+	static_assert(std::is_trivially_copyable_v<T>, "trace fields are copied bytewise");
+	const auto offset = record.size();
+	record.resize(offset + sizeof(T));
+	std::memcpy(record.data() + offset, &value, sizeof(T));
+}
+
+static void append_trace_field(std::vector<std::byte>& record, const trace_blob& blob) {
+	append_trace_field(record, static_cast<uint32_t>(blob.size));
+	const auto offset = record.size();
+	record.resize(offset + blob.size);
+	if (blob.size != 0) {
+		std::memcpy(record.data() + offset, blob.data, blob.size);
+	}
+}
+
+static void append_trace_field(std::vector<std::byte>& record, std::string_view text) {
+	append_trace_field(record, trace_blob{text.data(), text.size()});
+}
+
+// reads the fields of one record back in the order they were appended.
+class trace_reader {
+private:
+	const std::byte* data_;
+	size_t size_;
+	size_t position_;
+
+public:
+	trace_reader(const std::byte* init_data, size_t init_size) :
+		data_{init_data},
+		size_{init_size},
+		position_{0}
+	{ }
+
+	template <typename T>
+	T get() {
+		static_assert(std::is_trivially_copyable_v<T>, "trace fields are copied bytewise");
+		T value;
+		std::memcpy(&value, take(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	trace_blob blob() {
+		const auto size = get<uint32_t>();
+		return {take(size), size};
+	}
+
+	std::string_view text() {
+		const auto bytes = blob();
+		return {static_cast<const char*>(bytes.data), bytes.size};
+	}
+
+private:
+	const std::byte* take(size_t size) {
+		if (size > size_ - position_) {
+			throw std::runtime_error{"Truncated trace record"};
+		}
+		const auto* result = data_ + position_;
+		position_ += size;
+		return result;
+	}
+};
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// serializes the engine level stream an application drives: resource creation, texture
+// uploads, pipeline requests, scene and overlay updates, and a marker per drawn frame.
+// managers report their calls here and the recorder appends them to a binary trace that
+// `trace_player` drives a fresh engine from, so a captured workload can be benchmarked
+// outside the application that produced it. texel data is embedded as it is decoded,
+// meshes are referenced by filename.
+class trace_recorder {
+private:
+	gods_view::vulkan_engine* engine_;
+	std::atomic<bool> recording_;
+	// calls made by the engine on its own behalf, e.g. the texture behind a font atlas. read
+	// from whichever thread reports a call.
+	std::atomic<uint32_t> suppressed_;
+	std::mutex mutex_;
+	std::ofstream file_;
+	std::vector<std::byte> record_;
+	std::chrono::steady_clock::time_point last_frame_;
+	trace_stats stats_;
+
+public:
+	// keeps the calls made while it lives out of the trace, they are replayed by their caller.
+	class nested {
+	private:
+		trace_recorder* recorder_;
+
+	public:
+		explicit nested(trace_recorder* init_recorder) noexcept : recorder_{init_recorder} { recorder_->suppressed_.fetch_add(1); }
+
+		~nested() { recorder_->suppressed_.fetch_sub(1); }
+
+		nested(const nested&) = delete;
+
+		nested& operator=(const nested&) = delete;
+	};
+
+	trace_recorder(gods_view::vulkan_engine* init_engine);
+
+	~trace_recorder();
+
+	trace_recorder(const trace_recorder&) = delete;
+
+	trace_recorder& operator=(const trace_recorder&) = delete;
+
+	// true while render thread calls should be reported.
+	[[nodiscard]] bool recording() const noexcept { return suppressed_.load() == 0 && recording_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] trace_stats stats();
+
+	// starts a trace with the current windows' extents. resources created before this are
+	// not in it, start before loading the scene to capture it whole.
+	void start(const std::string& filename);
+
+	void stop();
+
+	void frame();
+
+	void mesh_load(mesh_id id, const std::string& filename);
+
+	// wraps `desc.decode` so each mip lands in the trace when it is decoded.
+	void texture_create(texture_id id, texture_desc& desc);
+
+	void texture_request(texture_id id, float screen_extent);
+
+	void transform_create(transform_id id, transform_id parent);
+
+	void transform_destroy(transform_id id);
+
+	void transform_parent(transform_id id, transform_id parent);
+
+	void transform_translation(transform_id id, float x, float y, float z);
+
+	void transform_rotation(transform_id id, float x, float y, float z, float w);
+
+	void transform_scale(transform_id id, float x, float y, float z);
+
+	void pipeline(const pipeline_state& state, const specialization_info& variant);
+
+	void overlay_font(overlay_atlas_id id, const overlay_font_desc& font);
+
+	void overlay_sprite_atlas(overlay_atlas_id id, texture_id texture, uint32_t width, uint32_t height, VkOffset2D white);
+
+	void overlay_quad(size_t surface_index, overlay_atlas_id atlas, const gods_view::overlay_rect& rect, const gods_view::overlay_rect& texels, uint32_t color);
+
+	void overlay_rect(size_t surface_index, overlay_atlas_id atlas, const gods_view::overlay_rect& rect, uint32_t color);
+
+	void overlay_text(size_t surface_index, overlay_atlas_id font, float x, float y, std::string_view utf8, uint32_t color, float scale);
+
+private:
+	template <typename... Fields>
+	void write(trace_op op, const Fields&... fields) {
+		std::lock_guard lock{mutex_};
+		if (!file_.is_open()) { return; }
+		record_.clear();
+		(details::append_trace_field(record_, fields), ...);
+		write_record(op);
+	}
+
+	// appends `record_` under `mutex_`.
+	void write_record(trace_op op);
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,472 @@
+#include "gods_view/transform_manager.h"
+#include "gods_view/vulkan_engine.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define PG_GODS_VIEW_TRANSFORM_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr uint32_t invalid_transform_slot = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t unknown_transform_depth = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t dead_transform_depth = unknown_transform_depth - 1;
+
+constexpr float4x4 identity_transform{{
+	1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, 1.0f
+}};
+
+template <typename T>
+static void gather(std::vector<T>& values, const std::vector<uint32_t>& source_slots, std::vector<T>& scratch) {
+	scratch.assign(values.begin(), values.end());
+	for (size_t slot = 0; slot < source_slots.size(); ++slot) {
+		values[slot] = scratch[source_slots[slot]];
+	}
+}
+
+#if !defined PG_GODS_VIEW_TRANSFORM_SSE
+// translation * rotation * scale.
+static void compose_transform(
+	float tx, float ty, float tz,
+	float qx, float qy, float qz, float qw,
+	float sx, float sy, float sz,
+	float* out
+)
+{
+	const float x2 = qx + qx, y2 = qy + qy, z2 = qz + qz;
+	const float xx = qx * x2, yy = qy * y2, zz = qz * z2;
+	const float xy = qx * y2, xz = qx * z2, yz = qy * z2;
+	const float wx = qw * x2, wy = qw * y2, wz = qw * z2;
+	out[0] = (1.0f - (yy + zz)) * sx; out[1] = (xy + wz) * sx; out[2] = (xz - wy) * sx; out[3] = 0.0f;
+	out[4] = (xy - wz) * sy; out[5] = (1.0f - (xx + zz)) * sy; out[6] = (yz + wx) * sy; out[7] = 0.0f;
+	out[8] = (xz + wy) * sz; out[9] = (yz - wx) * sz; out[10] = (1.0f - (xx + yy)) * sz; out[11] = 0.0f;
+	out[12] = tx; out[13] = ty; out[14] = tz; out[15] = 1.0f;
+}
+
+static void multiply_transforms(const float* a, const float* b, float* out) {
+	for (int column = 0; column < 4; ++column) {
+		for (int row = 0; row < 4; ++row) {
+			out[column * 4 + row] =
+				a[row] * b[column * 4] +
+				a[4 + row] * b[column * 4 + 1] +
+				a[8 + row] * b[column * 4 + 2] +
+				a[12 + row] * b[column * 4 + 3];
+		}
+	}
+}
+#endif
+
+} // end namespace pg::gods_view::details
+
+transform_manager::transform_manager(gods_view::vulkan_engine* init_engine) :
+	engine_{init_engine},
+	capacity_{0},
+	count_{0},
+	structure_dirty_{false},
+	updated_count_{0}
+{ }
+
+transform_manager::~transform_manager() {
+	if (buffer_.buffer != VK_NULL_HANDLE) {
+		details::destroy_buffer(engine_->device_manager()->dispatch(), buffer_);
+	}
+}
+
+void transform_manager::initialize(uint32_t capacity) {
+	if (capacity_ != 0) {
+		throw std::runtime_error{"Transform manager is already initialized"};
+	}
+	if (capacity == 0) {
+		throw std::runtime_error{"Transform manager needs a non-zero capacity"};
+	}
+	capacity_ = capacity;
+
+	// lane groups may read up to three slots past the last transform.
+	const size_t padded = capacity + details::transform_lane_count - 1;
+	parent_slot_.assign(padded, details::invalid_transform_slot);
+	id_of_slot_.assign(padded, invalid_transform);
+	translation_x_.assign(padded, 0.0f);
+	translation_y_.assign(padded, 0.0f);
+	translation_z_.assign(padded, 0.0f);
+	rotation_x_.assign(padded, 0.0f);
+	rotation_y_.assign(padded, 0.0f);
+	rotation_z_.assign(padded, 0.0f);
+	rotation_w_.assign(padded, 1.0f);
+	scale_x_.assign(padded, 1.0f);
+	scale_y_.assign(padded, 1.0f);
+	scale_z_.assign(padded, 1.0f);
+	local_dirty_.assign(padded, 0);
+	world_dirty_.assign(padded, 0);
+	world_.assign(capacity, details::identity_transform);
+
+	slot_of_id_.assign(capacity, details::invalid_transform_slot);
+	parent_of_id_.assign(capacity, invalid_transform);
+	alive_.assign(capacity, 0);
+	free_ids_.resize(capacity);
+	for (uint32_t i = 0; i < capacity; ++i) {
+		// handed out lowest first.
+		free_ids_[i] = capacity - 1 - i;
+	}
+
+	buffer_ = details::create_buffer(
+		engine_->device_manager()->dispatch(),
+		engine_->device_manager()->memory_properties(),
+		static_cast<VkDeviceSize>(capacity) * sizeof(details::float4x4),
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+	);
+	std::memcpy(buffer_.mapped, world_.data(), world_.size() * sizeof(details::float4x4));
+}
+
+transform_id transform_manager::create(transform_id parent) {
+	if (parent != invalid_transform && (parent >= capacity_ || !alive_[parent])) {
+		throw std::runtime_error{"Invalid parent transform"};
+	}
+	if (free_ids_.empty()) {
+		throw std::runtime_error{"Transform capacity exceeded"};
+	}
+	const transform_id id = free_ids_.back();
+	free_ids_.pop_back();
+
+	// appended out of depth order, `update` sorts it in before propagating.
+	const uint32_t slot = count_++;
+	slot_of_id_[id] = slot;
+	parent_of_id_[id] = parent;
+	alive_[id] = 1;
+	id_of_slot_[slot] = id;
+	translation_x_[slot] = translation_y_[slot] = translation_z_[slot] = 0.0f;
+	rotation_x_[slot] = rotation_y_[slot] = rotation_z_[slot] = 0.0f;
+	rotation_w_[slot] = 1.0f;
+	scale_x_[slot] = scale_y_[slot] = scale_z_[slot] = 1.0f;
+	local_dirty_[slot] = 1;
+	structure_dirty_ = true;
+	engine_->trace_recorder()->transform_create(id, parent);
+	return id;
+}
+
+void transform_manager::destroy(transform_id id) {
+	if (id >= capacity_ || !alive_[id]) {
+		throw std::runtime_error{"Invalid transform"};
+	}
+	engine_->trace_recorder()->transform_destroy(id);
+	// descendants are found and released by the next reorder.
+	alive_[id] = 0;
+	structure_dirty_ = true;
+}
+
+void transform_manager::set_parent(transform_id id, transform_id parent) {
+	if (id >= capacity_ || !alive_[id] || (parent != invalid_transform && (parent >= capacity_ || !alive_[parent]))) {
+		throw std::runtime_error{"Invalid transform"};
+	}
+	for (auto ancestor = parent; ancestor != invalid_transform; ancestor = parent_of_id_[ancestor]) {
+		if (ancestor == id) {
+			throw std::runtime_error{"Transform can't be parented to its own descendant"};
+		}
+	}
+	engine_->trace_recorder()->transform_parent(id, parent);
+	parent_of_id_[id] = parent;
+	mark_dirty(id);
+	structure_dirty_ = true;
+}
+
+void transform_manager::set_translation(transform_id id, float x, float y, float z) {
+	const auto slot = checked_slot(id);
+	engine_->trace_recorder()->transform_translation(id, x, y, z);
+	translation_x_[slot] = x;
+	translation_y_[slot] = y;
+	translation_z_[slot] = z;
+	local_dirty_[slot] = 1;
+}
+
+void transform_manager::set_rotation(transform_id id, float x, float y, float z, float w) {
+	const auto slot = checked_slot(id);
+	engine_->trace_recorder()->transform_rotation(id, x, y, z, w);
+	rotation_x_[slot] = x;
+	rotation_y_[slot] = y;
+	rotation_z_[slot] = z;
+	rotation_w_[slot] = w;
+	local_dirty_[slot] = 1;
+}
+
+void transform_manager::set_scale(transform_id id, float x, float y, float z) {
+	const auto slot = checked_slot(id);
+	engine_->trace_recorder()->transform_scale(id, x, y, z);
+	scale_x_[slot] = x;
+	scale_y_[slot] = y;
+	scale_z_[slot] = z;
+	local_dirty_[slot] = 1;
+}
+
+const float* transform_manager::world_matrix(transform_id id) const {
+	return world_[checked_slot(id)].m;
+}
+
+void transform_manager::mark_dirty(transform_id id) {
+	local_dirty_[slot_of_id_[id]] = 1;
+}
+
+uint32_t transform_manager::checked_slot(transform_id id) const {
+	if (id >= capacity_ || !alive_[id]) {
+		throw std::runtime_error{"Invalid transform"};
+	}
+	return slot_of_id_[id];
+}
+
+void transform_manager::update() {
+	if (capacity_ == 0) { return; }
+	if (structure_dirty_) {
+		rebuild_order();
+	}
+
+	updated_count_ = 0;
+	const size_t depth_count = depth_begin_.empty() ? 0 : depth_begin_.size() - 1;
+	for (size_t depth = 0; depth < depth_count; ++depth) {
+		const size_t begin = depth_begin_[depth];
+		const size_t end = depth_begin_[depth + 1];
+		// a node is redone when it or anything above it changed, parents were settled by the
+		// previous depth.
+		uint32_t dirty_count{0};
+		if (depth == 0) {
+			for (size_t slot = begin; slot < end; ++slot) {
+				world_dirty_[slot] = local_dirty_[slot];
+				dirty_count += world_dirty_[slot];
+			}
+		} else {
+			for (size_t slot = begin; slot < end; ++slot) {
+				world_dirty_[slot] = local_dirty_[slot] | world_dirty_[parent_slot_[slot]];
+				dirty_count += world_dirty_[slot];
+			}
+		}
+		if (dirty_count == 0) { continue; }
+		updated_count_ += dirty_count;
+
+		const bool roots = depth == 0;
+		const size_t group_count = (end - begin + details::transform_lane_count - 1) / details::transform_lane_count;
+		engine_->job_system()->parallel_for(0, group_count, details::transform_parallel_grain, [this, begin, end, roots](size_t first_group, size_t last_group) {
+			propagate(
+				begin + first_group * details::transform_lane_count,
+				std::min(end, begin + last_group * details::transform_lane_count),
+				roots
+			);
+		});
+	}
+	std::fill(local_dirty_.begin(), local_dirty_.begin() + count_, 0);
+}
+
+void transform_manager::propagate(size_t begin, size_t end, bool roots) {
+	auto gpu_world = static_cast<details::float4x4*>(buffer_.mapped);
+#if defined PG_GODS_VIEW_TRANSFORM_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (size_t i = begin; i < end; i += details::transform_lane_count) {
+		const size_t lanes = std::min(details::transform_lane_count, end - i);
+		bool any_dirty{false};
+		for (size_t lane = 0; lane < lanes; ++lane) {
+			any_dirty = any_dirty || world_dirty_[i + lane] != 0;
+		}
+		if (!any_dirty) { continue; }
+
+		// local matrices of four nodes at once, one register per matrix element.
+		const __m128 qx = _mm_loadu_ps(&rotation_x_[i]);
+		const __m128 qy = _mm_loadu_ps(&rotation_y_[i]);
+		const __m128 qz = _mm_loadu_ps(&rotation_z_[i]);
+		const __m128 qw = _mm_loadu_ps(&rotation_w_[i]);
+		const __m128 sx = _mm_loadu_ps(&scale_x_[i]);
+		const __m128 sy = _mm_loadu_ps(&scale_y_[i]);
+		const __m128 sz = _mm_loadu_ps(&scale_z_[i]);
+		const __m128 x2 = _mm_add_ps(qx, qx);
+		const __m128 y2 = _mm_add_ps(qy, qy);
+		const __m128 z2 = _mm_add_ps(qz, qz);
+		const __m128 xx = _mm_mul_ps(qx, x2);
+		const __m128 yy = _mm_mul_ps(qy, y2);
+		const __m128 zz = _mm_mul_ps(qz, z2);
+		const __m128 xy = _mm_mul_ps(qx, y2);
+		const __m128 xz = _mm_mul_ps(qx, z2);
+		const __m128 yz = _mm_mul_ps(qy, z2);
+		const __m128 wx = _mm_mul_ps(qw, x2);
+		const __m128 wy = _mm_mul_ps(qw, y2);
+		const __m128 wz = _mm_mul_ps(qw, z2);
+
+		__m128 column[4][4] = {
+			{
+				_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx),
+				_mm_mul_ps(_mm_add_ps(xy, wz), sx),
+				_mm_mul_ps(_mm_sub_ps(xz, wy), sx),
+				_mm_setzero_ps()
+			},
+			{
+				_mm_mul_ps(_mm_sub_ps(xy, wz), sy),
+				_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+				_mm_mul_ps(_mm_add_ps(yz, wx), sy),
+				_mm_setzero_ps()
+			},
+			{
+				_mm_mul_ps(_mm_add_ps(xz, wy), sz),
+				_mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+				_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz),
+				_mm_setzero_ps()
+			},
+			{
+				_mm_loadu_ps(&translation_x_[i]),
+				_mm_loadu_ps(&translation_y_[i]),
+				_mm_loadu_ps(&translation_z_[i]),
+				one
+			}
+		};
+		// afterwards column[c][lane] holds column c of that lane's local matrix.
+		for (auto& c : column) {
+			_MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+		}
+
+		for (size_t lane = 0; lane < lanes; ++lane) {
+			const size_t slot = i + lane;
+			if (!world_dirty_[slot]) { continue; }
+			__m128 world[4];
+			if (roots) {
+				for (int c = 0; c < 4; ++c) {
+					world[c] = column[c][lane];
+				}
+			} else {
+				const float* parent = world_[parent_slot_[slot]].m;
+				const __m128 p0 = _mm_load_ps(parent);
+				const __m128 p1 = _mm_load_ps(parent + 4);
+				const __m128 p2 = _mm_load_ps(parent + 8);
+				const __m128 p3 = _mm_load_ps(parent + 12);
+				for (int c = 0; c < 4; ++c) {
+					const __m128 local = column[c][lane];
+					world[c] = _mm_add_ps(
+						_mm_add_ps(
+							_mm_mul_ps(p0, _mm_shuffle_ps(local, local, _MM_SHUFFLE(0, 0, 0, 0))),
+							_mm_mul_ps(p1, _mm_shuffle_ps(local, local, _MM_SHUFFLE(1, 1, 1, 1)))
+						),
+						_mm_add_ps(
+							_mm_mul_ps(p2, _mm_shuffle_ps(local, local, _MM_SHUFFLE(2, 2, 2, 2))),
+							_mm_mul_ps(p3, _mm_shuffle_ps(local, local, _MM_SHUFFLE(3, 3, 3, 3)))
+						)
+					);
+				}
+			}
+			float* cpu_out = world_[slot].m;
+			// write combined memory, streaming keeps the stores out of the cache.
+			float* gpu_out = gpu_world[id_of_slot_[slot]].m;
+			for (int c = 0; c < 4; ++c) {
+				_mm_store_ps(cpu_out + c * 4, world[c]);
+				_mm_stream_ps(gpu_out + c * 4, world[c]);
+			}
+		}
+	}
+	// streaming stores are weakly ordered and only fenced on the thread that issued them, this
+	// chunk may have run on a worker, so it fences its own before the job counts as done.
+	_mm_sfence();
+#else
+	for (size_t slot = begin; slot < end; ++slot) {
+		if (!world_dirty_[slot]) { continue; }
+		details::float4x4 local;
+		details::compose_transform(
+			translation_x_[slot], translation_y_[slot], translation_z_[slot],
+			rotation_x_[slot], rotation_y_[slot], rotation_z_[slot], rotation_w_[slot],
+			scale_x_[slot], scale_y_[slot], scale_z_[slot],
+			local.m
+		);
+		if (roots) {
+			world_[slot] = local;
+		} else {
+			details::multiply_transforms(world_[parent_slot_[slot]].m, local.m, world_[slot].m);
+		}
+		gpu_world[id_of_slot_[slot]] = world_[slot];
+	}
+#endif
+}
+
+void transform_manager::rebuild_order() {
+	// depth of every transform, a destroyed one takes its whole subtree with it.
+	std::vector<uint32_t> depth_of_id(capacity_, details::unknown_transform_depth);
+	std::vector<transform_id> chain;
+	std::vector<std::vector<transform_id>> depths;
+	for (uint32_t slot = 0; slot < count_; ++slot) {
+		const auto id = id_of_slot_[slot];
+		chain.clear();
+		auto ancestor = id;
+		while (ancestor != invalid_transform && depth_of_id[ancestor] == details::unknown_transform_depth) {
+			chain.push_back(ancestor);
+			ancestor = parent_of_id_[ancestor];
+		}
+		uint32_t next_depth = 0;
+		if (ancestor != invalid_transform) {
+			next_depth = depth_of_id[ancestor] == details::dead_transform_depth ? details::dead_transform_depth : depth_of_id[ancestor] + 1;
+		}
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+			const bool dead = !alive_[*it] || next_depth == details::dead_transform_depth;
+			depth_of_id[*it] = dead ? details::dead_transform_depth : next_depth;
+			next_depth = dead ? details::dead_transform_depth : next_depth + 1;
+		}
+
+		const auto depth = depth_of_id[id];
+		if (depth == details::dead_transform_depth) {
+			alive_[id] = 0;
+			slot_of_id_[id] = details::invalid_transform_slot;
+			free_ids_.push_back(id);
+			continue;
+		}
+		if (depth >= depths.size()) {
+			depths.resize(depth + 1);
+		}
+		depths[depth].push_back(id);
+	}
+
+	// siblings end up next to each other, in the order of their parents.
+	std::vector<uint32_t> new_slot_of_id(capacity_, details::invalid_transform_slot);
+	std::vector<uint32_t> source_slots;
+	source_slots.reserve(count_);
+	depth_begin_.clear();
+	for (size_t depth = 0; depth < depths.size(); ++depth) {
+		auto& ids = depths[depth];
+		if (depth > 0) {
+			std::stable_sort(ids.begin(), ids.end(), [this, &new_slot_of_id](transform_id a, transform_id b) {
+				return new_slot_of_id[parent_of_id_[a]] < new_slot_of_id[parent_of_id_[b]];
+			});
+		}
+		depth_begin_.push_back(static_cast<uint32_t>(source_slots.size()));
+		for (auto id : ids) {
+			new_slot_of_id[id] = static_cast<uint32_t>(source_slots.size());
+			source_slots.push_back(slot_of_id_[id]);
+		}
+	}
+	depth_begin_.push_back(static_cast<uint32_t>(source_slots.size()));
+
+	std::vector<float> float_scratch;
+	details::gather(translation_x_, source_slots, float_scratch);
+	details::gather(translation_y_, source_slots, float_scratch);
+	details::gather(translation_z_, source_slots, float_scratch);
+	details::gather(rotation_x_, source_slots, float_scratch);
+	details::gather(rotation_y_, source_slots, float_scratch);
+	details::gather(rotation_z_, source_slots, float_scratch);
+	details::gather(rotation_w_, source_slots, float_scratch);
+	details::gather(scale_x_, source_slots, float_scratch);
+	details::gather(scale_y_, source_slots, float_scratch);
+	details::gather(scale_z_, source_slots, float_scratch);
+	std::vector<uint8_t> flag_scratch;
+	details::gather(local_dirty_, source_slots, flag_scratch);
+	std::vector<details::float4x4> world_scratch;
+	details::gather(world_, source_slots, world_scratch);
+	std::vector<transform_id> id_scratch;
+	details::gather(id_of_slot_, source_slots, id_scratch);
+
+	count_ = static_cast<uint32_t>(source_slots.size());
+	for (uint32_t slot = 0; slot < count_; ++slot) {
+		const auto id = id_of_slot_[slot];
+		const auto parent = parent_of_id_[id];
+		slot_of_id_[id] = slot;
+		parent_slot_[slot] = parent == invalid_transform ? details::invalid_transform_slot : new_slot_of_id[parent];
+	}
+	structure_dirty_ = false;
+}
+
+} // end namespace pg::gods_view
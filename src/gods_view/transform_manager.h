@@ -0,0 +1,138 @@
+#if !defined PG_GODS_VIEW_TRANSFORM_MANAGER_HEADER_INCLUDED
+#define PG_GODS_VIEW_TRANSFORM_MANAGER_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/memory.h"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace pg::gods_view {
+
+using transform_id = uint32_t;
+
+constexpr transform_id invalid_transform = std::numeric_limits<transform_id>::max();
+
+struct transform_stats {
+	uint32_t transform_count;
+	uint32_t depth_count;
+	// world matrices recomputed by the last update.
+	uint32_t updated_count;
+};
+
+namespace details {
+
+// column major, matches a glsl mat4.
+struct alignas(16) float4x4 {
+	float m[16];
+};
+
+constexpr size_t transform_lane_count = 4;
+constexpr size_t transform_parallel_grain = 64;
+
+} // end namespace pg::gods_view::details
+
+class vulkan_engine;
+
+// scene transforms stored as a structure of arrays, ordered by hierarchy depth so every parent
+// is finished before its children are visited. `update` walks each depth once, four nodes per
+// SSE lane group, and only recomputes nodes whose local transform or an ancestor changed.
+// world matrices go to a cpu copy for child lookups and are streamed into a persistently mapped
+// storage buffer indexed by transform id, so shaders read `transforms[id]` directly.
+class transform_manager {
+private:
+	gods_view::vulkan_engine* engine_;
+	uint32_t capacity_;
+	uint32_t count_;
+	bool structure_dirty_;
+	uint32_t updated_count_;
+
+	// per slot, sorted by depth once the structure is settled.
+	std::vector<uint32_t> parent_slot_;
+	std::vector<transform_id> id_of_slot_;
+	std::vector<float> translation_x_;
+	std::vector<float> translation_y_;
+	std::vector<float> translation_z_;
+	std::vector<float> rotation_x_;
+	std::vector<float> rotation_y_;
+	std::vector<float> rotation_z_;
+	std::vector<float> rotation_w_;
+	std::vector<float> scale_x_;
+	std::vector<float> scale_y_;
+	std::vector<float> scale_z_;
+	std::vector<uint8_t> local_dirty_;
+	std::vector<uint8_t> world_dirty_;
+	std::vector<details::float4x4> world_;
+	// first slot of each depth, plus one past the end.
+	std::vector<uint32_t> depth_begin_;
+
+	// per id.
+	std::vector<uint32_t> slot_of_id_;
+	std::vector<transform_id> parent_of_id_;
+	std::vector<uint8_t> alive_;
+	std::vector<transform_id> free_ids_;
+
+	gpu_buffer buffer_;
+
+public:
+	transform_manager(gods_view::vulkan_engine* init_engine);
+
+	~transform_manager();
+
+	transform_manager(const transform_manager&) = delete;
+
+	transform_manager& operator=(const transform_manager&) = delete;
+
+	// allocates cpu storage and the mapped buffer for up to `capacity` transforms.
+	void initialize(uint32_t capacity);
+
+	[[nodiscard]] VkBuffer buffer() const noexcept { return buffer_.buffer; }
+
+	[[nodiscard]] VkDeviceSize buffer_size() const noexcept { return buffer_.size; }
+
+	[[nodiscard]] transform_stats stats() const noexcept {
+		return {count_, static_cast<uint32_t>(depth_begin_.empty() ? 0 : depth_begin_.size() - 1), updated_count_};
+	}
+
+	transform_id create(transform_id parent = invalid_transform);
+
+	// destroys `id` together with everything below it.
+	void destroy(transform_id id);
+
+	void set_parent(transform_id id, transform_id parent);
+
+	void set_translation(transform_id id, float x, float y, float z);
+
+	// unit quaternion.
+	void set_rotation(transform_id id, float x, float y, float z, float w);
+
+	void set_scale(transform_id id, float x, float y, float z);
+
+	// `invalid_transform` for roots.
+	[[nodiscard]] transform_id parent(transform_id id) const noexcept { return parent_of_id_[id]; }
+
+	// as of the last `update`.
+	[[nodiscard]] const float* world_matrix(transform_id id) const;
+
+	// propagates dirty transforms. the buffer is written in place, so call it once the gpu is
+	// done with the previous frame, e.g. from the draw manager's frame jobs.
+	void update();
+
+private:
+	void rebuild_order();
+
+	void propagate(size_t begin, size_t end, bool roots);
+
+	void mark_dirty(transform_id id);
+
+	// throws for ids that were never created or are destroyed.
+	[[nodiscard]] uint32_t checked_slot(transform_id id) const;
+};
+
+} // end namespace pg::gods_view
+
+#endif
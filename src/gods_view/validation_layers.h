@@ -2,6 +2,8 @@
 #define PG_GODS_VIEW_VALIDATION_LAYERS_HEADER_INCLUDED
 #pragma once
 
+#include "gods_view/validation_message_sink.h"
+
 #include <vulkan/vulkan.h>
 
 #include <cstdint>
@@ -29,6 +31,14 @@ const std::vector<const char*> device_extensions = {
 	VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
 
+// enabled when the device exposes them, features depending on them fall back otherwise.
+const std::vector<const char*> optional_device_extensions = {
+	VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+	VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME,
+	VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME,
+	VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME
+};
+
 static VkResult create_debug_utils_messenger_ext(
 	VkInstance instance,
 	const VkDebugUtilsMessengerCreateInfoEXT* create_info,
@@ -103,11 +113,13 @@ class debug_messenger {
 private:
 	VkDebugUtilsMessengerEXT debug_messenger_handle_;
 	VkInstance vk_instance_;
+	gods_view::validation_message_sink* message_sink_;
 
 public:
-	debug_messenger(VkInstance vk_instance) :
+	debug_messenger(VkInstance vk_instance, gods_view::validation_message_sink* message_sink = nullptr) :
 		debug_messenger_handle_{nullptr},
-		vk_instance_{vk_instance}
+		vk_instance_{vk_instance},
+		message_sink_{message_sink}
 	{ 
 		initiate_debug_messenger();
 	}
@@ -116,26 +128,35 @@ public:
 		destroy_debug_messenger();
 	}
 
-	static void populate_debug_messenger_info(VkDebugUtilsMessengerCreateInfoEXT& info) {
+	// without a sink messages go straight to std::cerr on the raising thread.
+	static void populate_debug_messenger_info(
+		VkDebugUtilsMessengerCreateInfoEXT& info,
+		gods_view::validation_message_sink* message_sink = nullptr
+	)
+	{
 		info = {};
 		info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-		info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
-							   VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
-							   VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+		info.messageSeverity = message_sink != nullptr ?
+			message_sink->registered_severities() :
+			VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
 		info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
 						   VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
 						   VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
 		info.pfnUserCallback = debug_cb;
+		info.pUserData = message_sink;
 	}
 
 private:
 	void initiate_debug_messenger() {
 		if (!details::enable_validation_layers) { return; }
 		VkDebugUtilsMessengerCreateInfoEXT info{};
-		populate_debug_messenger_info(info);
+		populate_debug_messenger_info(info, message_sink_);
 		if (details::create_debug_utils_messenger_ext(vk_instance_, &info, nullptr, &debug_messenger_handle_) != VK_SUCCESS) {
 			throw std::runtime_error{"Failed to setup debug messegner"};
 		}
+		if (message_sink_ != nullptr) {
+			message_sink_->start();
+		}
 	}
 
 	void destroy_debug_messenger() {
@@ -150,7 +171,11 @@ private:
 		void* user_data
 	)
 	{
-		std::cerr << "validation layer: " << cb_data->pMessage << std::endl;
+		if (user_data != nullptr) {
+			static_cast<gods_view::validation_message_sink*>(user_data)->submit(message_sevirity, message_type, cb_data);
+		} else {
+			std::cerr << "validation layer: " << cb_data->pMessage << '\n';
+		}
 		return VK_FALSE;
 	}
 
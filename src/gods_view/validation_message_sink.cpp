@@ -0,0 +1,183 @@
+#include "gods_view/validation_message_sink.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr std::size_t validation_message_id_max_probes = 32;
+constexpr std::chrono::milliseconds validation_message_drain_interval{2};
+
+template <std::size_t N>
+static void copy_truncated(char (&destination)[N], const char* source) noexcept {
+	if (source == nullptr) {
+		destination[0] = '\0';
+		return;
+	}
+	std::size_t length = std::strlen(source);
+	if (length >= N) { length = N - 1; }
+	std::memcpy(destination, source, length);
+	destination[length] = '\0';
+}
+
+static uint32_t hash_message_name(const char* text) noexcept {
+	uint32_t hash{2166136261u};
+	if (text == nullptr) { return hash; }
+	for (; *text != '\0'; ++text) {
+		hash ^= static_cast<uint8_t>(*text);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static const char* severity_name(VkDebugUtilsMessageSeverityFlagBitsEXT severity) noexcept {
+	if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) { return "error"; }
+	if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) { return "warning"; }
+	if (severity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) { return "info"; }
+	return "verbose";
+}
+
+static const char* type_name(VkDebugUtilsMessageTypeFlagsEXT type) noexcept {
+	if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) { return "validation"; }
+	if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) { return "performance"; }
+	return "general";
+}
+
+} // end namespace pg::gods_view::details
+
+validation_message_sink::validation_message_sink(
+	VkDebugUtilsMessageSeverityFlagsEXT init_severity_filter,
+	VkDebugUtilsMessageTypeFlagsEXT init_type_filter,
+	std::ostream& init_output
+) :
+	severity_filter_{init_severity_filter},
+	type_filter_{init_type_filter},
+	dropped_count_{0},
+	running_{false},
+	registered_severities_{init_severity_filter},
+	output_{init_output}
+{
+	for (auto& entry : id_table_) {
+		entry.key.store(0, std::memory_order_relaxed);
+		entry.count.store(0, std::memory_order_relaxed);
+	}
+}
+
+validation_message_sink::~validation_message_sink() {
+	stop();
+}
+
+void validation_message_sink::submit(
+	VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+	VkDebugUtilsMessageTypeFlagsEXT type,
+	const VkDebugUtilsMessengerCallbackDataEXT* cb_data
+) noexcept
+{
+	if ((severity & severity_filter_.load(std::memory_order_relaxed)) == 0 ||
+		(type & type_filter_.load(std::memory_order_relaxed)) == 0)
+	{
+		return;
+	}
+	// some loader and layer messages carry no id number, fall back to their name or text.
+	uint32_t id = static_cast<uint32_t>(cb_data->messageIdNumber);
+	if (id == 0) {
+		id = details::hash_message_name(cb_data->pMessageIdName != nullptr ? cb_data->pMessageIdName : cb_data->pMessage);
+	}
+	if (count_occurrence(id) != 0) { return; }
+
+	const bool pushed = ring_.try_push([&](details::validation_message& message) {
+		message.severity = severity;
+		message.type = type;
+		message.id = id;
+		details::copy_truncated(message.name, cb_data->pMessageIdName);
+		details::copy_truncated(message.text, cb_data->pMessage);
+	});
+	if (!pushed) {
+		dropped_count_.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void validation_message_sink::start() {
+	if (running_.exchange(true, std::memory_order_acq_rel)) { return; }
+	drain_thread_ = std::thread{[this]() { drain(); }};
+}
+
+void validation_message_sink::stop() {
+	running_.store(false, std::memory_order_release);
+	if (drain_thread_.joinable()) {
+		drain_thread_.join();
+	}
+	drain_pending();
+	write_summary();
+}
+
+uint64_t validation_message_sink::count_occurrence(uint32_t id) noexcept {
+	// keys are stored offset by one so a zeroed entry reads as empty.
+	const uint64_t key = static_cast<uint64_t>(id) + 1;
+	const std::size_t start = static_cast<std::size_t>(id * 2654435761u);
+	for (std::size_t probe = 0; probe < details::validation_message_id_max_probes; ++probe) {
+		auto& entry = id_table_[(start + probe) & (id_table_.size() - 1)];
+		uint64_t current = entry.key.load(std::memory_order_acquire);
+		if (current == 0 && entry.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+			return entry.count.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (current == key) {
+			return entry.count.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	// table is saturated around this id, let the message through rather than lose it.
+	return 0;
+}
+
+void validation_message_sink::drain() {
+	while (running_.load(std::memory_order_acquire)) {
+		if (!drain_pending()) {
+			std::this_thread::sleep_for(details::validation_message_drain_interval);
+		}
+	}
+}
+
+bool validation_message_sink::drain_pending() {
+	bool drained{false};
+	while (ring_.try_pop([this](const details::validation_message& message) { write_message(message); })) {
+		drained = true;
+	}
+	if (drained) {
+		output_.flush();
+	}
+	return drained;
+}
+
+void validation_message_sink::write_message(const details::validation_message& message) {
+	if (message.name[0] != '\0') {
+		id_names_.try_emplace(message.id, message.name);
+	}
+	output_ << "validation layer [" << details::severity_name(message.severity) << '|'
+			<< details::type_name(message.type) << "]: " << message.text << '\n';
+}
+
+void validation_message_sink::write_summary() {
+	bool wrote{false};
+	for (auto& entry : id_table_) {
+		const uint64_t key = entry.key.load(std::memory_order_acquire);
+		const uint64_t count = entry.count.exchange(0, std::memory_order_relaxed);
+		if (key == 0 || count < 2) { continue; }
+		const auto id = static_cast<uint32_t>(key - 1);
+		const auto name = id_names_.find(id);
+		output_ << "validation layer: " << (name != id_names_.end() ? name->second : std::string{"message"})
+				<< " (0x" << std::hex << id << std::dec << ") repeated " << count << " times\n";
+		wrote = true;
+	}
+	const uint64_t dropped = dropped_count_.exchange(0, std::memory_order_relaxed);
+	if (dropped != 0) {
+		output_ << "validation layer: " << dropped << " messages dropped, sink ring was full\n";
+		wrote = true;
+	}
+	if (wrote) {
+		output_.flush();
+	}
+}
+
+} // end namespace pg::gods_view
@@ -0,0 +1,115 @@
+#if !defined PG_GODS_VIEW_VALIDATION_MESSAGE_SINK_HEADER_INCLUDED
+#define PG_GODS_VIEW_VALIDATION_MESSAGE_SINK_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/lock_free_ring.h"
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr std::size_t validation_message_text_size = 1024;
+constexpr std::size_t validation_message_name_size = 64;
+constexpr std::size_t validation_message_ring_size = 256;
+constexpr std::size_t validation_message_id_table_size = 1024;
+
+struct validation_message {
+	VkDebugUtilsMessageSeverityFlagBitsEXT severity;
+	VkDebugUtilsMessageTypeFlagsEXT type;
+	uint32_t id;
+	char name[validation_message_name_size];
+	char text[validation_message_text_size];
+};
+
+} // end namespace pg::gods_view::details
+
+// collects debug utils messages from whatever driver thread raises them and writes them out
+// on a background thread. the callback side only touches atomics and a preallocated ring;
+// repeats of an already seen message id are counted instead of queued.
+class validation_message_sink {
+private:
+	struct id_entry {
+		std::atomic<uint64_t> key;
+		std::atomic<uint64_t> count;
+	};
+
+	gods_view::mpsc_ring<details::validation_message, details::validation_message_ring_size> ring_;
+	std::array<id_entry, details::validation_message_id_table_size> id_table_;
+	std::atomic<VkDebugUtilsMessageSeverityFlagsEXT> severity_filter_;
+	std::atomic<VkDebugUtilsMessageTypeFlagsEXT> type_filter_;
+	std::atomic<uint64_t> dropped_count_;
+	std::atomic<bool> running_;
+	VkDebugUtilsMessageSeverityFlagsEXT registered_severities_;
+	std::ostream& output_;
+	std::thread drain_thread_;
+	std::unordered_map<uint32_t, std::string> id_names_;
+
+public:
+	validation_message_sink(
+		VkDebugUtilsMessageSeverityFlagsEXT init_severity_filter = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+																   VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+		VkDebugUtilsMessageTypeFlagsEXT init_type_filter = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+														   VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+														   VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+		std::ostream& init_output = std::cerr
+	);
+
+	~validation_message_sink();
+
+	validation_message_sink(const validation_message_sink&) = delete;
+
+	validation_message_sink& operator=(const validation_message_sink&) = delete;
+
+	// severities the messenger is registered for. the layers skip formatting anything outside
+	// this mask, so the runtime filter can narrow it but not widen it.
+	[[nodiscard]] VkDebugUtilsMessageSeverityFlagsEXT registered_severities() const noexcept { return registered_severities_; }
+
+	[[nodiscard]] VkDebugUtilsMessageSeverityFlagsEXT severity_filter() const noexcept { return severity_filter_.load(std::memory_order_relaxed); }
+
+	void severity_filter(VkDebugUtilsMessageSeverityFlagsEXT filter) noexcept { severity_filter_.store(filter, std::memory_order_relaxed); }
+
+	[[nodiscard]] VkDebugUtilsMessageTypeFlagsEXT type_filter() const noexcept { return type_filter_.load(std::memory_order_relaxed); }
+
+	void type_filter(VkDebugUtilsMessageTypeFlagsEXT filter) noexcept { type_filter_.store(filter, std::memory_order_relaxed); }
+
+	[[nodiscard]] uint64_t dropped_count() const noexcept { return dropped_count_.load(std::memory_order_relaxed); }
+
+	[[nodiscard]] bool running() const noexcept { return running_.load(std::memory_order_acquire); }
+
+	// called from the debug utils callback; never blocks, allocates or writes output.
+	void submit(
+		VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+		VkDebugUtilsMessageTypeFlagsEXT type,
+		const VkDebugUtilsMessengerCallbackDataEXT* cb_data
+	) noexcept;
+
+	void start();
+
+	void stop();
+
+private:
+	// returns how many times `id` had been seen before this call.
+	uint64_t count_occurrence(uint32_t id) noexcept;
+
+	void drain();
+
+	bool drain_pending();
+
+	void write_message(const details::validation_message& message);
+
+	void write_summary();
+};
+
+} // end namespace pg::gods_view
+
+#endif
@@ -0,0 +1,106 @@
+#if !defined PG_GODS_VIEW_VERTEX_HEADER_INCLUDED
+#define PG_GODS_VIEW_VERTEX_HEADER_INCLUDED
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pg::gods_view {
+
+// the engine's interleaved vertex layout, mesh files store vertices in exactly this form.
+struct vertex {
+	float position[3];
+	float normal[3];
+	float uv[2];
+
+	static VkVertexInputBindingDescription binding_description() noexcept {
+		VkVertexInputBindingDescription description{};
+		description.binding = 0;
+		description.stride = sizeof(vertex);
+		description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		return description;
+	}
+
+	static std::array<VkVertexInputAttributeDescription, 3> attribute_descriptions() noexcept {
+		std::array<VkVertexInputAttributeDescription, 3> descriptions{};
+		descriptions[0].location = 0;
+		descriptions[0].binding = 0;
+		descriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+		descriptions[0].offset = offsetof(vertex, position);
+		descriptions[1].location = 1;
+		descriptions[1].binding = 0;
+		descriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+		descriptions[1].offset = offsetof(vertex, normal);
+		descriptions[2].location = 2;
+		descriptions[2].binding = 0;
+		descriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+		descriptions[2].offset = offsetof(vertex, uv);
+		return descriptions;
+	}
+};
+
+static_assert(sizeof(vertex) == 32, "vertex must stay tightly packed, mesh files depend on it");
+
+enum class vertex_format : uint32_t {
+	// `vertex`, full precision floats.
+	full = 0,
+	// `packed_vertex`.
+	packed = 1
+};
+
+// `vertex` quantized to 20 bytes, with a tangent frame added; see `quantize_vertices`. the
+// formats below hand the shader floats again, only positions still need the mesh bounds
+// applied, see shaders/mesh.vert.
+struct packed_vertex {
+	// unorm over the mesh bounds. w carries the bitangent's sign, 0 for -1 and 65535 for +1.
+	uint16_t position[4];
+	// octahedral encoded unit vectors, snorm.
+	int16_t normal[2];
+	// half floats, so tiling coordinates outside [0, 1] survive.
+	uint16_t uv[2];
+	int16_t tangent[2];
+
+	static VkVertexInputBindingDescription binding_description() noexcept {
+		VkVertexInputBindingDescription description{};
+		description.binding = 0;
+		description.stride = sizeof(packed_vertex);
+		description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		return description;
+	}
+
+	// locations 0 to 2 match `vertex`, the tangent comes after them.
+	static std::array<VkVertexInputAttributeDescription, 4> attribute_descriptions() noexcept {
+		std::array<VkVertexInputAttributeDescription, 4> descriptions{};
+		descriptions[0].location = 0;
+		descriptions[0].binding = 0;
+		descriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+		descriptions[0].offset = offsetof(packed_vertex, position);
+		descriptions[1].location = 1;
+		descriptions[1].binding = 0;
+		descriptions[1].format = VK_FORMAT_R16G16_SNORM;
+		descriptions[1].offset = offsetof(packed_vertex, normal);
+		descriptions[2].location = 2;
+		descriptions[2].binding = 0;
+		descriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+		descriptions[2].offset = offsetof(packed_vertex, uv);
+		descriptions[3].location = 3;
+		descriptions[3].binding = 0;
+		descriptions[3].format = VK_FORMAT_R16G16_SNORM;
+		descriptions[3].offset = offsetof(packed_vertex, tangent);
+		return descriptions;
+	}
+};
+
+static_assert(sizeof(packed_vertex) == 20, "packed_vertex must stay tightly packed, mesh files depend on it");
+
+// bytes per vertex in a stream of `format`.
+constexpr uint32_t vertex_stride(vertex_format format) noexcept {
+	return format == vertex_format::packed ? sizeof(packed_vertex) : sizeof(vertex);
+}
+
+} // end namespace pg::gods_view
+
+#endif
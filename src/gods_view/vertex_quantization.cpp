@@ -0,0 +1,241 @@
+#include "gods_view/vertex_quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace pg::gods_view {
+
+namespace details {
+
+constexpr float tangent_degenerate_epsilon = 1e-12f;
+
+static float snorm16_to_float(int16_t value) noexcept {
+	return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+}
+
+static int16_t float_to_snorm16(float value) noexcept {
+	return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static uint16_t float_to_unorm16(float value) noexcept {
+	return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+static float dot(const float a[3], const float b[3]) noexcept {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void cross(const float a[3], const float b[3], float result[3]) noexcept {
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static bool normalize(float v[3]) noexcept {
+	const float length_squared = dot(v, v);
+	if (length_squared <= tangent_degenerate_epsilon) { return false; }
+	const float inverse = 1.0f / std::sqrt(length_squared);
+	v[0] *= inverse;
+	v[1] *= inverse;
+	v[2] *= inverse;
+	return true;
+}
+
+uint16_t float_to_half(float value) noexcept {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+	const uint32_t magnitude = bits & 0x7fffffffu;
+	if (magnitude >= 0x7f800000u) {
+		// infinity stays infinity, nan stays a quiet nan.
+		return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+	}
+	if (magnitude >= 0x47800000u) {
+		return static_cast<uint16_t>(sign | 0x7c00u);
+	}
+	if (magnitude < 0x38800000u) {
+		// below the smallest normal half, the implicit bit shifts into a subnormal mantissa.
+		if (magnitude < 0x33000000u) { return sign; }
+		const uint32_t exponent = magnitude >> 23;
+		const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+		const uint32_t shift = 126 - exponent;
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+			++half;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+	// rebias the exponent from 127 to 15; a mantissa carry rounds up into the exponent, or to infinity.
+	uint32_t half = (magnitude - 0x38000000u) >> 13;
+	const uint32_t remainder = magnitude & 0x1fffu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+		++half;
+	}
+	return static_cast<uint16_t>(sign | half);
+}
+
+float half_to_float(uint16_t value) noexcept {
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1fu;
+	uint32_t mantissa = value & 0x3ffu;
+	uint32_t bits;
+	if (exponent == 0x1fu) {
+		bits = sign | 0x7f800000u | (mantissa << 13);
+	} else if (exponent != 0) {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	} else if (mantissa == 0) {
+		bits = sign;
+	} else {
+		// subnormal, normalize it for the wider exponent.
+		uint32_t shifted_exponent = 113;
+		while ((mantissa & 0x400u) == 0) {
+			mantissa <<= 1;
+			--shifted_exponent;
+		}
+		bits = sign | (shifted_exponent << 23) | ((mantissa & 0x3ffu) << 13);
+	}
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void octahedral_encode(const float direction[3], int16_t encoded[2]) noexcept {
+	const float l1 = std::abs(direction[0]) + std::abs(direction[1]) + std::abs(direction[2]);
+	if (l1 <= 0.0f) {
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x = direction[0] / l1;
+	float y = direction[1] / l1;
+	if (direction[2] < 0.0f) {
+		// the lower half folds out over the corners.
+		const float folded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float folded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = folded_x;
+		y = folded_y;
+	}
+	encoded[0] = float_to_snorm16(x);
+	encoded[1] = float_to_snorm16(y);
+}
+
+void octahedral_decode(const int16_t encoded[2], float direction[3]) noexcept {
+	float x = snorm16_to_float(encoded[0]);
+	float y = snorm16_to_float(encoded[1]);
+	const float z = 1.0f - std::abs(x) - std::abs(y);
+	if (z < 0.0f) {
+		const float unfolded_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float unfolded_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = unfolded_x;
+		y = unfolded_y;
+	}
+	direction[0] = x;
+	direction[1] = y;
+	direction[2] = z;
+	if (!normalize(direction)) {
+		direction[0] = 0.0f;
+		direction[1] = 0.0f;
+		direction[2] = 1.0f;
+	}
+}
+
+} // end namespace pg::gods_view::details
+
+std::vector<std::array<float, 4>> compute_tangents(const std::vector<gods_view::vertex>& vertices, const std::vector<uint32_t>& indices) {
+	std::vector<std::array<float, 3>> tangents(vertices.size(), {0.0f, 0.0f, 0.0f});
+	std::vector<std::array<float, 3>> bitangents(vertices.size(), {0.0f, 0.0f, 0.0f});
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		const auto& v0 = vertices[indices[t]];
+		const auto& v1 = vertices[indices[t + 1]];
+		const auto& v2 = vertices[indices[t + 2]];
+		float edge1[3];
+		float edge2[3];
+		for (size_t axis = 0; axis < 3; ++axis) {
+			edge1[axis] = v1.position[axis] - v0.position[axis];
+			edge2[axis] = v2.position[axis] - v0.position[axis];
+		}
+		const float du1 = v1.uv[0] - v0.uv[0];
+		const float dv1 = v1.uv[1] - v0.uv[1];
+		const float du2 = v2.uv[0] - v0.uv[0];
+		const float dv2 = v2.uv[1] - v0.uv[1];
+		const float determinant = du1 * dv2 - du2 * dv1;
+		if (std::abs(determinant) <= details::tangent_degenerate_epsilon) { continue; }
+		// unnormalized, so larger triangles weigh more in the vertex's average.
+		const float r = 1.0f / determinant;
+		for (size_t k = 0; k < 3; ++k) {
+			auto& tangent = tangents[indices[t + k]];
+			auto& bitangent = bitangents[indices[t + k]];
+			for (size_t axis = 0; axis < 3; ++axis) {
+				tangent[axis] += (edge1[axis] * dv2 - edge2[axis] * dv1) * r;
+				bitangent[axis] += (edge2[axis] * du1 - edge1[axis] * du2) * r;
+			}
+		}
+	}
+
+	std::vector<std::array<float, 4>> result(vertices.size());
+	for (size_t v = 0; v < vertices.size(); ++v) {
+		float normal[3] = {vertices[v].normal[0], vertices[v].normal[1], vertices[v].normal[2]};
+		if (!details::normalize(normal)) {
+			normal[0] = 0.0f;
+			normal[1] = 0.0f;
+			normal[2] = 1.0f;
+		}
+		// gram-schmidt against the normal.
+		float tangent[3] = {tangents[v][0], tangents[v][1], tangents[v][2]};
+		const float along_normal = details::dot(normal, tangent);
+		for (size_t axis = 0; axis < 3; ++axis) {
+			tangent[axis] -= normal[axis] * along_normal;
+		}
+		if (!details::normalize(tangent)) {
+			// any vector orthogonal to the normal, crossed with whichever of x or y is further from it.
+			const float helper[3] = {
+				std::abs(normal[0]) < 0.9f ? 1.0f : 0.0f,
+				std::abs(normal[0]) < 0.9f ? 0.0f : 1.0f,
+				0.0f
+			};
+			details::cross(normal, helper, tangent);
+			details::normalize(tangent);
+		}
+		float bitangent[3];
+		details::cross(normal, tangent, bitangent);
+		const float handedness = details::dot(bitangent, bitangents[v].data()) < 0.0f ? -1.0f : 1.0f;
+		result[v] = {tangent[0], tangent[1], tangent[2], handedness};
+	}
+	return result;
+}
+
+std::vector<gods_view::packed_vertex> quantize_vertices(
+	const std::vector<gods_view::vertex>& vertices,
+	const std::vector<uint32_t>& indices,
+	const float bounds_min[3],
+	const float bounds_max[3]
+)
+{
+	float inverse_extent[3];
+	for (size_t axis = 0; axis < 3; ++axis) {
+		const float extent = bounds_max[axis] - bounds_min[axis];
+		// a flat axis quantizes to 0 and decodes back to the bound.
+		inverse_extent[axis] = extent > 0.0f ? 1.0f / extent : 0.0f;
+	}
+	const auto tangents = compute_tangents(vertices, indices);
+	std::vector<gods_view::packed_vertex> packed(vertices.size());
+	for (size_t v = 0; v < vertices.size(); ++v) {
+		const auto& source = vertices[v];
+		auto& target = packed[v];
+		for (size_t axis = 0; axis < 3; ++axis) {
+			target.position[axis] = details::float_to_unorm16((source.position[axis] - bounds_min[axis]) * inverse_extent[axis]);
+		}
+		target.position[3] = tangents[v][3] < 0.0f ? 0 : std::numeric_limits<uint16_t>::max();
+		details::octahedral_encode(source.normal, target.normal);
+		target.uv[0] = details::float_to_half(source.uv[0]);
+		target.uv[1] = details::float_to_half(source.uv[1]);
+		details::octahedral_encode(tangents[v].data(), target.tangent);
+	}
+	return packed;
+}
+
+} // end namespace pg::gods_view
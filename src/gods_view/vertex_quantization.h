@@ -0,0 +1,44 @@
+#if !defined PG_GODS_VIEW_VERTEX_QUANTIZATION_HEADER_INCLUDED
+#define PG_GODS_VIEW_VERTEX_QUANTIZATION_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/vertex.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace pg::gods_view {
+
+namespace details {
+
+// round to nearest even, out of range values become infinity.
+uint16_t float_to_half(float value) noexcept;
+
+float half_to_float(uint16_t value) noexcept;
+
+// maps a unit vector onto the octahedron unfolded into [-1, 1]^2, as snorm.
+void octahedral_encode(const float direction[3], int16_t encoded[2]) noexcept;
+
+void octahedral_decode(const int16_t encoded[2], float direction[3]) noexcept;
+
+} // end namespace pg::gods_view::details
+
+// per vertex tangents from the uv gradients of the triangles around it, orthogonal to the
+// normal. w is the sign that turns cross(normal, tangent) into the bitangent. vertices no
+// triangle gives a usable gradient get any tangent orthogonal to their normal.
+std::vector<std::array<float, 4>> compute_tangents(const std::vector<gods_view::vertex>& vertices, const std::vector<uint32_t>& indices);
+
+// quantizes a triangle list's vertices, positions relative to `bounds_min`/`bounds_max`,
+// which have to enclose them. used by `write_mesh_file` for packed mesh files and at runtime
+// for meshes built on the fly.
+std::vector<gods_view::packed_vertex> quantize_vertices(
+	const std::vector<gods_view::vertex>& vertices,
+	const std::vector<uint32_t>& indices,
+	const float bounds_min[3],
+	const float bounds_max[3]
+);
+
+} // end namespace pg::gods_view
+
+#endif
@@ -7,13 +7,34 @@ vulkan_engine::vulkan_engine(
 	const std::string& init_app_name
 ) :
 	validation_layer_manager_{},
-	vulkan_instance_{init_app_name, init_engine_name, validation_layer_manager_},
-	debug_messenger_{vulkan_instance_.vk_instance()},
+	validation_message_sink_{},
+	vulkan_instance_{init_app_name, init_engine_name, validation_layer_manager_, &validation_message_sink_},
+	debug_messenger_{vulkan_instance_.vk_instance(), &validation_message_sink_},
+	profiler_{},
+	frame_counters_{},
 	device_manager_{this},
+	trace_recorder_{this},
+	job_system_{},
 	surface_manager_{this},
+	layout_cache_{this},
+	descriptor_allocator_{this},
+	resource_pool_{this},
 	graphics_pipeline_manager_{this},
+	compute_pipeline_manager_{this},
 	draw_manager_{this},
-	command_manager_{this}
+	command_manager_{this},
+	compute_manager_{this},
+	texture_manager_{this},
+	mesh_manager_{this},
+	transform_manager_{this},
+	spatial_index_{this},
+	capture_manager_{this},
+	overlay_renderer_{this},
+	post_processor_{this},
+	point_cloud_renderer_{this},
+	resolution_scaler_{this},
+	render_loop_{this},
+	render_thread_{this}
 { }
 
 } // end namespace pg::gods_view
\ No newline at end of file
@@ -3,34 +3,84 @@
 #pragma once
 
 #include "gods_view/validation_layers.h"
+#include "gods_view/validation_message_sink.h"
 #include "gods_view/device_manager.h"
+#include "gods_view/frame_counters.h"
+#include "gods_view/profiler.h"
+#include "gods_view/job_system.h"
+#include "gods_view/resource_pool.h"
 #include "gods_view/surface_manager.h"
 #include "gods_view/vulkan_instance.h"
+#include "gods_view/layout_cache.h"
+#include "gods_view/descriptor_allocator.h"
 #include "gods_view/graphics_pipeline_manager.h"
+#include "gods_view/compute_pipeline_manager.h"
 #include "gods_view/draw_manager.h"
 #include "gods_view/command_manager.h"
+#include "gods_view/compute_manager.h"
+#include "gods_view/texture_manager.h"
+#include "gods_view/mesh_manager.h"
+#include "gods_view/transform_manager.h"
+#include "gods_view/spatial_index.h"
+#include "gods_view/capture_manager.h"
+#include "gods_view/overlay_renderer.h"
+#include "gods_view/post_processor.h"
+#include "gods_view/point_cloud_renderer.h"
+#include "gods_view/resolution_scaler.h"
+#include "gods_view/trace_recorder.h"
+#include "gods_view/render_loop.h"
+#include "gods_view/render_thread.h"
 #include "gods_view/window.h"
 
 #define GLFW_INCLUDE_VULKAN
 #include "GLFW/glfw3.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <string>
 #include <system_error>
+#include <thread>
 
 namespace pg::gods_view {
 
 class vulkan_engine {
 private:
 	gods_view::validation_layer_manager validation_layer_manager_;
+	gods_view::validation_message_sink validation_message_sink_;
 	gods_view::vulkan_instance vulkan_instance_;
 	gods_view::debug_messenger debug_messenger_;
+	// ahead of everything that records scopes, job workers included.
+	gods_view::profiler profiler_;
+	gods_view::frame_counters frame_counters_;
 	gods_view::device_manager device_manager_;
+	// ahead of the job system so decodes still running on its workers can report to it.
+	gods_view::trace_recorder trace_recorder_;
+	gods_view::job_system job_system_;
 	gods_view::surface_manager surface_manager_;
+	gods_view::layout_cache layout_cache_;
+	gods_view::descriptor_allocator descriptor_allocator_;
+	// ahead of every manager holding handles into it, after the descriptor allocator since
+	// freeing what is left drops the cached sets pointing at it.
+	gods_view::resource_pool resource_pool_;
 	gods_view::graphics_pipeline_manager graphics_pipeline_manager_;
+	gods_view::compute_pipeline_manager compute_pipeline_manager_;
 	gods_view::draw_manager draw_manager_;
 	gods_view::command_manager command_manager_;
+	gods_view::compute_manager compute_manager_;
+	gods_view::texture_manager texture_manager_;
+	gods_view::mesh_manager mesh_manager_;
+	gods_view::transform_manager transform_manager_;
+	gods_view::spatial_index spatial_index_;
+	gods_view::capture_manager capture_manager_;
+	gods_view::overlay_renderer overlay_renderer_;
+	gods_view::post_processor post_processor_;
+	gods_view::point_cloud_renderer point_cloud_renderer_;
+	gods_view::resolution_scaler resolution_scaler_;
+	gods_view::render_loop render_loop_;
+	// last, so it is joined before anything it draws with goes away.
+	gods_view::render_thread render_thread_;
 	GLFWwindow* current_window_;
 
 public:
@@ -47,16 +97,58 @@ public:
 
 	[[nodiscard]] gods_view::validation_layer_manager* validation_layer_manager() noexcept { return &validation_layer_manager_; }
 
+	[[nodiscard]] gods_view::validation_message_sink* validation_message_sink() noexcept { return &validation_message_sink_; }
+
 	[[nodiscard]] gods_view::surface_manager* surface_manager() noexcept { return &surface_manager_; } 
 
 	[[nodiscard]] gods_view::device_manager* device_manager() noexcept { return &device_manager_; }
 
+	[[nodiscard]] gods_view::profiler* profiler() noexcept { return &profiler_; }
+
+	[[nodiscard]] gods_view::frame_counters* frame_counters() noexcept { return &frame_counters_; }
+
+	[[nodiscard]] gods_view::trace_recorder* trace_recorder() noexcept { return &trace_recorder_; }
+
+	[[nodiscard]] gods_view::job_system* job_system() noexcept { return &job_system_; }
+
+	[[nodiscard]] gods_view::resource_pool* resource_pool() noexcept { return &resource_pool_; }
+
+	[[nodiscard]] gods_view::layout_cache* layout_cache() noexcept { return &layout_cache_; }
+
+	[[nodiscard]] gods_view::descriptor_allocator* descriptor_allocator() noexcept { return &descriptor_allocator_; }
+
 	[[nodiscard]] gods_view::graphics_pipeline_manager* graphics_pipeline_manager() noexcept { return &graphics_pipeline_manager_; }
 
+	[[nodiscard]] gods_view::compute_pipeline_manager* compute_pipeline_manager() noexcept { return &compute_pipeline_manager_; }
+
 	[[nodiscard]] gods_view::draw_manager* draw_manager() noexcept { return &draw_manager_; }
 
 	[[nodiscard]] gods_view::command_manager* command_manager() noexcept { return &command_manager_; }
 
+	[[nodiscard]] gods_view::compute_manager* compute_manager() noexcept { return &compute_manager_; }
+
+	[[nodiscard]] gods_view::texture_manager* texture_manager() noexcept { return &texture_manager_; }
+
+	[[nodiscard]] gods_view::mesh_manager* mesh_manager() noexcept { return &mesh_manager_; }
+
+	[[nodiscard]] gods_view::transform_manager* transform_manager() noexcept { return &transform_manager_; }
+
+	[[nodiscard]] gods_view::spatial_index* spatial_index() noexcept { return &spatial_index_; }
+
+	[[nodiscard]] gods_view::capture_manager* capture_manager() noexcept { return &capture_manager_; }
+
+	[[nodiscard]] gods_view::overlay_renderer* overlay_renderer() noexcept { return &overlay_renderer_; }
+
+	[[nodiscard]] gods_view::post_processor* post_processor() noexcept { return &post_processor_; }
+
+	[[nodiscard]] gods_view::point_cloud_renderer* point_cloud_renderer() noexcept { return &point_cloud_renderer_; }
+
+	[[nodiscard]] gods_view::resolution_scaler* resolution_scaler() noexcept { return &resolution_scaler_; }
+
+	[[nodiscard]] gods_view::render_loop* render_loop() noexcept { return &render_loop_; }
+
+	[[nodiscard]] gods_view::render_thread* render_thread() noexcept { return &render_thread_; }
+
 	[[nodiscard]] GLFWwindow* current_window() const noexcept { return current_window_; }
 
 	void current_window(GLFWwindow* window) noexcept { current_window_ = window; }
@@ -78,6 +170,11 @@ public:
 		surface_manager_.create_image_views();
 	}
 
+	// opt in to tonemapping and grading, between `create_image_views` and `create_render_pass`.
+	void initialize_post_processor(const post_settings& settings = {}) {
+		post_processor_.initialize(settings);
+	}
+
 	void create_graphics_pipeline() {
 		graphics_pipeline_manager_.create_graphics_pipeline();
 	}
@@ -98,9 +195,74 @@ public:
 		command_manager_.create_command_buffer();
 	}
 
+	void create_compute_queue() {
+		compute_manager_.initialize();
+	}
+
 	void create_synchronization_objects() {
 		draw_manager_.create_sync_objects();
 	}
+
+	// adds a window that shares this device, render pass and pipelines; call once the
+	// primary window's swap chain, framebuffers and sync objects exist.
+	size_t add_window(GLFWwindow* window) {
+		const auto surface_index = surface_manager_.create_vulkan_surface(window);
+		surface_manager_.create_swap_chain();
+		surface_manager_.create_image_views();
+		draw_manager_.create_framebuffers();
+		draw_manager_.create_sync_objects();
+		resolution_scaler_.create_targets();
+		return surface_index;
+	}
+
+	// call from the thread that starts the render thread, before `start_render_thread`; it becomes
+	// worker 0. the render thread hands its jobs in through the shared queue and still runs
+	// jobs whenever it waits on them.
+	void initialize_job_system(uint32_t background_workers = std::max(std::thread::hardware_concurrency(), 2u) - 1) {
+		job_system_.initialize(background_workers);
+	}
+
+	void initialize_descriptor_allocator(uint32_t frame_slots = details::default_descriptor_frame_slots) {
+		descriptor_allocator_.initialize(frame_slots);
+	}
+
+	void initialize_texture_manager(uint32_t max_decoders = 2) {
+		texture_manager_.initialize(max_decoders);
+	}
+
+	void initialize_mesh_manager() {
+		mesh_manager_.initialize();
+	}
+
+	void initialize_transform_manager(uint32_t capacity = 65536) {
+		transform_manager_.initialize(capacity);
+	}
+
+	void initialize_capture_manager(uint32_t ring_size = details::default_capture_ring_size) {
+		capture_manager_.initialize(ring_size);
+	}
+
+	void initialize_overlay_renderer(uint32_t max_quads = details::default_overlay_quads) {
+		overlay_renderer_.initialize(max_quads);
+	}
+
+	void initialize_point_cloud_renderer(const point_cloud_settings& settings = {}) {
+		point_cloud_renderer_.initialize(settings);
+	}
+
+	void initialize_resolution_scaler(const resolution_scale_settings& settings = {}) {
+		resolution_scaler_.initialize(settings);
+	}
+
+	// from here until `stop_render_thread` the calling thread only pumps events and builds
+	// frame packets, engine calls it makes go through `render_thread()->enqueue`.
+	void start_render_thread() {
+		render_thread_.start();
+	}
+
+	void stop_render_thread() {
+		render_thread_.stop();
+	}
 };
 
 } // end namespace pg::gods_view
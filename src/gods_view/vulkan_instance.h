@@ -17,6 +17,7 @@ class vulkan_instance {
 private:
 	VkInstance vk_instance_;
 	const validation_layer_manager& validation_layer_manager_;
+	gods_view::validation_message_sink* message_sink_;
 	std::string app_name_;
 	std::string engine_name_;
 
@@ -24,10 +25,12 @@ public:
 	vulkan_instance(
 		const std::string& init_app_name,
 		const std::string& init_engine_name,
-		const validation_layer_manager& init_validation_layer_manager
+		const validation_layer_manager& init_validation_layer_manager,
+		gods_view::validation_message_sink* init_message_sink = nullptr
 	) :
 		vk_instance_{nullptr},
 		validation_layer_manager_{init_validation_layer_manager},
+		message_sink_{init_message_sink},
 		app_name_{init_app_name},
 		engine_name_{init_engine_name}
 	{
@@ -70,7 +73,7 @@ private:
 		if (details::enable_validation_layers) {
 			creation_info.enabledLayerCount = validation_layer_manager_.validation_layer_size();
 			creation_info.ppEnabledLayerNames = validation_layer_manager_.validation_layer_names();
-			debug_messenger::populate_debug_messenger_info(debug_creation_info);
+			debug_messenger::populate_debug_messenger_info(debug_creation_info, message_sink_);
 			creation_info.pNext = reinterpret_cast<VkDebugUtilsMessengerCreateInfoEXT*>(&debug_creation_info);
 		} else {
 			creation_info.enabledLayerCount = 0;
@@ -14,33 +14,49 @@ class vulkan_window {
 private:
 	using window_handle_type = GLFWwindow*;
 
+	// glfw is shared by every window, it is terminated with the last one.
+	static inline uint32_t live_windows_{0};
+
 	window_handle_type window_;
 	std::string window_name_;
 	uint32_t width_;
 	uint32_t height_;
+	// a hidden window has a surface but is never presented to, the engine skips drawing it.
+	bool visible_;
 
 public:
 	vulkan_window(
 		const std::string& init_window_name,
 		uint32_t init_width,
-		uint32_t init_height
+		uint32_t init_height,
+		bool init_visible = true
 	) :
 		window_{nullptr},
 		window_name_{init_window_name},
 		width_{init_width},
-		height_{init_height}
+		height_{init_height},
+		visible_{init_visible}
 	{ }
 
 	~vulkan_window() {
+		if (window_ == nullptr) { return; }
 		glfwDestroyWindow(window_);
-		glfwTerminate();
+		if (--live_windows_ == 0) {
+			glfwTerminate();
+		}
 	}
 
+	vulkan_window(const vulkan_window&) = delete;
+
+	vulkan_window& operator=(const vulkan_window&) = delete;
+
 	void initiate_window() {
 		glfwInit();
 		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 		glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_VISIBLE, visible_ ? GLFW_TRUE : GLFW_FALSE);
 		window_ = glfwCreateWindow(width_, height_, window_name_.c_str(), nullptr, nullptr);
+		++live_windows_;
 	}
 
 	bool should_window_close() {
@@ -0,0 +1,88 @@
+#if !defined PG_GODS_VIEW_WORK_STEALING_DEQUE_HEADER_INCLUDED
+#define PG_GODS_VIEW_WORK_STEALING_DEQUE_HEADER_INCLUDED
+#pragma once
+
+#include "gods_view/lock_free_ring.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace pg::gods_view {
+
+// bounded Chase-Lev deque of pointers. the owning thread pushes and pops at the bottom,
+// any other thread steals from the top. a full deque rejects the push.
+template <typename T, std::size_t Capacity>
+class work_stealing_deque {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "work_stealing_deque capacity must be a power of two");
+
+private:
+	alignas(details::cache_line_size) std::atomic<int64_t> top_;
+	alignas(details::cache_line_size) std::atomic<int64_t> bottom_;
+	alignas(details::cache_line_size) std::array<std::atomic<T*>, Capacity> items_;
+
+public:
+	work_stealing_deque() :
+		top_{0},
+		bottom_{0}
+	{
+		for (auto& item : items_) {
+			item.store(nullptr, std::memory_order_relaxed);
+		}
+	}
+
+	work_stealing_deque(const work_stealing_deque&) = delete;
+
+	work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+	// owner side only.
+	bool push(T* item) noexcept {
+		const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+		const int64_t top = top_.load(std::memory_order_acquire);
+		if (bottom - top >= static_cast<int64_t>(Capacity)) {
+			return false;
+		}
+		items_[static_cast<std::size_t>(bottom) & (Capacity - 1)].store(item, std::memory_order_relaxed);
+		bottom_.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	// owner side only, newest first.
+	T* pop() noexcept {
+		const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+		bottom_.store(bottom, std::memory_order_seq_cst);
+		int64_t top = top_.load(std::memory_order_seq_cst);
+		if (top > bottom) {
+			bottom_.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T* item = items_[static_cast<std::size_t>(bottom) & (Capacity - 1)].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			// last item, race the thieves for it.
+			if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				item = nullptr;
+			}
+			bottom_.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	// any thread, oldest first.
+	T* steal() noexcept {
+		int64_t top = top_.load(std::memory_order_seq_cst);
+		const int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+		if (top >= bottom) {
+			return nullptr;
+		}
+		T* item = items_[static_cast<std::size_t>(top) & (Capacity - 1)].load(std::memory_order_acquire);
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return item;
+	}
+};
+
+} // end namespace pg::gods_view
+
+#endif